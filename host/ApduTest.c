@@ -0,0 +1,657 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host harness of the device APDU transport: feeds the (chained) frames into Apdu_OnRcv, the same way the io loop in main.c does.
+// The reassembled requests go to the host KeyKeeper.
+
+#include <stdio.h>
+#include "os.h"
+#include "sw.h"
+#include "Apdu.h"
+#include "HostApp.h"
+#include "TestVectors.h"
+
+#ifndef _countof
+#	define _countof(arr) sizeof(arr) / sizeof((arr)[0])
+#endif
+
+static uint32_t g_Failed = 0;
+
+#define verify_test(x) \
+    do { \
+        if (!(x)) \
+        { \
+            printf("Test failed! Line=%u, Expression: %s\n", __LINE__, #x); \
+            g_Failed++; \
+        } \
+    } while (0)
+
+#define c_Apdu_BufSize 260 // IO_APDU_BUFFER_SIZE: 5 header bytes + 255 data bytes
+
+static uint8_t g_pApdu[c_Apdu_BufSize];
+static KeyKeeper g_Kk;
+static uint32_t g_nRequests = 0; // reached KeyKeeper
+static uint32_t g_nParts = 0; // streamed parts that reached KeyKeeper
+static uint32_t g_nDrops = 0; // pending chains dropped
+
+static void OnBeamHostError(uint16_t errCode, uint8_t* pOut, uint32_t* pSizeOut)
+{
+    pOut[0] = (uint8_t) errCode;
+    pOut[1] = (uint8_t) (errCode >> 8);
+    *pSizeOut = 2;
+}
+
+void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSizeOut)
+{
+    g_nRequests++;
+
+    uint16_t errCode = KeyKeeper_Invoke(&g_Kk, pIn, nIn, pOut, pSizeOut);
+    if (c_KeyKeeper_Status_Ok == errCode)
+        pOut[0] = c_KeyKeeper_Status_Ok;
+    else
+        OnBeamHostError(errCode, pOut, pSizeOut);
+}
+
+int OnBeamHostRequestPart(uint8_t* pIn, uint32_t* pnIn, uint8_t* pOut, uint32_t* pSizeOut)
+{
+    if (!KeyKeeper_IsStreamed(pIn, *pnIn))
+        return 0;
+
+    g_nParts++;
+
+    uint16_t errCode = KeyKeeper_InvokePart(&g_Kk, pIn, pnIn);
+    if (c_KeyKeeper_Status_Ok == errCode)
+        return 0;
+
+    OnBeamHostError(errCode, pOut, pSizeOut);
+    return 1;
+}
+
+void OnBeamHostRequestDrop(const uint8_t* pIn, uint32_t nIn)
+{
+    g_nDrops++;
+    KeyKeeper_AbortPart(&g_Kk, pIn, nIn);
+}
+
+// Returns the status word, the response is left in g_pApdu
+static uint16_t Apdu_Send(uint8_t p1, uint8_t p2, const uint8_t* pData, uint8_t nData, int* pLen)
+{
+    g_pApdu[0] = 0xE0;
+    g_pApdu[1] = 'B';
+    g_pApdu[2] = p1;
+    g_pApdu[3] = p2;
+    g_pApdu[4] = nData;
+    memcpy(g_pApdu + 5, pData, nData);
+
+    *pLen = 5 + nData;
+    return Apdu_OnRcv(g_pApdu, sizeof(g_pApdu), pLen);
+}
+
+// Sends the request as a chain of frames of up to nFrame bytes (standalone if it fits a single one)
+static uint16_t Apdu_SendChained(const uint8_t* pReq, uint32_t nReq, uint32_t nFrame, int* pLen)
+{
+    for (uint32_t nDone = 0; ; )
+    {
+        uint32_t n = nReq - nDone;
+        uint8_t p1 = nDone ? c_Apdu_P1_Cont : 0;
+
+        if (n > nFrame)
+        {
+            n = nFrame;
+            p1 |= c_Apdu_P1_More;
+        }
+
+        uint16_t sw = Apdu_Send(p1, 0, pReq + nDone, (uint8_t) n, pLen);
+        nDone += n;
+
+        if ((SW_OK != sw) || (nDone == nReq))
+            return sw;
+
+        verify_test(!*pLen); // intermediate frames are answered with no data
+    }
+}
+
+static void TestStandalone()
+{
+    // unchained requests are handled as before
+    uint8_t pReq[] = { g_Proto_Code_Version };
+
+    uint8_t pRef[c_Apdu_BufSize];
+    uint32_t nRef = sizeof(pRef) - sizeof(uint16_t);
+    verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&g_Kk, pReq, sizeof(pReq), pRef, &nRef));
+
+    int nLen;
+    verify_test(SW_OK == Apdu_Send(0, 0, pReq, sizeof(pReq), &nLen));
+    verify_test(nLen == (int) nRef);
+    verify_test(!memcmp(g_pApdu, pRef, nRef));
+
+    verify_test(SW_WRONG_P1P2 == Apdu_Send(0, 1, pReq, sizeof(pReq), &nLen));
+}
+
+static void TestChained()
+{
+    // AuxWrite of the whole aux buffer in a single logical request, it doesn't fit an APDU
+    static uint8_t pReq[sizeof(Proto_In_AuxWrite) + sizeof(KeyKeeper_AuxBuf)];
+    _Static_assert(sizeof(pReq) > c_Apdu_BufSize, "");
+    _Static_assert(sizeof(pReq) <= c_Apdu_ChainMax, "");
+
+    Proto_In_AuxWrite* pIn = (Proto_In_AuxWrite*) pReq;
+    pIn->m_OpCode = g_Proto_Code_AuxWrite;
+    pIn->m_Offset = 0;
+    pIn->m_Size = sizeof(KeyKeeper_AuxBuf);
+
+    const uint32_t pFrame[] = { 255, 100, 1 };
+
+    for (uint32_t iCase = 0; iCase < _countof(pFrame); iCase++)
+    {
+        uint8_t* pBlob = (uint8_t*) (pIn + 1);
+        for (uint32_t i = 0; i < sizeof(KeyKeeper_AuxBuf); i++)
+            pBlob[i] = (uint8_t) (i * 7 + iCase);
+
+        uint32_t nRequests = g_nRequests;
+        uint32_t nParts = g_nParts;
+
+        int nLen;
+        verify_test(SW_OK == Apdu_SendChained(pReq, sizeof(pReq), pFrame[iCase], &nLen));
+        verify_test((1 == nLen) && (c_KeyKeeper_Status_Ok == g_pApdu[0]));
+        verify_test(g_nRequests == nRequests + 1); // a single logical request
+        verify_test(g_nParts == nParts); // not streamed, only accumulated
+
+        verify_test(!memcmp(KeyKeeper_GetAuxBuf(&g_Kk), pBlob, sizeof(KeyKeeper_AuxBuf)));
+    }
+}
+
+static void TestChainErrors()
+{
+    uint8_t pReq[255];
+    memset(pReq, 0, sizeof(pReq));
+    pReq[0] = g_Proto_Code_Version;
+
+    int nLen;
+    uint32_t nRequests = g_nRequests;
+
+    // continuation without the start
+    verify_test(SW_BAD_STATE == Apdu_Send(c_Apdu_P1_Cont, 0, pReq, 1, &nLen));
+
+    // unknown flags
+    verify_test(SW_WRONG_P1P2 == Apdu_Send(0x80, 0, pReq, 1, &nLen));
+
+    // overflow drops the chain
+    uint16_t sw = SW_OK;
+    for (uint32_t nDone = 0; (SW_OK == sw) && (nDone <= c_Apdu_ChainMax); nDone += sizeof(pReq))
+        sw = Apdu_Send(c_Apdu_P1_More | (nDone ? c_Apdu_P1_Cont : 0), 0, pReq, sizeof(pReq), &nLen);
+
+    verify_test(SW_WRONG_DATA_LENGTH == sw);
+    verify_test(SW_BAD_STATE == Apdu_Send(c_Apdu_P1_Cont, 0, pReq, 1, &nLen));
+
+    // the standalone request drops the chain
+    verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More, 0, pReq, 1, &nLen));
+    verify_test(SW_OK == Apdu_Send(0, 0, pReq, 1, &nLen));
+    verify_test(SW_BAD_STATE == Apdu_Send(c_Apdu_P1_Cont, 0, pReq, 1, &nLen));
+
+    // the new chain replaces the pending one
+    verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More, 0, pReq + 1, 5, &nLen));
+    verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More, 0, pReq, 1, &nLen));
+    verify_test(SW_OK == Apdu_Send(c_Apdu_P1_Cont, 0, pReq, 0, &nLen));
+    verify_test((nLen > 1) && (c_KeyKeeper_Status_Ok == g_pApdu[0])); // Version
+
+    verify_test(g_nRequests == nRequests + 2);
+}
+
+#pragma pack (push, 1)
+typedef struct
+{
+    ShieldedInput_Blob m_Blob;
+    ShieldedInput_Fmt m_Fmt;
+} ShieldedInput_Rec;
+#pragma pack (pop)
+
+// TxAddCoinsEx (or TxAddCoins) with nIns + nOuts coins and nInsShielded shielded ins of the same asset aid. Returns the size
+static uint32_t MakeTxAddCoins(uint8_t* pBuf, int bEx, uint32_t nIns, uint32_t nOuts, uint32_t nInsShielded, AssetID aid)
+{
+    uint32_t nHdr;
+    if (bEx)
+    {
+        Proto_In_TxAddCoinsEx* pIn = (Proto_In_TxAddCoinsEx*) pBuf;
+        pIn->m_OpCode = g_Proto_Code_TxAddCoinsEx;
+        pIn->m_Reset = 1;
+        pIn->m_Ins = nIns;
+        pIn->m_Outs = nOuts;
+        pIn->m_InsShielded = nInsShielded;
+        nHdr = sizeof(*pIn);
+    }
+    else
+    {
+        Proto_In_TxAddCoins* pIn = (Proto_In_TxAddCoins*) pBuf;
+        pIn->m_OpCode = g_Proto_Code_TxAddCoins;
+        pIn->m_Reset = 1;
+        pIn->m_Ins = (uint8_t) nIns;
+        pIn->m_Outs = (uint8_t) nOuts;
+        pIn->m_InsShielded = (uint8_t) nInsShielded;
+        nHdr = sizeof(*pIn);
+    }
+
+    CoinID* pCid = (CoinID*) (pBuf + nHdr);
+    for (uint32_t i = 0; i < nIns + nOuts; i++, pCid++)
+    {
+        memset(pCid, 0, sizeof(*pCid));
+        pCid->m_Idx = 100 + i;
+        pCid->m_SubIdx = i % 3; // a few child kdfs
+        pCid->m_Amount = 1000 + i * 17;
+        pCid->m_AssetID = (i & 1) ? aid : 0;
+    }
+
+    ShieldedInput_Rec* pRec = (ShieldedInput_Rec*) pCid;
+    for (uint32_t i = 0; i < nInsShielded; i++, pRec++)
+    {
+        memset(pRec, 0, sizeof(*pRec));
+        memset(pRec->m_Blob.m_kSerG.m_pVal, 0x21 + i, sizeof(pRec->m_Blob.m_kSerG.m_pVal));
+        pRec->m_Fmt.m_Amount = 5000 + i;
+        pRec->m_Fmt.m_AssetID = aid;
+        pRec->m_Fmt.m_nViewerIdx = i;
+    }
+
+    return (uint32_t) (((uint8_t*) pRec) - pBuf);
+}
+
+static void TestStreamed()
+{
+    // TxAddCoins larger than the chain buffer: the coins are folded as they arrive. The balance must be as of the whole request
+    static uint8_t pReq[8192];
+
+    for (uint32_t iCase = 0; iCase < 4; iCase++)
+    {
+        int bEx = !(iCase & 2);
+        uint32_t nReq = bEx ?
+            MakeTxAddCoins(pReq, 1, 70, 60, 4, 5) :
+            MakeTxAddCoins(pReq, 0, 40, 30, 3, 5);
+
+        verify_test(nReq > c_Apdu_ChainMax);
+
+        KeyKeeper kkRef;
+        memcpy(&kkRef, &g_Kk, sizeof(kkRef));
+
+        uint8_t pOut[16];
+        uint32_t nOut = sizeof(pOut);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kkRef, pReq, nReq, pOut, &nOut));
+
+        // KeyKeeper_InvokePart modifies the request in-place, the transport works on its copy
+        int nLen;
+        verify_test(SW_OK == Apdu_SendChained(pReq, nReq, (iCase & 1) ? 37 : 255, &nLen));
+        verify_test((1 == nLen) && (c_KeyKeeper_Status_Ok == g_pApdu[0]));
+
+        verify_test(c_KeyKeeper_State_TxBalance == g_Kk.m_State);
+        verify_test(!memcmp(&kkRef.u.m_TxBalance, &g_Kk.u.m_TxBalance, sizeof(kkRef.u.m_TxBalance)));
+    }
+
+    {
+        // failure in the middle (2nd asset): reported at once, the chain is dropped
+        uint32_t nReq = MakeTxAddCoins(pReq, 1, 70, 60, 0, 5);
+        CoinID* pCid = (CoinID*) (pReq + sizeof(Proto_In_TxAddCoinsEx));
+        pCid[21].m_AssetID = 6;
+
+        // send frames until the error response arrives
+        int nLen = 0;
+        uint32_t nDone = 0;
+        while (!nLen && (nDone + 200 < nReq))
+        {
+            verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More | (nDone ? c_Apdu_P1_Cont : 0), 0, pReq + nDone, 200, &nLen));
+            nDone += 200;
+        }
+
+        verify_test((2 == nLen) && (c_KeyKeeper_Status_Ok != g_pApdu[0]));
+        verify_test(SW_BAD_STATE == Apdu_Send(c_Apdu_P1_Cont, 0, pReq + nDone, 1, &nLen));
+        verify_test(c_KeyKeeper_State_TxBalance != g_Kk.m_State); // the coins folded before the failure are discarded
+    }
+}
+
+static void TestStreamedAbort()
+{
+    // the streamed chain abandoned mid-way must not leave its coins in the tx balance
+    static uint8_t pReq[4096];
+    uint8_t pVer[] = { g_Proto_Code_Version };
+
+    for (uint32_t iCase = 0; iCase < 3; iCase++)
+    {
+        uint32_t nReq = MakeTxAddCoins(pReq, 1, 40, 30, 0, 5);
+        uint32_t nDrops = g_nDrops;
+
+        // a few frames, the coins are folded as they arrive
+        int nLen;
+        uint32_t nParts = g_nParts;
+        for (uint32_t nDone = 0; nDone < 600; nDone += 200)
+            verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More | (nDone ? c_Apdu_P1_Cont : 0), 0, pReq + nDone, 200, &nLen));
+
+        verify_test(g_nParts == nParts + 3);
+        verify_test(c_KeyKeeper_State_TxBalance == g_Kk.m_State);
+
+        switch (iCase)
+        {
+        case 0: // standalone request
+            verify_test(SW_OK == Apdu_Send(0, 0, pVer, sizeof(pVer), &nLen));
+            break;
+
+        case 1: // rejected frame
+            verify_test(SW_WRONG_P1P2 == Apdu_Send(c_Apdu_P1_Cont, 1, pReq + 600, 1, &nLen));
+            break;
+
+        default: // new chain
+            verify_test(SW_OK == Apdu_Send(c_Apdu_P1_More, 0, pVer, sizeof(pVer), &nLen));
+            verify_test(SW_OK == Apdu_Send(c_Apdu_P1_Cont, 0, pVer, 0, &nLen));
+        }
+
+        verify_test(g_nDrops == nDrops + 1);
+        verify_test(c_KeyKeeper_State_TxBalance != g_Kk.m_State);
+
+        // the same tx resent without the reset flag: the balance is only of its coins
+        ((Proto_In_TxAddCoinsEx*) pReq)->m_Reset = 0;
+
+        KeyKeeper kkRef;
+        memcpy(&kkRef, &g_Kk, sizeof(kkRef));
+
+        uint8_t pOut[16];
+        uint32_t nOut = sizeof(pOut);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kkRef, pReq, nReq, pOut, &nOut));
+
+        verify_test(SW_OK == Apdu_SendChained(pReq, nReq, 255, &nLen));
+        verify_test((1 == nLen) && (c_KeyKeeper_Status_Ok == g_pApdu[0]));
+        verify_test(!memcmp(&kkRef.u.m_TxBalance, &g_Kk.u.m_TxBalance, sizeof(kkRef.u.m_TxBalance)));
+    }
+
+    // the completed chain is not dropped
+    uint32_t nDrops = g_nDrops;
+    int nLen;
+    verify_test(SW_OK == Apdu_SendChained(pReq, MakeTxAddCoins(pReq, 1, 40, 30, 0, 5), 255, &nLen));
+    verify_test(g_nDrops == nDrops);
+    verify_test(c_KeyKeeper_State_TxBalance == g_Kk.m_State);
+}
+
+// Appends a size-prefixed sub-request to the BatchInvoke request
+static uint32_t AddToBatch(uint8_t* pReq, uint32_t nReq, const void* pSub, uint16_t nSub)
+{
+    memcpy(pReq + nReq, &nSub, sizeof(nSub));
+    memcpy(pReq + nReq + sizeof(nSub), pSub, nSub);
+
+    pReq[1]++; // m_Count
+    return nReq + sizeof(nSub) + nSub;
+}
+
+static void TestBatch()
+{
+    // several requests in a single APDU. Its buffer is shared by the request and the response
+    uint8_t pReq[c_Apdu_BufSize];
+    pReq[0] = g_Proto_Code_BatchInvoke;
+    pReq[1] = 0;
+    uint32_t nReq = sizeof(Proto_In_BatchInvoke);
+
+    Proto_In_GetImage reqImg;
+    memset(&reqImg, 0, sizeof(reqImg));
+    reqImg.m_OpCode = g_Proto_Code_GetImage;
+    memset(reqImg.m_hvSrc.m_pVal, 0x3e, sizeof(reqImg.m_hvSrc.m_pVal));
+    reqImg.m_bG = 1;
+
+    Proto_In_Version reqVer;
+    reqVer.m_OpCode = g_Proto_Code_Version;
+
+    uint8_t pRef[c_Apdu_BufSize];
+    uint32_t nRef = 0;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        uint16_t nSub;
+        const void* pSub;
+        if (3 == i)
+        {
+            pSub = &reqVer;
+            nSub = sizeof(reqVer);
+        }
+        else
+        {
+            reqImg.m_iChild = i;
+            pSub = &reqImg;
+            nSub = sizeof(reqImg);
+        }
+
+        nReq = AddToBatch(pReq, nReq, pSub, nSub);
+
+        // expected response
+        uint32_t nOut = sizeof(pRef) - nRef - sizeof(nSub);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&g_Kk, pSub, nSub, pRef + nRef + sizeof(nSub), &nOut));
+        pRef[nRef + sizeof(nSub)] = c_KeyKeeper_Status_Ok;
+
+        nSub = (uint16_t) nOut;
+        memcpy(pRef + nRef, &nSub, sizeof(nSub));
+        nRef += sizeof(nSub) + nSub;
+    }
+
+    verify_test(nReq <= 0xff);
+
+    g_nRequests = 0;
+
+    int nLen;
+    verify_test(SW_OK == Apdu_Send(0, 0, pReq, (uint8_t) nReq, &nLen));
+    verify_test(1 == g_nRequests); // single round-trip
+    verify_test(nLen == (int) (sizeof(Proto_Out_BatchInvoke) + nRef));
+    verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && (4 == g_pApdu[1]));
+    verify_test(!memcmp(g_pApdu + sizeof(Proto_Out_BatchInvoke), pRef, nRef));
+
+    {
+        // the sub-requests and responses are packed, their sizes may be at odd offsets
+        uint8_t pReq2[c_Apdu_BufSize];
+        pReq2[0] = g_Proto_Code_BatchInvoke;
+        pReq2[1] = 0;
+        uint32_t nReq2 = AddToBatch(pReq2, sizeof(Proto_In_BatchInvoke), &reqVer, sizeof(reqVer));
+        verify_test(1 & nReq2); // the 2nd request size
+
+        reqImg.m_iChild = 0;
+        nReq2 = AddToBatch(pReq2, nReq2, &reqImg, sizeof(reqImg));
+
+        uint16_t nSub;
+        uint32_t nVer = sizeof(nSub) + sizeof(Proto_Out_Version);
+        uint32_t nPos = sizeof(Proto_Out_BatchInvoke) + nVer;
+        verify_test(1 & nPos); // the 2nd response size
+
+        verify_test(SW_OK == Apdu_Send(0, 0, pReq2, (uint8_t) nReq2, &nLen));
+        verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && (2 == g_pApdu[1]));
+
+        // the last and the 1st responses of the above batch
+        uint32_t nImg = sizeof(nSub) + sizeof(Proto_Out_GetImage);
+        verify_test(nLen == (int) (nPos + nImg));
+        verify_test(!memcmp(g_pApdu + sizeof(Proto_Out_BatchInvoke), pRef + nRef - nVer, nVer));
+        verify_test(!memcmp(g_pApdu + nPos, pRef, nImg));
+    }
+
+    {
+        // stops at the first failure, it's the last response
+        uint8_t pReq2[c_Apdu_BufSize];
+        pReq2[0] = g_Proto_Code_BatchInvoke;
+        pReq2[1] = 0;
+        uint32_t nReq2 = sizeof(Proto_In_BatchInvoke);
+
+        uint8_t pBad[] = { 0x7f }; // no such method
+        nReq2 = AddToBatch(pReq2, nReq2, &reqVer, sizeof(reqVer));
+        nReq2 = AddToBatch(pReq2, nReq2, pBad, sizeof(pBad));
+        nReq2 = AddToBatch(pReq2, nReq2, &reqVer, sizeof(reqVer));
+
+        verify_test(SW_OK == Apdu_Send(0, 0, pReq2, (uint8_t) nReq2, &nLen));
+        verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && (2 == g_pApdu[1]));
+
+        uint16_t nSub;
+        memcpy(&nSub, g_pApdu + sizeof(Proto_Out_BatchInvoke), sizeof(nSub));
+        uint32_t nPos = sizeof(Proto_Out_BatchInvoke) + sizeof(nSub) + nSub;
+
+        memcpy(&nSub, g_pApdu + nPos, sizeof(nSub));
+        verify_test(2 == nSub);
+        verify_test(c_KeyKeeper_Status_Ok != g_pApdu[nPos + sizeof(nSub)]);
+        verify_test(nLen == (int) (nPos + sizeof(nSub) + nSub));
+
+        // nested batch is rejected
+        nReq2 = sizeof(Proto_In_BatchInvoke);
+        pReq2[1] = 0;
+        nReq2 = AddToBatch(pReq2, nReq2, pReq, sizeof(Proto_In_BatchInvoke));
+
+        verify_test(SW_OK == Apdu_Send(0, 0, pReq2, (uint8_t) nReq2, &nLen));
+        verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && (1 == g_pApdu[1]));
+        verify_test(c_KeyKeeper_Status_Ok != g_pApdu[sizeof(Proto_Out_BatchInvoke) + sizeof(nSub)]);
+
+        // malformed envelope: nothing is executed
+        g_nRequests = 0;
+        pReq2[1] = 2;
+        verify_test(SW_OK == Apdu_Send(0, 0, pReq2, (uint8_t) nReq2, &nLen));
+        verify_test((2 == nLen) && (c_KeyKeeper_Status_Ok != g_pApdu[0]));
+    }
+}
+
+static void TestBulk()
+{
+    // the bulk requests through the transport: as many records as fit the response are processed, more are rejected
+    _Static_assert(c_Apdu_BufSize - sizeof(uint16_t) >= c_KeyKeeper_ResponseMax, "");
+
+    Proto_In_GetImage reqImg;
+    memset(&reqImg, 0, sizeof(reqImg));
+    reqImg.m_OpCode = g_Proto_Code_GetImage;
+    memset(reqImg.m_hvSrc.m_pVal, 0x71, sizeof(reqImg.m_hvSrc.m_pVal));
+    reqImg.m_bG = 1;
+    reqImg.m_bJ = 1;
+
+    CompactPoint pPt[(c_KeyKeeper_CreateOutputs_MaxCount + 1) * 3]; // valid points for the outputs
+    for (uint32_t i = 0; i < _countof(pPt); i++)
+    {
+        reqImg.m_iChild = 100 + i;
+
+        Proto_Out_GetImage res;
+        uint32_t nOut = sizeof(res);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&g_Kk, (const uint8_t*) &reqImg, sizeof(reqImg), (uint8_t*) &res, &nOut));
+        pPt[i] = res.m_ptImageG;
+    }
+
+    static uint8_t pReq[c_Apdu_ChainMax];
+    static uint8_t pOut[c_Apdu_ChainMax]; // larger than the response
+    int nLen;
+
+    {
+        Proto_In_GetImages* pIn = (Proto_In_GetImages*) pReq;
+        GetImages_In* pRec = (GetImages_In*) (pIn + 1);
+        pIn->m_OpCode = g_Proto_Code_GetImages;
+
+        GetImages_Out pRef[c_KeyKeeper_GetImages_MaxCount + 1];
+
+        for (uint32_t i = 0; i < _countof(pRef); i++)
+        {
+            reqImg.m_iChild = i;
+            reqImg.m_bG = (i % 3) != 1;
+            reqImg.m_bJ = (i % 3) != 0;
+
+            pRec[i].m_hvSrc = reqImg.m_hvSrc;
+            pRec[i].m_iChild = reqImg.m_iChild;
+            pRec[i].m_bG = reqImg.m_bG;
+            pRec[i].m_bJ = reqImg.m_bJ;
+
+            Proto_Out_GetImage res;
+            uint32_t nOut = sizeof(res);
+            verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&g_Kk, (const uint8_t*) &reqImg, sizeof(reqImg), (uint8_t*) &res, &nOut));
+            pRef[i].m_ptImageG = res.m_ptImageG;
+            pRef[i].m_ptImageJ = res.m_ptImageJ;
+        }
+
+        pIn->m_Count = c_KeyKeeper_GetImages_MaxCount;
+        verify_test(SW_OK == Apdu_SendChained(pReq, sizeof(*pIn) + sizeof(GetImages_In) * pIn->m_Count, 255, &nLen));
+        verify_test(nLen == (int) (sizeof(Proto_Out_GetImages) + sizeof(GetImages_Out) * c_KeyKeeper_GetImages_MaxCount));
+        verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && !memcmp(g_pApdu + sizeof(Proto_Out_GetImages), pRef, nLen - sizeof(Proto_Out_GetImages)));
+
+        pIn->m_Count++;
+        uint32_t nOut = sizeof(pOut);
+        verify_test(c_KeyKeeper_Status_ProtoError == KeyKeeper_Invoke(&g_Kk, pReq, sizeof(*pIn) + sizeof(GetImages_In) * pIn->m_Count, pOut, &nOut)); // regardless of the buffer
+
+        verify_test(SW_OK == Apdu_SendChained(pReq, sizeof(*pIn) + sizeof(GetImages_In) * pIn->m_Count, 255, &nLen));
+        verify_test((2 == nLen) && (c_KeyKeeper_Status_ProtoError == g_pApdu[0]));
+    }
+
+    {
+        // the records don't fit a single frame, chained
+        Proto_In_CreateOutputs* pIn = (Proto_In_CreateOutputs*) pReq;
+        CreateOutputs_In* pRec = (CreateOutputs_In*) (pIn + 1);
+        pIn->m_OpCode = g_Proto_Code_CreateOutputs;
+
+        CreateOutputs_Out pRef[c_KeyKeeper_CreateOutputs_MaxCount + 1];
+
+        for (uint32_t i = 0; i < _countof(pRef); i++)
+        {
+            Proto_In_CreateOutput req;
+            memset(&req, 0, sizeof(req));
+            req.m_OpCode = g_Proto_Code_CreateOutput;
+            req.m_Cid.m_Idx = 200 + i;
+            req.m_Cid.m_Type = 0x22;
+            req.m_Cid.m_Amount = 1000000 * (i + 1);
+            req.m_Cid.m_AssetID = (1 & i) ? 3 : 0;
+
+            req.m_pT[0] = pPt[i * 3];
+            req.m_pT[1] = pPt[i * 3 + 1];
+            if (req.m_Cid.m_AssetID)
+                req.m_ptAssetGen = pPt[i * 3 + 2];
+
+            memcpy(&pRec[i].m_Cid, &req.m_Cid, sizeof(req.m_Cid));
+            memcpy(pRec[i].m_pKExtra, req.m_pKExtra, sizeof(req.m_pKExtra));
+            memcpy(pRec[i].m_pT, req.m_pT, sizeof(req.m_pT));
+            memcpy(&pRec[i].m_ptAssetGen, &req.m_ptAssetGen, sizeof(req.m_ptAssetGen));
+
+            Proto_Out_CreateOutput res;
+            uint32_t nOut = sizeof(res);
+            verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&g_Kk, (const uint8_t*) &req, sizeof(req), (uint8_t*) &res, &nOut));
+            memcpy(pRef[i].m_pT, res.m_pT, sizeof(res.m_pT));
+            pRef[i].m_TauX = res.m_TauX;
+        }
+
+        pIn->m_Count = c_KeyKeeper_CreateOutputs_MaxCount;
+        uint32_t nReq = sizeof(*pIn) + sizeof(CreateOutputs_In) * pIn->m_Count;
+        verify_test(nReq > 255);
+
+        verify_test(SW_OK == Apdu_SendChained(pReq, nReq, 255, &nLen));
+        verify_test(nLen == (int) (sizeof(Proto_Out_CreateOutputs) + sizeof(CreateOutputs_Out) * c_KeyKeeper_CreateOutputs_MaxCount));
+        verify_test((c_KeyKeeper_Status_Ok == g_pApdu[0]) && !memcmp(g_pApdu + sizeof(Proto_Out_CreateOutputs), pRef, nLen - sizeof(Proto_Out_CreateOutputs)));
+
+        pIn->m_Count++;
+        uint32_t nOut = sizeof(pOut);
+        verify_test(c_KeyKeeper_Status_ProtoError == KeyKeeper_Invoke(&g_Kk, pReq, sizeof(*pIn) + sizeof(CreateOutputs_In) * pIn->m_Count, pOut, &nOut)); // regardless of the buffer
+
+        verify_test(SW_OK == Apdu_SendChained(pReq, sizeof(*pIn) + sizeof(CreateOutputs_In) * pIn->m_Count, 255, &nLen));
+        verify_test((2 == nLen) && (c_KeyKeeper_Status_ProtoError == g_pApdu[0]));
+    }
+}
+
+int main()
+{
+    UintBig seed;
+    memset(seed.m_pVal, 0x11, sizeof(seed.m_pVal));
+
+    memset(&g_Kk, 0, sizeof(g_Kk));
+    Kdf_Init(&g_Kk.m_MasterKey, &seed);
+
+    TestStandalone();
+    TestChained();
+    TestChainErrors();
+    TestStreamed();
+    TestStreamedAbort();
+    TestBatch();
+    TestBulk();
+
+    if (g_Failed)
+    {
+        printf("%u test(s) failed\n", g_Failed);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-method KeyKeeper_Invoke throughput/latency benchmark.
+// Usage: beamhw_bench [iterations=50] [coins=32]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "os.h"
+#include "Scenarios.h"
+
+#define c_Bench_MaxLabels 64
+
+typedef struct
+{
+    char m_szLabel[40];
+    uint64_t* m_pNs;
+    uint32_t m_Count;
+    uint32_t m_Capacity;
+    uint32_t m_Errors;
+
+} BenchStat;
+
+typedef struct
+{
+    HostInvoker m_Base;
+    BenchStat m_pStat[c_Bench_MaxLabels];
+    uint32_t m_nStats;
+
+} BenchInvoker;
+
+static uint64_t Bench_Now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static BenchStat* Bench_FindStat(BenchInvoker* p, const char* szLabel)
+{
+    for (uint32_t i = 0; i < p->m_nStats; i++)
+        if (!strcmp(p->m_pStat[i].m_szLabel, szLabel))
+            return p->m_pStat + i;
+
+    if (p->m_nStats == c_Bench_MaxLabels)
+        return 0;
+
+    BenchStat* pStat = p->m_pStat + p->m_nStats++;
+    memset(pStat, 0, sizeof(*pStat));
+    snprintf(pStat->m_szLabel, sizeof(pStat->m_szLabel), "%s", szLabel);
+    return pStat;
+}
+
+static void Bench_AddSample(BenchStat* pStat, uint64_t ns)
+{
+    if (pStat->m_Count == pStat->m_Capacity)
+    {
+        pStat->m_Capacity = pStat->m_Capacity ? (pStat->m_Capacity * 2) : 64;
+        pStat->m_pNs = (uint64_t*) realloc(pStat->m_pNs, sizeof(uint64_t) * pStat->m_Capacity);
+        if (!pStat->m_pNs)
+            abort();
+    }
+
+    pStat->m_pNs[pStat->m_Count++] = ns;
+}
+
+static uint16_t Bench_Invoke(HostInvoker* pBase, const char* szLabel, KeyKeeper* pKk, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize)
+{
+    if (!szLabel)
+        return KeyKeeper_Invoke(pKk, pIn, nIn, pOut, pOutSize);
+
+    uint64_t t0 = Bench_Now();
+    uint16_t errCode = KeyKeeper_Invoke(pKk, pIn, nIn, pOut, pOutSize);
+    uint64_t dt = Bench_Now() - t0;
+
+    BenchStat* pStat = Bench_FindStat((BenchInvoker*) pBase, szLabel);
+    if (pStat)
+    {
+        Bench_AddSample(pStat, dt);
+        if (c_KeyKeeper_Status_Ok != errCode)
+            pStat->m_Errors++;
+    }
+
+    return errCode;
+}
+
+static int Bench_CmpNs(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+static double Bench_Percentile(const BenchStat* pStat, uint32_t nPerMille)
+{
+    // nearest-rank on sorted samples
+    uint32_t i = (uint32_t) (((uint64_t) pStat->m_Count * nPerMille + 999) / 1000);
+    if (i)
+        i--;
+    return pStat->m_pNs[i] / 1000.;
+}
+
+static void Bench_Print(BenchInvoker* p)
+{
+    printf("%-28s %8s %12s %12s %12s %12s %6s\n", "Method", "Count", "ops/sec", "p50 (us)", "p99 (us)", "p999 (us)", "Errors");
+
+    for (uint32_t i = 0; i < p->m_nStats; i++)
+    {
+        BenchStat* pStat = p->m_pStat + i;
+        if (!pStat->m_Count)
+            continue;
+
+        qsort(pStat->m_pNs, pStat->m_Count, sizeof(uint64_t), Bench_CmpNs);
+
+        uint64_t nTotal = 0;
+        for (uint32_t j = 0; j < pStat->m_Count; j++)
+            nTotal += pStat->m_pNs[j];
+
+        printf("%-28s %8u %12.1f %12.1f %12.1f %12.1f %6u\n",
+            pStat->m_szLabel,
+            pStat->m_Count,
+            nTotal ? (pStat->m_Count * 1e9 / nTotal) : 0.,
+            Bench_Percentile(pStat, 500),
+            Bench_Percentile(pStat, 990),
+            Bench_Percentile(pStat, 999),
+            pStat->m_Errors);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t nIterations = (argc > 1) ? (uint32_t) atoi(argv[1]) : 50;
+    uint32_t nCoins = (argc > 2) ? (uint32_t) atoi(argv[2]) : 32;
+
+    static BenchInvoker s_Inv;
+    s_Inv.m_Base.m_pfnInvoke = Bench_Invoke;
+
+    const HostScenario* pScenarios = HostScenario_GetAll(nCoins);
+
+    for (uint32_t i = 0; i < nIterations; i++)
+        for (const HostScenario* pSc = pScenarios; pSc->m_szName; pSc++)
+            pSc->m_pfnRun(&s_Inv.m_Base, pSc->m_nParam);
+
+    Bench_Print(&s_Inv);
+
+    for (uint32_t i = 0; i < s_Inv.m_nStats; i++)
+        free(s_Inv.m_pStat[i].m_pNs);
+
+    if (s_Inv.m_Base.m_Errors)
+    {
+        printf("%u invocations failed\n", s_Inv.m_Base.m_Errors);
+        return 1;
+    }
+
+    return 0;
+}
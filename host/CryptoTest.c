@@ -0,0 +1,1028 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host tests of the hw_crypto primitives: alternative code paths must produce exactly the same results.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "os.h"
+#include "hw_crypto/multimac.h"
+#include "hw_crypto/sign.h"
+#include "hw_crypto/kdf.h"
+#include "hw_crypto/noncegen.h"
+#include "hw_crypto/keykeeper.h"
+#include "hw_crypto/rangeproof.h"
+#include "TestVectors.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "secp256k1/src/group_impl.h"
+#include "secp256k1/src/scalar_impl.h"
+#include "secp256k1/src/field_impl.h"
+#include "secp256k1/src/int128_impl.h"
+#include "secp256k1/src/hash_impl.h"
+#pragma GCC diagnostic pop
+
+#ifndef _countof
+#	define _countof(arr) sizeof(arr) / sizeof((arr)[0])
+#endif
+
+static uint32_t g_Failed = 0;
+
+#define verify_test(x) \
+    do { \
+        if (!(x)) \
+        { \
+            printf("Test failed! Line=%u, Expression: %s\n", __LINE__, #x); \
+            g_Failed++; \
+        } \
+    } while (0)
+
+static uint64_t g_RndState = 0x9e3779b97f4a7c15ull;
+
+static uint64_t Rnd_Next()
+{
+    // xorshift64*, deterministic
+    g_RndState ^= g_RndState >> 12;
+    g_RndState ^= g_RndState << 25;
+    g_RndState ^= g_RndState >> 27;
+    return g_RndState * 0x2545f4914f6cdd1dull;
+}
+
+static void Rnd_Scalar(secp256k1_scalar* pK)
+{
+    uint8_t pBuf[32];
+    for (uint32_t i = 0; i < sizeof(pBuf); i += sizeof(uint64_t))
+    {
+        uint64_t val = Rnd_Next();
+        memcpy(pBuf + i, &val, sizeof(val));
+    }
+
+    int overflow;
+    secp256k1_scalar_set_b32(pK, pBuf, &overflow);
+
+    switch (Rnd_Next() % 4)
+    {
+    case 0:
+        secp256k1_scalar_negate(pK, pK); // close to the order, maximum carries in the recoding
+        break;
+
+    case 1:
+        if (!(Rnd_Next() % 8))
+            secp256k1_scalar_clear(pK);
+        break;
+    }
+}
+
+#define c_Test_MultiMac_nPitch c_MultiMac_OddCount(c_MultiMac_nBits_Rangeproof)
+
+static void MultiMac_Fast(secp256k1_gej* pRes, const secp256k1_ge_storage* pGen0, secp256k1_scalar* pK, MultiMac_WNaf* pWnaf, unsigned int nCount)
+{
+    MultiMac_Context ctx;
+    ctx.m_pRes = pRes;
+    ctx.m_Secure.m_Count = 0;
+    ctx.m_Fast.m_pZDenom = 0;
+    ctx.m_Fast.m_Count = nCount;
+    ctx.m_Fast.m_WndBits = c_MultiMac_nBits_Rangeproof;
+    ctx.m_Fast.m_pGen0 = pGen0;
+    ctx.m_Fast.m_pK = pK;
+    ctx.m_Fast.m_pWnaf = pWnaf;
+
+    MultiMac_Calculate(&ctx);
+}
+
+static void MultiMac_FastAndZeroSecure(secp256k1_gej* pRes, const secp256k1_ge_storage* pGen0, secp256k1_scalar* pK, MultiMac_WNaf* pWnaf, unsigned int nCount)
+{
+    // the 'secure' term (zero) doesn't change the result, but forces the full doubling chain without the GLV split
+    secp256k1_scalar kZero;
+    secp256k1_scalar_clear(&kZero);
+
+    MultiMac_Context ctx;
+    ctx.m_pRes = pRes;
+    ctx.m_Secure.m_Count = 1;
+    ctx.m_Secure.m_pGen = Context_get()->m_pGenGJ;
+    ctx.m_Secure.m_pK = &kZero;
+    ctx.m_Fast.m_pZDenom = 0;
+    ctx.m_Fast.m_Count = nCount;
+    ctx.m_Fast.m_WndBits = c_MultiMac_nBits_Rangeproof;
+    ctx.m_Fast.m_pGen0 = pGen0;
+    ctx.m_Fast.m_pK = pK;
+    ctx.m_Fast.m_pWnaf = pWnaf;
+
+    MultiMac_Calculate(&ctx);
+}
+
+static void TestMultiMacBuckets()
+{
+#ifdef c_MultiMac_Buckets_MinCount
+
+    // Large batch over the rangeproof generators, each used several times.
+    // Compare to the wNAF calculation over the accumulated per-generator scalars.
+    const Context* pCtx = Context_get();
+
+    uint32_t pCount[] = { c_MultiMac_Buckets_MinCount, 1000, 2500 };
+
+    for (uint32_t iCase = 0; iCase < _countof(pCount); iCase++)
+    {
+        uint32_t nCount = pCount[iCase];
+
+        secp256k1_ge_storage* pGen = (secp256k1_ge_storage*) malloc(sizeof(secp256k1_ge_storage) * c_Test_MultiMac_nPitch * nCount);
+        secp256k1_scalar* pK = (secp256k1_scalar*) malloc(sizeof(secp256k1_scalar) * nCount);
+        MultiMac_WNaf* pWnaf = (MultiMac_WNaf*) malloc(sizeof(MultiMac_WNaf) * nCount);
+        if (!pGen || !pK || !pWnaf)
+            abort();
+
+        secp256k1_scalar pKSum[c_MultiMac_Fast_nGenerators];
+        MultiMac_WNaf pWnafSum[c_MultiMac_Fast_nGenerators];
+
+        for (uint32_t i = 0; i < c_MultiMac_Fast_nGenerators; i++)
+            secp256k1_scalar_clear(pKSum + i);
+
+        for (uint32_t i = 0; i < nCount; i++)
+        {
+            uint32_t iGen = i % c_MultiMac_Fast_nGenerators;
+            memcpy(pGen + c_Test_MultiMac_nPitch * i, pCtx->m_pGenRangeproof[iGen], sizeof(pCtx->m_pGenRangeproof[iGen]));
+
+            Rnd_Scalar(pK + i);
+            secp256k1_scalar_add(pKSum + iGen, pKSum + iGen, pK + i);
+        }
+
+        secp256k1_gej gej1, gej2;
+        MultiMac_Fast(&gej1, pGen, pK, pWnaf, nCount);
+        MultiMac_Fast(&gej2, pCtx->m_pGenRangeproof[0], pKSum, pWnafSum, c_MultiMac_Fast_nGenerators);
+
+        verify_test(!secp256k1_gej_is_infinity(&gej1));
+        verify_test(secp256k1_gej_eq_var(&gej1, &gej2));
+
+        free(pWnaf);
+        free(pK);
+        free(pGen);
+    }
+
+#endif // c_MultiMac_Buckets_MinCount
+}
+
+static void TestMultiMacGlv()
+{
+#ifdef c_MultiMac_Glv_MaxCount
+
+    const Context* pCtx = Context_get();
+
+    for (uint32_t iCase = 0; iCase < 200; iCase++)
+    {
+        uint32_t nCount = 1 + (iCase % c_MultiMac_Glv_MaxCount);
+
+        secp256k1_scalar pK[c_MultiMac_Glv_MaxCount], pK2[c_MultiMac_Glv_MaxCount];
+        MultiMac_WNaf pWnaf[c_MultiMac_Glv_MaxCount];
+
+        for (uint32_t i = 0; i < nCount; i++)
+        {
+            if (iCase < 2)
+                secp256k1_scalar_set_int(pK + i, iCase); // 0 and 1
+            else
+                Rnd_Scalar(pK + i);
+            pK2[i] = pK[i];
+        }
+
+        // consecutive generators of the rangeproof table, i.e. the same layout as MultiMac_Fast expects
+        const secp256k1_ge_storage* pGen0 = pCtx->m_pGenRangeproof[iCase % (c_MultiMac_Fast_nGenerators - c_MultiMac_Glv_MaxCount)];
+
+        secp256k1_gej gej1, gej2;
+        MultiMac_Fast(&gej1, pGen0, pK, pWnaf, nCount);
+        MultiMac_FastAndZeroSecure(&gej2, pGen0, pK2, pWnaf, nCount);
+
+        verify_test(secp256k1_gej_eq_var(&gej1, &gej2));
+    }
+
+#endif // c_MultiMac_Glv_MaxCount
+}
+
+static void TestComb()
+{
+#ifndef BeamCrypto_ExternalGej
+
+    // comb for G, J and both, compare to the 'secure' MultiMac over the same generators
+    const Context* pCtx = Context_get();
+
+    for (uint32_t iCase = 0; iCase < 300; iCase++)
+    {
+        secp256k1_scalar pK[2];
+        for (uint32_t i = 0; i < _countof(pK); i++)
+        {
+            if (iCase < 4)
+                secp256k1_scalar_set_int(pK + i, (iCase >> i) & 1); // 0 and 1
+            else
+                Rnd_Scalar(pK + i);
+        }
+
+        uint32_t iGen = iCase % 3;
+        uint32_t i0 = (2 == iGen) ? 0 : iGen;
+        uint32_t nCount = (2 == iGen) ? 2 : 1;
+
+        secp256k1_gej gej1, gej2;
+        MultiMac_Comb_Calculate(&gej1, pCtx->m_pCombGJ + i0, pK, nCount);
+
+        MultiMac_Context ctx;
+        ctx.m_pRes = &gej2;
+        ctx.m_Fast.m_Count = 0;
+        ctx.m_Secure.m_Count = nCount;
+        ctx.m_Secure.m_pGen = pCtx->m_pGenGJ + i0;
+        ctx.m_Secure.m_pK = pK;
+        MultiMac_Calculate(&ctx);
+
+        verify_test(secp256k1_gej_is_infinity(&gej1) == secp256k1_gej_is_infinity(&gej2));
+        verify_test(secp256k1_gej_is_infinity(&gej1) || secp256k1_gej_eq_var(&gej1, &gej2));
+    }
+
+#endif // BeamCrypto_ExternalGej
+}
+
+static void TestRangeproofBytes()
+{
+#ifdef c_MultiMac_Rangeproof_nBytes
+
+    // each table entry must be the sum of the +G_i / -H_i for its bits
+    const Context* pCtx = Context_get();
+
+    for (uint32_t iCase = 0; iCase < 64; iCase++)
+    {
+        uint32_t iByte = iCase % c_MultiMac_Rangeproof_nBytes;
+        uint32_t val = (iCase < 16) ? ((iCase < 8) ? 0 : 0xff) : (uint8_t) Rnd_Next();
+
+        secp256k1_gej gej;
+        secp256k1_gej_set_infinity(&gej);
+
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            uint32_t iGen = iByte * 8 + i;
+            secp256k1_ge ge;
+
+            if (1 & (val >> i))
+                secp256k1_ge_from_storage(&ge, pCtx->m_pGenRangeproof[iGen]);
+            else
+            {
+                secp256k1_ge_from_storage(&ge, pCtx->m_pGenRangeproof[c_MultiMac_Fast_nGenerators / 2 + iGen]);
+                secp256k1_ge_neg(&ge, &ge);
+            }
+
+            secp256k1_gej_add_ge_var(&gej, &gej, &ge, 0);
+        }
+
+        secp256k1_ge ge;
+        secp256k1_ge_from_storage(&ge, pCtx->m_pGenRangeproofBytes[iByte] + val);
+
+        secp256k1_ge_neg(&ge, &ge);
+        secp256k1_gej_add_ge_var(&gej, &gej, &ge, 0);
+        verify_test(secp256k1_gej_is_infinity(&gej));
+    }
+
+#endif // c_MultiMac_Rangeproof_nBytes
+}
+
+static void Test_SigVerify(const Signature* pSig, const UintBig* pMsg, const CompactPoint* pPk, int bValid)
+{
+    verify_test(!Signature_IsValid(pSig, pMsg, pPk) == !bValid);
+
+#ifdef BeamCrypto_FastVerify
+    // the variable-time verifier must agree with the constant-time one
+    verify_test(!Signature_IsValid_Secure(pSig, pMsg, pPk) == !bValid);
+#endif // BeamCrypto_FastVerify
+}
+
+static void TestSignature()
+{
+    // sign/verify roundtrip, and verification must reject any modification
+    for (uint32_t iCase = 0; iCase < 300; iCase++)
+    {
+        secp256k1_scalar sk;
+        Rnd_Scalar(&sk);
+        if (secp256k1_scalar_is_zero(&sk))
+            secp256k1_scalar_set_int(&sk, 1);
+
+        CompactPoint pk;
+        Sk2Pk(&pk.m_X, &sk); // sk is negated if necessary, so that y is even
+        pk.m_Y = 0;
+
+        UintBig msg;
+        for (uint32_t i = 0; i < sizeof(msg.m_pVal); i++)
+            msg.m_pVal[i] = (uint8_t) Rnd_Next();
+
+        Signature sig;
+        Signature_Sign(&sig, &msg, &sk);
+        Test_SigVerify(&sig, &msg, &pk, 1);
+
+        Signature sig2 = sig;
+        sig2.m_k.m_pVal[Rnd_Next() % sizeof(sig2.m_k.m_pVal)] ^= (uint8_t) (1 + Rnd_Next() % 255);
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        // wrong y parity of the nonce
+        sig2 = sig;
+        sig2.m_NoncePub.m_Y ^= 1;
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        sig2.m_NoncePub.m_Y = 2;
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        sig2 = sig;
+        sig2.m_NoncePub.m_X.m_pVal[Rnd_Next() % sizeof(sig2.m_NoncePub.m_X.m_pVal)] ^= 1;
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        msg.m_pVal[0] ^= 1;
+        Test_SigVerify(&sig, &msg, &pk, 0);
+        msg.m_pVal[0] ^= 1;
+
+        pk.m_Y = 1;
+        Test_SigVerify(&sig, &msg, &pk, 0);
+        pk.m_Y = 0;
+
+        // nonce with no valid y (and beyond the field)
+        sig2 = sig;
+        for (secp256k1_ge ge; ; sig2.m_NoncePub.m_X.m_pVal[31]++)
+        {
+            verify_test(secp256k1_fe_set_b32(&ge.x, sig2.m_NoncePub.m_X.m_pVal));
+            if (!secp256k1_ge_set_xo_var(&ge, &ge.x, 0))
+                break;
+        }
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        memset(sig2.m_NoncePub.m_X.m_pVal, 0xff, sizeof(sig2.m_NoncePub.m_X.m_pVal));
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        // zero nonce (at infinity): valid if k*G + e*Pk is at infinity too
+        secp256k1_scalar nonce;
+        secp256k1_scalar_set_int(&nonce, 0);
+
+        memset(&sig2.m_NoncePub, 0, sizeof(sig2.m_NoncePub));
+        Signature_SignPartial(&sig2, &msg, &sk, &nonce);
+        Test_SigVerify(&sig2, &msg, &pk, 1);
+
+        sig2.m_NoncePub.m_Y = 1;
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        sig2.m_NoncePub.m_Y = 0;
+        sig2.m_k.m_pVal[31] ^= 1;
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        sig2 = sig;
+        memset(&sig2.m_NoncePub, 0, sizeof(sig2.m_NoncePub));
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        // k*G + e*Pk at infinity, but the nonce is not
+        sig2 = sig;
+        Signature_SignPartial(&sig2, &msg, &sk, &nonce);
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        // the signature is valid for the nonce of the same x, but the other y parity. The challenge covers the parity, hence signed for each
+        Rnd_Scalar(&nonce);
+        Sk2Pk(&sig2.m_NoncePub.m_X, &nonce); // y is even
+
+        sig2.m_NoncePub.m_Y = 0;
+        Signature_SignPartial(&sig2, &msg, &sk, &nonce);
+        Test_SigVerify(&sig2, &msg, &pk, 1);
+
+        sig2.m_NoncePub.m_Y = 1;
+        Signature_SignPartial(&sig2, &msg, &sk, &nonce);
+        Test_SigVerify(&sig2, &msg, &pk, 0);
+
+        // zero pubkey: only k*G counts
+        CompactPoint pk0;
+        memset(&pk0, 0, sizeof(pk0));
+
+        memset(&sig2.m_NoncePub, 0, sizeof(sig2.m_NoncePub));
+        memset(sig2.m_k.m_pVal, 0, sizeof(sig2.m_k.m_pVal));
+        Test_SigVerify(&sig2, &msg, &pk0, 1);
+        sig2.m_k.m_pVal[31] = 1;
+        Test_SigVerify(&sig2, &msg, &pk0, 0);
+    }
+}
+
+static void TestSha256()
+{
+#ifdef BeamCrypto_Sha256Accel
+
+    // accelerated compression must be bit-exact with the portable one
+    Sha256_Transform_t pfn = g_pfnSha256Transform;
+    if (!pfn)
+    {
+        printf("SHA-256: no accelerated implementation on this CPU, skipped\n");
+        return;
+    }
+
+    uint8_t pMsg[300];
+    for (uint32_t i = 0; i < sizeof(pMsg); i++)
+        pMsg[i] = (uint8_t) Rnd_Next();
+
+    for (uint32_t iCase = 0; iCase < 200; iCase++)
+    {
+        uint32_t pState[2][8];
+        uint8_t pBlock[64];
+
+        for (uint32_t i = 0; i < 8; i++)
+            pState[0][i] = pState[1][i] = (uint32_t) Rnd_Next();
+        for (uint32_t i = 0; i < sizeof(pBlock); i++)
+            pBlock[i] = (uint8_t) Rnd_Next();
+
+        pfn(pState[0], pBlock);
+
+        g_pfnSha256Transform = 0;
+        secp256k1_sha256_transform(pState[1], pBlock);
+        g_pfnSha256Transform = pfn;
+
+        verify_test(!memcmp(pState[0], pState[1], sizeof(pState[0])));
+    }
+
+    // whole messages of all the lengths around the block boundaries
+    for (uint32_t nLen = 0; nLen <= sizeof(pMsg); nLen++)
+    {
+        uint8_t pHash[2][32];
+
+        for (uint32_t iImpl = 0; iImpl < 2; iImpl++)
+        {
+            g_pfnSha256Transform = iImpl ? 0 : pfn;
+
+            secp256k1_sha256 sha;
+            secp256k1_sha256_initialize(&sha);
+            secp256k1_sha256_write(&sha, pMsg, nLen);
+            secp256k1_sha256_finalize(&sha, pHash[iImpl]);
+        }
+
+        g_pfnSha256Transform = pfn;
+        verify_test(!memcmp(pHash[0], pHash[1], sizeof(pHash[0])));
+    }
+
+#endif // BeamCrypto_Sha256Accel
+}
+
+static void Rnd_UintBig(UintBig* p)
+{
+    for (uint32_t i = 0; i < sizeof(p->m_pVal); i++)
+        p->m_pVal[i] = (uint8_t) Rnd_Next();
+}
+
+static void TestNonceGenerator()
+{
+    // bulk and prepared variants must continue exactly the same sequence
+    static const HMacSalt salt = HMacSalt_bulletproof;
+    static const uint8_t pCtx[] = "ctx";
+
+    UintBig seed;
+    Rnd_UintBig(&seed);
+
+    NonceGenerator pNg[2];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        NonceGenerator_Init(pNg + i, &salt, &seed);
+        pNg[i].m_pContext = pCtx;
+        pNg[i].m_nContext = sizeof(pCtx);
+    }
+
+    secp256k1_scalar pK[2][40];
+    for (uint32_t i = 0; i < _countof(pK[0]); i++)
+        NonceGenerator_NextScalar(pNg, pK[0] + i);
+
+    NonceGenerator_NextScalar(pNg + 1, pK[1]);
+    NonceGenerator_NextScalars(pNg + 1, pK[1] + 1, 20);
+
+    HMacSalt prk;
+    NonceGenerator_PrepareHMac(pNg + 1, &prk);
+    for (uint32_t i = 21; i < _countof(pK[1]); i++)
+        NonceGenerator_NextScalarEx(pNg + 1, &prk, pK[1] + i);
+
+    for (uint32_t i = 0; i < _countof(pK[0]); i++)
+        verify_test(secp256k1_scalar_eq(pK[0] + i, pK[1] + i));
+
+    verify_test(!memcmp(pNg[0].m_Okm.m_pVal, pNg[1].m_Okm.m_pVal, sizeof(pNg[0].m_Okm.m_pVal)));
+    verify_test(pNg[0].m_Counter == pNg[1].m_Counter);
+}
+
+static void Test_MulNaive(secp256k1_gej* pRes, const secp256k1_ge* pGe, const secp256k1_scalar* pK)
+{
+    // the reference, double-and-add
+    secp256k1_gej_set_infinity(pRes);
+    for (int iBit = 255; iBit >= 0; iBit--)
+    {
+        secp256k1_gej_double_var(pRes, pRes, 0);
+        if (secp256k1_scalar_get_bits(pK, (unsigned int) iBit, 1))
+            secp256k1_gej_add_ge_var(pRes, pRes, pGe, 0);
+    }
+}
+
+static void Test_GetPoint(KeyKeeper* pKk, CompactPoint* pPt)
+{
+    Proto_In_GetImage req;
+    memset(&req, 0, sizeof(req));
+    req.m_OpCode = g_Proto_Code_GetImage;
+    Rnd_UintBig(&req.m_hvSrc);
+    req.m_bG = 1;
+
+    Proto_Out_GetImage res;
+    uint32_t nOut = sizeof(res);
+    verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(pKk, (const uint8_t*) &req, sizeof(req), (uint8_t*) &res, &nOut));
+
+    *pPt = res.m_ptImageG;
+}
+
+// Cached vs not cached derivations of the same thing, by the key (subkey, viewer, asset)
+typedef struct
+{
+    void (*m_pfnCached)(KeyKeeper*, uint32_t iKey, void* pRes);
+    void (*m_pfnRef)(KeyKeeper*, uint32_t iKey, void* pRes);
+    uint32_t m_nKeys; // more than fit the cache, to have the evictions
+    uint32_t m_nSize;
+
+} Test_Cache;
+
+static void Test_Cache_PKdf(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    KeyKeeper_GetPKdf(pKk, (KdfPub*) pRes, &iKey);
+}
+
+static void Test_Cache_PKdf_Ref(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    Kdf kdf;
+    Kdf_getChild(&kdf, iKey, &pKk->m_MasterKey);
+    Kdf2Pub(&kdf, (KdfPub*) pRes);
+}
+
+static void Test_Cache_OwnerPKdf(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    UNUSED(iKey);
+    KeyKeeper_GetPKdf(pKk, (KdfPub*) pRes, 0);
+}
+
+static void Test_Cache_OwnerPKdf_Ref(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    UNUSED(iKey);
+    Kdf2Pub(&pKk->m_MasterKey, (KdfPub*) pRes);
+}
+
+static void Test_Cache_Addr(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    OfflineAddr_Init((OfflineAddr*) pRes, pKk, iKey);
+}
+
+static void Test_Cache_Addr_Ref(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    ShieldedViewer viewer;
+    ShieldedViewerInit(&viewer, iKey, pKk);
+    OfflineAddr_FromViewer((OfflineAddr*) pRes, &viewer);
+}
+
+static void Test_Cache_Output_Init(RangeProof* pRp, Proto_In_CreateOutput* pReq, uint32_t iKey)
+{
+    // the coin of the asset iKey + 1, with the points that depend on the key only
+    memset(pReq, 0, sizeof(*pReq));
+    pReq->m_OpCode = g_Proto_Code_CreateOutput;
+
+    CoinID cid;
+    memset(&cid, 0, sizeof(cid));
+    cid.m_Idx = 7;
+    cid.m_Type = 0x22;
+    cid.m_Amount = 1000;
+    cid.m_AssetID = iKey + 1;
+    pReq->m_Cid = cid;
+
+    CompactPoint* ppPt[] = { &pReq->m_ptAssetGen, pReq->m_pT, pReq->m_pT + 1 };
+    for (uint32_t i = 0; i < _countof(ppPt); i++)
+    {
+        secp256k1_scalar k;
+        secp256k1_scalar_set_int(&k, iKey * _countof(ppPt) + i + 1);
+
+        secp256k1_gej gej;
+        secp256k1_ge ge;
+        Test_MulNaive(&gej, &secp256k1_ge_const_g, &k);
+        secp256k1_ge_set_gej(&ge, &gej);
+        Point_Compact_from_Ge(ppPt[i], &ge);
+    }
+
+    memset(pRp, 0, sizeof(*pRp));
+    pRp->m_Cid = cid;
+    pRp->m_pAssetGen = &pReq->m_ptAssetGen;
+    pRp->m_pT_In = pReq->m_pT;
+    pRp->m_pT_Out = pReq->m_pT;
+}
+
+static void Test_Cache_Output(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    RangeProof rp;
+    Proto_In_CreateOutput req;
+    Test_Cache_Output_Init(&rp, &req, iKey);
+
+    Proto_Out_CreateOutput res;
+    uint32_t nOut = sizeof(res);
+    verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(pKk, (const uint8_t*) &req, sizeof(req), (uint8_t*) &res, &nOut));
+
+    memcpy(pRes, res.m_pT, sizeof(res.m_pT));
+    memcpy(((CompactPoint*) pRes) + 2, res.m_TauX.m_pVal, sizeof(res.m_TauX.m_pVal));
+}
+
+static void Test_Cache_Output_Ref(KeyKeeper* pKk, uint32_t iKey, void* pRes)
+{
+    // with the master Kdf and no prepared asset generator
+    RangeProof rp;
+    Proto_In_CreateOutput req;
+    Test_Cache_Output_Init(&rp, &req, iKey);
+
+    secp256k1_scalar tauX;
+    rp.m_pKdf = &pKk->m_MasterKey;
+    rp.m_pTauX = &tauX;
+    verify_test(RangeProof_Calculate(&rp));
+
+    memcpy(pRes, req.m_pT, sizeof(req.m_pT));
+    secp256k1_scalar_get_b32(((CompactPoint*) pRes)[2].m_X.m_pVal, &tauX);
+}
+
+static void TestCaches()
+{
+    // the KeyKeeper caches must give the same as the not cached derivations, through the evictions too.
+    // All in the same KeyKeeper, in random order
+    static const Test_Cache s_pCase[] = {
+        { Test_Cache_PKdf, Test_Cache_PKdf_Ref, c_KeyKeeper_nChildKdf + c_KeyKeeper_nPKdf + 2, sizeof(KdfPub) }, // child Kdf and KdfPub caches
+        { Test_Cache_OwnerPKdf, Test_Cache_OwnerPKdf_Ref, 1, sizeof(KdfPub) },
+        { Test_Cache_Addr, Test_Cache_Addr_Ref, c_KeyKeeper_nViewer + 2, sizeof(OfflineAddr) },
+        { Test_Cache_Output, Test_Cache_Output_Ref, c_KeyKeeper_nAGen + 3, sizeof(CompactPoint) * 2 + sizeof(UintBig) },
+    };
+
+    UintBig seed;
+    Rnd_UintBig(&seed);
+
+    KeyKeeper kk;
+    memset(&kk, 0, sizeof(kk));
+    Kdf_Init(&kk.m_MasterKey, &seed);
+
+    for (uint32_t iStep = 0; iStep < 120; iStep++)
+    {
+        const Test_Cache* pCase = s_pCase + Rnd_Next() % _countof(s_pCase);
+        uint32_t iKey = (uint32_t) (Rnd_Next() % pCase->m_nKeys);
+
+        uint8_t pRes[2][sizeof(OfflineAddr) + sizeof(KdfPub)];
+        verify_test(pCase->m_nSize <= sizeof(pRes[0]));
+
+        pCase->m_pfnCached(&kk, iKey, pRes[0]);
+        pCase->m_pfnRef(&kk, iKey, pRes[1]);
+
+        verify_test(!memcmp(pRes[0], pRes[1], pCase->m_nSize));
+    }
+}
+
+static void TestOracleGej()
+{
+    // the batch-normalized points must be exposed exactly as one by one. And the forked transcript must continue the same way
+    for (uint32_t n = 1; n <= c_Oracle_GejBatchMax; n++)
+    {
+        gej_t pGej[c_Oracle_GejBatchMax];
+        for (uint32_t i = 0; i < n; i++)
+        {
+            secp256k1_scalar k;
+            Rnd_Scalar(&k);
+            Test_MulNaive(pGej + i, &secp256k1_ge_const_g, &k);
+        }
+
+        Oracle pOracle[2];
+        Oracle_Init(pOracle);
+        Oracle_Expose(pOracle, (const uint8_t*) "test", 4);
+        Oracle_Fork(pOracle, pOracle + 1);
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            secp256k1_ge ge;
+            secp256k1_ge_set_gej_var(&ge, pGej + i);
+
+            CompactPoint pt;
+            Point_Compact_from_Ge(&pt, &ge);
+            Oracle_Expose(pOracle, pt.m_X.m_pVal, sizeof(pt.m_X.m_pVal));
+            Oracle_Expose(pOracle, &pt.m_Y, sizeof(pt.m_Y));
+        }
+
+        Oracle_ExposeGej_N(pOracle + 1, pGej, n);
+
+        UintBig pHv[2];
+        Oracle_NextHash(pOracle, pHv);
+        Oracle_NextHash(pOracle + 1, pHv + 1);
+        verify_test(!memcmp(pHv, pHv + 1, sizeof(pHv[0])));
+    }
+}
+
+static void TestSha256Lanes()
+{
+#ifdef BeamCrypto_Sha256Accel
+
+    // multi-buffer compression must be bit-exact with the portable one, including the lanes sharing a state (padding)
+    Sha256_TransformLanes_t pfn = Sha256Accel_GetLanes();
+    if (!pfn)
+    {
+        printf("SHA-256: no multi-buffer implementation on this CPU, skipped\n");
+        return;
+    }
+
+    Sha256_Transform_t pfnSingle = g_pfnSha256Transform;
+    g_pfnSha256Transform = 0;
+
+    for (uint32_t iCase = 0; iCase < 100; iCase++)
+    {
+        uint32_t pState[c_Sha256_Lanes][8], pStateRef[c_Sha256_Lanes][8];
+        uint8_t pBlock[c_Sha256_Lanes][64];
+        uint32_t* ppState[c_Sha256_Lanes];
+        const uint8_t* ppBlock[c_Sha256_Lanes];
+
+        uint32_t nLanes = 1 + iCase % c_Sha256_Lanes;
+
+        for (uint32_t iLane = 0; iLane < c_Sha256_Lanes; iLane++)
+        {
+            for (uint32_t i = 0; i < 8; i++)
+                pState[iLane][i] = pStateRef[iLane][i] = (uint32_t) Rnd_Next();
+            for (uint32_t i = 0; i < sizeof(pBlock[iLane]); i++)
+                pBlock[iLane][i] = (uint8_t) Rnd_Next();
+
+            uint32_t iSrc = (iLane < nLanes) ? iLane : (nLanes - 1);
+            ppState[iLane] = pState[iSrc];
+            ppBlock[iLane] = pBlock[iSrc];
+        }
+
+        pfn(ppState, ppBlock);
+
+        for (uint32_t iLane = 0; iLane < nLanes; iLane++)
+        {
+            secp256k1_sha256_transform(pStateRef[iLane], pBlock[iLane]);
+            verify_test(!memcmp(pState[iLane], pStateRef[iLane], sizeof(pState[iLane])));
+        }
+    }
+
+    g_pfnSha256Transform = pfnSingle;
+
+#endif // BeamCrypto_Sha256Accel
+}
+
+static void TestKdfBatch()
+{
+#ifdef BeamCrypto_Sha256Accel
+
+    // batched derivations must give the same results as the single ones, with and without the multi-buffer compression
+    Sha256_TransformLanes_t pfnSel = g_pfnSha256TransformLanes;
+
+    for (uint32_t iImpl = 0; iImpl < 2; iImpl++)
+    {
+        g_pfnSha256TransformLanes = iImpl ? Sha256Accel_GetLanes() : 0;
+        if (iImpl && !g_pfnSha256TransformLanes)
+            break;
+
+        Kdf kdf;
+        UintBig seed;
+        Rnd_UintBig(&seed);
+        Kdf_Init(&kdf, &seed);
+
+        for (uint32_t n = 1; n <= c_Sha256_Lanes; n++)
+        {
+            CoinID pCid[c_Sha256_Lanes];
+            const CoinID* ppCid[c_Sha256_Lanes];
+            UintBig pHv[c_Sha256_Lanes], pSecret[c_Sha256_Lanes];
+            UintBig* ppHv[c_Sha256_Lanes];
+            const UintBig* ppHv_c[c_Sha256_Lanes];
+            const UintBig* ppSecret[c_Sha256_Lanes];
+            Kdf pKdf[c_Sha256_Lanes];
+            Kdf* ppKdf[c_Sha256_Lanes];
+            uint32_t pChild[c_Sha256_Lanes];
+            secp256k1_scalar pK[c_Sha256_Lanes];
+            secp256k1_scalar* ppK[c_Sha256_Lanes];
+
+            for (uint32_t i = 0; i < n; i++)
+            {
+                // different Num lengths, the hashes have different amounts pending
+                pCid[i].m_Idx = Rnd_Next() >> (Rnd_Next() % 64);
+                pCid[i].m_Type = (uint32_t) Rnd_Next();
+                pCid[i].m_SubIdx = (uint32_t) Rnd_Next() >> (Rnd_Next() % 32);
+                pCid[i].m_Amount = Rnd_Next() >> (Rnd_Next() % 64);
+                pCid[i].m_AssetID = (Rnd_Next() % 2) ? (uint32_t) Rnd_Next() : 0;
+                pChild[i] = CoinID_getSubkey(pCid + i); // the children are for the coins
+                Rnd_UintBig(pSecret + i);
+
+                ppCid[i] = pCid + i;
+                ppHv[i] = pHv + i;
+                ppHv_c[i] = pHv + i;
+                ppSecret[i] = pSecret + i;
+                ppKdf[i] = pKdf + i;
+                ppK[i] = pK + i;
+            }
+
+            CoinID_getHash_N(ppCid, ppHv, n);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                UintBig hv;
+                CoinID_getHash(pCid + i, &hv);
+                verify_test(!memcmp(hv.m_pVal, pHv[i].m_pVal, sizeof(hv.m_pVal)));
+            }
+
+            KdfRaw_Derive_PKey_N(ppSecret, ppHv_c, ppK, n);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                Kdf kdfRaw;
+                kdfRaw.m_Secret = pSecret[i];
+
+                secp256k1_scalar k;
+                Kdf_Derive_PKey(&kdfRaw, pHv + i, &k);
+                verify_test(secp256k1_scalar_eq(&k, pK + i));
+            }
+
+            Kdf_getChild_N(ppKdf, pChild, &kdf, n);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                Kdf kdfC;
+                Kdf_getChild(&kdfC, pChild[i], &kdf);
+                verify_test(!memcmp(kdfC.m_Secret.m_pVal, pKdf[i].m_Secret.m_pVal, sizeof(kdfC.m_Secret.m_pVal)));
+                verify_test(secp256k1_scalar_eq(&kdfC.m_kCoFactor, &pKdf[i].m_kCoFactor));
+            }
+
+            CoinID_getSkChild_N((const Kdf* const*) ppKdf, ppCid, ppK, n);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                secp256k1_scalar k;
+                CoinID_getSkComm(&kdf, pCid + i, &k, 0);
+                verify_test(secp256k1_scalar_eq(&k, pK + i));
+
+                CoinID_getSkCommChild(pKdf + i, pCid + i, &k, 0);
+                verify_test(secp256k1_scalar_eq(&k, pK + i));
+            }
+        }
+    }
+
+    g_pfnSha256TransformLanes = pfnSel;
+
+#endif // BeamCrypto_Sha256Accel
+}
+
+static void TestCreateOutputs()
+{
+    // the batch must give the same results as the separate CreateOutput, also when the request and the response share the buffer
+    UintBig seed;
+    Rnd_UintBig(&seed);
+
+    KeyKeeper kk;
+    memset(&kk, 0, sizeof(kk));
+    Kdf_Init(&kk.m_MasterKey, &seed);
+
+#define nCoins c_KeyKeeper_CreateOutputs_MaxCount // as many as fit the response. A single chunk, one per coin on the Nano S
+    static uint8_t pBuf[sizeof(Proto_In_CreateOutputs) + sizeof(CreateOutputs_In) * nCoins + 8];
+
+    for (uint32_t iCase = 0; iCase < 2; iCase++)
+    {
+        Proto_In_CreateOutputs* pIn = (Proto_In_CreateOutputs*) (pBuf + 5); // the response precedes, as with the APDU
+        CreateOutputs_In* pRec = (CreateOutputs_In*) (pIn + 1);
+
+        pIn->m_OpCode = g_Proto_Code_CreateOutputs;
+        pIn->m_Count = nCoins;
+
+        CreateOutputs_Out pRef[nCoins];
+
+        for (uint32_t i = 0; i < nCoins; i++)
+        {
+            CoinID cid;
+            memset(&cid, 0, sizeof(cid));
+            cid.m_Idx = Rnd_Next();
+            cid.m_Type = 0x22;
+            cid.m_SubIdx = (uint32_t) (i % 3);
+            cid.m_Amount = Rnd_Next() >> 20;
+            cid.m_AssetID = iCase ? (AssetID) (i % 3) * 7 : 0; // mixed assets, repeated ones too
+
+            Proto_In_CreateOutput req;
+            req.m_OpCode = g_Proto_Code_CreateOutput;
+            req.m_Cid = cid;
+
+            if (cid.m_AssetID)
+                Test_GetPoint(&kk, &req.m_ptAssetGen); // each output has its own blinded generator
+            else
+                memset(&req.m_ptAssetGen, 0, sizeof(req.m_ptAssetGen));
+
+            if (1 & i)
+            {
+                Rnd_UintBig(req.m_pKExtra);
+                Rnd_UintBig(req.m_pKExtra + 1);
+            }
+            else
+                memset(req.m_pKExtra, 0, sizeof(req.m_pKExtra));
+
+            Test_GetPoint(&kk, req.m_pT);
+            Test_GetPoint(&kk, req.m_pT + 1);
+
+            memcpy(&pRec[i].m_Cid, &req.m_Cid, sizeof(req.m_Cid));
+            memcpy(pRec[i].m_pKExtra, req.m_pKExtra, sizeof(req.m_pKExtra));
+            memcpy(pRec[i].m_pT, req.m_pT, sizeof(req.m_pT));
+            memcpy(&pRec[i].m_ptAssetGen, &req.m_ptAssetGen, sizeof(req.m_ptAssetGen));
+
+            Proto_Out_CreateOutput res;
+            uint32_t nOut = sizeof(res);
+            verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kk, (const uint8_t*) &req, sizeof(req), (uint8_t*) &res, &nOut));
+
+            memcpy(pRef[i].m_pT, res.m_pT, sizeof(res.m_pT));
+            pRef[i].m_TauX = res.m_TauX;
+        }
+
+        uint32_t nIn = sizeof(*pIn) + sizeof(CreateOutputs_In) * nCoins;
+
+        uint32_t nOut = sizeof(pBuf);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kk, (const uint8_t*) pIn, nIn, pBuf, &nOut));
+        verify_test(sizeof(Proto_Out_CreateOutputs) + sizeof(pRef) == nOut);
+        verify_test(!memcmp(pBuf + sizeof(Proto_Out_CreateOutputs), pRef, sizeof(pRef)));
+    }
+#undef nCoins
+}
+
+static void TestGetImages()
+{
+    // the batch must give the same results as the separate GetImage, also when the request and the response share the buffer
+    UintBig seed;
+    Rnd_UintBig(&seed);
+
+    KeyKeeper kk;
+    memset(&kk, 0, sizeof(kk));
+    Kdf_Init(&kk.m_MasterKey, &seed);
+
+#define nImages c_KeyKeeper_GetImages_MaxCount // as many as fit the response. A single chunk, one per image on the Nano S
+    static uint8_t pBuf[sizeof(Proto_Out_GetImages) + sizeof(GetImages_Out) * nImages];
+
+    Proto_In_GetImages* pIn = (Proto_In_GetImages*) (pBuf + 5); // the response precedes, as with the APDU
+    GetImages_In* pRec = (GetImages_In*) (pIn + 1);
+
+    pIn->m_OpCode = g_Proto_Code_GetImages;
+    pIn->m_Count = nImages;
+
+    GetImages_Out pRef[nImages];
+
+    for (uint32_t i = 0; i < nImages; i++)
+    {
+        Proto_In_GetImage req;
+        req.m_OpCode = g_Proto_Code_GetImage;
+        Rnd_UintBig(&req.m_hvSrc);
+        req.m_iChild = (uint32_t) (Rnd_Next() % 4); // repeated children
+        req.m_bG = (i % 3) != 1;
+        req.m_bJ = (i % 3) != 0;
+
+        pRec[i].m_hvSrc = req.m_hvSrc;
+        pRec[i].m_iChild = req.m_iChild;
+        pRec[i].m_bG = req.m_bG;
+        pRec[i].m_bJ = req.m_bJ;
+
+        Proto_Out_GetImage res;
+        uint32_t nOut = sizeof(res);
+        verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kk, (const uint8_t*) &req, sizeof(req), (uint8_t*) &res, &nOut));
+
+        pRef[i].m_ptImageG = res.m_ptImageG;
+        pRef[i].m_ptImageJ = res.m_ptImageJ;
+    }
+
+    uint32_t nIn = sizeof(*pIn) + sizeof(GetImages_In) * nImages;
+
+    {
+        // neither image requested
+        pRec[nImages - 1].m_bG = 0;
+        pRec[nImages - 1].m_bJ = 0;
+
+        uint32_t nOut = sizeof(pBuf);
+        verify_test(c_KeyKeeper_Status_Ok != KeyKeeper_Invoke(&kk, (const uint8_t*) pIn, nIn, pBuf, &nOut));
+
+        pRec[nImages - 1].m_bG = ((nImages - 1) % 3) != 1;
+        pRec[nImages - 1].m_bJ = ((nImages - 1) % 3) != 0;
+    }
+
+    uint32_t nOut = sizeof(pBuf);
+    verify_test(c_KeyKeeper_Status_Ok == KeyKeeper_Invoke(&kk, (const uint8_t*) pIn, nIn, pBuf, &nOut));
+    verify_test(sizeof(pBuf) == nOut);
+    verify_test(!memcmp(pBuf + sizeof(Proto_Out_GetImages), pRef, sizeof(pRef)));
+#undef nImages
+}
+
+int main()
+{
+    TestMultiMacBuckets();
+    TestMultiMacGlv();
+    TestComb();
+    TestRangeproofBytes();
+    TestSignature();
+    TestNonceGenerator();
+    TestCaches();
+    TestOracleGej();
+    TestSha256();
+    TestSha256Lanes();
+    TestKdfBatch();
+    TestCreateOutputs();
+    TestGetImages();
+
+    if (g_Failed)
+    {
+        printf("%u test(s) failed\n", g_Failed);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
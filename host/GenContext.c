@@ -0,0 +1,1141 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generator of the g_ContextBuf tables in context.c, from the compact base points.
+// Usage: beamhw_gencontext [--external] [--rangeproof <bits>] [--h <bits>] [--secure <bits>] [--comb <teeth> <spacing>] [--bytes | --no-bytes] [--verify | --no-verify]
+//   prints the whole g_ContextBuf contents. The defaults are the compiled ones (multimac.h with the build definitions).
+//   --external   the BeamCrypto_ExternalGej layout (affine points only, the window options are ignored)
+//   --verify     the G odds for BeamCrypto_FastVerify
+// Usage: beamhw_gencontext --salts
+//   prints hmac_salts.h, the HMAC midstates of the constant NonceGenerator salts
+//
+// Built with GenContext_Check (beamhw_gencontext_check) it's linked to hw_crypto instead, and verifies:
+//   - the compiled-in g_ContextBuf is exactly what the generator produces for the compiled configuration
+//   - tables of all the supported widths give correct results through MultiMac
+//   - the compiled-in salt midstates
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hw_crypto/multimac.h"
+#include "hw_crypto/noncegen.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "secp256k1/src/group_impl.h"
+#include "secp256k1/src/scalar_impl.h"
+#include "secp256k1/src/field_impl.h"
+#include "secp256k1/src/int128_impl.h"
+#include "secp256k1/src/hash_impl.h"
+#pragma GCC diagnostic pop
+
+#ifndef _countof
+#	define _countof(arr) sizeof(arr) / sizeof((arr)[0])
+#endif // _countof
+
+#define c_GenContext_nBitsMax 6 // MultiMac_WNaf element encoding limit
+
+// x-coordinates of the base points, all with even y
+static const uint8_t g_pX_G[] = {
+    0x79,0xbe,0x66,0x7e,0xf9,0xdc,0xbb,0xac,0x55,0xa0,0x62,0x95,0xce,0x87,0x0b,0x07,
+    0x02,0x9b,0xfc,0xdb,0x2d,0xce,0x28,0xd9,0x59,0xf2,0x81,0x5b,0x16,0xf8,0x17,0x98,
+};
+
+static const uint8_t g_pX_J[] = {
+    0x7b,0x13,0x62,0x0b,0x2f,0x0d,0xe2,0xa1,0xc4,0xe0,0xc0,0x5f,0x9d,0x1a,0xa7,0x19,
+    0x2a,0xd1,0x2b,0x70,0xe7,0x92,0xd6,0x87,0xf3,0xad,0xea,0x5a,0x11,0xe4,0x96,0x31,
+};
+
+static const uint8_t g_pX_H[] = {
+    0xea,0xa7,0x8a,0xca,0xbb,0x19,0x57,0x94,0x8c,0x82,0x69,0x1f,0x1e,0xf2,0x6f,0x68,
+    0xa0,0xbd,0xb0,0x87,0x2e,0x6d,0x8d,0xc7,0xa0,0x63,0x95,0x6a,0x4d,0x20,0xb9,0x26,
+};
+
+// Nums offset of the 'secure' and comb tables
+static const uint8_t g_pX_Nums[] = {
+    0x63,0x8e,0xca,0x74,0xf9,0xb0,0x65,0xfc,0x9e,0x0b,0xde,0x3a,0xd8,0xe1,0x4e,0xc0,
+    0x11,0x1a,0x2e,0x2e,0xa5,0x8f,0x7a,0xcf,0xdf,0xe8,0xf4,0xd8,0x12,0x0b,0xcc,0x2d,
+};
+
+// rangeproof generators, G_i then H_i
+static const uint8_t g_pX_Rangeproof[128][32] = {
+    {
+        0x29,0x24,0x4d,0x10,0x2a,0x55,0x78,0xf8,0x3b,0x74,0x4f,0xf4,0x5f,0x5c,0x82,0x0b,
+        0x65,0xe9,0xd1,0x8a,0x3d,0x37,0xab,0x60,0x95,0xf6,0xc3,0xf8,0xf0,0x37,0xc7,0x39,
+    },
+    {
+        0x02,0xd6,0xb4,0x4a,0x4b,0x1f,0xe0,0x01,0xfc,0xa8,0xdd,0xd1,0xac,0xf2,0x6e,0x7b,
+        0xdd,0xfa,0x17,0xa3,0x8b,0x1f,0x86,0x8a,0x90,0xdc,0x48,0x43,0x72,0xe6,0x7a,0x24,
+    },
+    {
+        0x70,0xad,0x43,0xc6,0x42,0xe7,0x9e,0xf7,0x53,0x7a,0x66,0x3b,0x00,0x4a,0x18,0xae,
+        0x4f,0x45,0x56,0xf2,0x66,0x77,0x23,0x67,0xd5,0x94,0x96,0xfe,0x9c,0x37,0x4b,0xd9,
+    },
+    {
+        0x5c,0x71,0xd3,0xca,0x24,0x16,0xb2,0xa2,0xcb,0xa8,0x4e,0xad,0x18,0xa3,0xd1,0x1b,
+        0xb8,0xdc,0xab,0xe7,0x86,0x64,0x96,0x5b,0xe0,0xc6,0xa7,0xe7,0x1d,0xb0,0xd3,0x3d,
+    },
+    {
+        0xe1,0x2a,0x03,0xaa,0x18,0xb7,0xeb,0x8b,0xca,0x12,0x90,0x2f,0x59,0x94,0xf4,0x08,
+        0x78,0xc3,0x3c,0x7d,0x59,0x3e,0xbf,0xbf,0x42,0x19,0xdd,0xe7,0xa8,0xef,0x94,0xe5,
+    },
+    {
+        0xbc,0x2c,0x2a,0x14,0x11,0x32,0xc4,0x7c,0xa2,0x4d,0x8c,0x43,0x64,0x52,0xb7,0x5f,
+        0x2a,0x00,0xe5,0xac,0x73,0x86,0x07,0x32,0x3d,0x57,0xaa,0x30,0x17,0x9c,0x4c,0x6d,
+    },
+    {
+        0x67,0xf5,0xb7,0x82,0xa3,0x7d,0x97,0xba,0x7b,0xd8,0xd8,0x05,0xa2,0x12,0xe9,0xbf,
+        0xb0,0x70,0xe3,0xc9,0xc2,0x5f,0x78,0x75,0x60,0x4c,0x88,0xc3,0x0a,0x3d,0xe6,0xb3,
+    },
+    {
+        0x82,0xc2,0xb4,0xf8,0xdd,0x3c,0x7d,0x6c,0xcd,0x42,0x5e,0x14,0xe9,0x62,0xfc,0xfb,
+        0xf4,0x15,0x57,0x82,0x53,0x51,0xea,0x93,0x97,0xce,0xfe,0x80,0x7d,0x50,0x4f,0xcc,
+    },
+    {
+        0x60,0xaa,0x91,0x8c,0xa5,0x6a,0x43,0x53,0x5b,0x7f,0x12,0xc3,0xbd,0x99,0x9c,0x17,
+        0xbc,0xfe,0xf4,0xe8,0x1e,0x64,0xc0,0x6e,0xac,0xcb,0x71,0xa0,0x88,0x55,0xa8,0x3d,
+    },
+    {
+        0x91,0x1b,0x5b,0xb1,0xac,0x1b,0x0f,0xba,0x3c,0x62,0x30,0x86,0xc3,0xa5,0x49,0x7f,
+        0x98,0xfb,0x5e,0x44,0xcc,0xd1,0xc1,0x55,0x0a,0xeb,0x5f,0xea,0x43,0xcc,0x9c,0x30,
+    },
+    {
+        0x7f,0x9f,0xce,0x42,0xa9,0xcb,0x19,0x83,0xde,0x67,0xcf,0x67,0x89,0x44,0x05,0x2a,
+        0xeb,0xf6,0xb7,0xc8,0xe5,0xd0,0x93,0xd4,0x8e,0x1b,0x26,0x6c,0xc2,0xc4,0xbd,0xfa,
+    },
+    {
+        0xe6,0x63,0xdc,0xa3,0xc3,0x4d,0x2b,0x12,0xfe,0xb3,0xd8,0xe3,0x4e,0xab,0xe1,0x3c,
+        0x3b,0x06,0x52,0x77,0xfb,0xb2,0xb7,0x60,0xe9,0xf3,0x6f,0x46,0xac,0x2a,0x15,0x17,
+    },
+    {
+        0xeb,0xf7,0xd9,0xd1,0x29,0x09,0xd3,0x77,0xa6,0x03,0xf2,0xd2,0xbe,0x7d,0xb1,0xb1,
+        0x89,0x86,0x8a,0xdf,0x0a,0xc8,0x35,0x46,0x92,0xd5,0xc6,0xac,0x32,0x43,0x87,0x84,
+    },
+    {
+        0x55,0x6e,0x88,0x73,0xc2,0x74,0xf0,0xc0,0x26,0x8b,0xf9,0x07,0x89,0xcf,0x9b,0x59,
+        0xe3,0xee,0x1e,0xed,0xdd,0xdd,0x2f,0xcb,0x82,0x41,0x07,0x94,0x45,0xd6,0x45,0x6c,
+    },
+    {
+        0x0b,0x5d,0xf0,0x2f,0xd4,0xec,0x8f,0x33,0xba,0x06,0x89,0xd1,0x83,0xfa,0x7a,0x60,
+        0xab,0x5d,0x68,0xc1,0xa7,0x95,0xc0,0x2e,0xac,0xcc,0xac,0x2c,0x01,0xaf,0xb1,0x43,
+    },
+    {
+        0xea,0x54,0xc5,0x98,0x1f,0x3e,0xc8,0xcf,0xca,0xe3,0xb6,0x0f,0x5e,0x62,0xe4,0x72,
+        0x5a,0x82,0xeb,0x08,0x4d,0x9a,0xae,0xf4,0xa0,0x18,0x94,0x8b,0x21,0x93,0xf0,0xcc,
+    },
+    {
+        0x21,0xb4,0x37,0x8a,0x73,0x15,0xb7,0xc8,0xfb,0xcc,0xd2,0xf2,0x23,0x97,0x09,0xdd,
+        0x84,0x5a,0xbb,0x53,0x14,0xda,0xa9,0xbf,0x88,0x23,0x60,0x9b,0xb6,0xfc,0x5a,0xfb,
+    },
+    {
+        0x63,0x74,0xf7,0x17,0xb9,0x0c,0x75,0xd2,0x24,0x07,0x0f,0xab,0xe8,0x97,0xbc,0xf9,
+        0xf7,0xa2,0xc3,0xdb,0xa2,0x84,0xbf,0x33,0xfc,0xa6,0x6d,0x67,0xc5,0x35,0x20,0x6e,
+    },
+    {
+        0x6a,0xc0,0x84,0x81,0x2f,0x8e,0x79,0xd1,0x0d,0x6f,0x72,0x9c,0x3a,0xcc,0x4b,0xd3,
+        0x1c,0x9d,0x03,0xba,0x52,0x66,0xc7,0x80,0x01,0xe2,0x42,0x54,0x32,0xb2,0x49,0x9d,
+    },
+    {
+        0x90,0x8b,0x6c,0xdc,0x9d,0xb7,0xc4,0x52,0x05,0x89,0x9f,0x7b,0xb1,0x12,0x8c,0x44,
+        0xd3,0x51,0x89,0x78,0xe9,0x43,0x1c,0x05,0xae,0xcd,0x8c,0x14,0x57,0x42,0x74,0xa5,
+    },
+    {
+        0x04,0xc6,0x6c,0xd7,0x5b,0xc7,0xa9,0x64,0xb3,0x0f,0x1e,0xe8,0x2c,0x76,0xd3,0x51,
+        0x99,0x58,0x6c,0x6a,0x4a,0xe5,0x89,0xbf,0xed,0x10,0x7f,0x94,0x6e,0x0b,0xd3,0xc6,
+    },
+    {
+        0x84,0xa3,0x6e,0x9b,0xcf,0xfd,0x5e,0x54,0x28,0xce,0xcd,0xb1,0x59,0x53,0xfd,0x15,
+        0xa6,0x04,0x12,0x38,0x2d,0x5d,0x36,0xad,0xe7,0xfc,0xd1,0xb6,0xda,0x33,0x60,0xce,
+    },
+    {
+        0x53,0xdd,0xd7,0x95,0x58,0x64,0x32,0xb2,0x3f,0xa2,0x65,0x86,0x1a,0x0c,0x25,0x9f,
+        0xed,0x71,0x2a,0x85,0xa9,0x7c,0xa7,0xb1,0x56,0x8f,0x54,0x65,0xb8,0x91,0x21,0xfe,
+    },
+    {
+        0x12,0xd2,0x69,0xcb,0x95,0x2b,0x1b,0x50,0xbf,0xe3,0x5f,0xeb,0x9e,0x7f,0x70,0x9b,
+        0x68,0xee,0xb4,0x35,0x43,0x08,0xa9,0xa6,0x7a,0x35,0x7a,0x0d,0xa5,0xf6,0xe0,0xa9,
+    },
+    {
+        0xb0,0xbd,0x44,0x30,0x3e,0x8f,0xdd,0x3c,0x5a,0xdc,0xa1,0x3b,0x90,0x62,0xd0,0x7b,
+        0x24,0x66,0x07,0x9d,0x2e,0x6c,0x31,0xb1,0x14,0xa4,0x43,0x36,0xed,0x43,0xca,0x93,
+    },
+    {
+        0x3e,0x3e,0x09,0xd6,0x6a,0x75,0x06,0xb0,0xda,0x5b,0xb2,0x61,0x95,0xa0,0x1f,0xfa,
+        0x00,0xe4,0xac,0x59,0x3d,0xd7,0xa3,0x96,0xfa,0x36,0xe4,0x74,0x39,0x1c,0x68,0x8b,
+    },
+    {
+        0xcc,0x4f,0x63,0x80,0xa9,0x92,0x23,0x2f,0x31,0x74,0xd7,0x9b,0xbe,0xb2,0x1e,0x74,
+        0x31,0x8d,0x68,0x58,0x7b,0x08,0x00,0xf1,0x9a,0xcf,0x0f,0xd4,0x04,0xb1,0xd4,0x36,
+    },
+    {
+        0xdb,0x87,0x12,0x84,0x72,0x77,0x6b,0xe9,0x99,0xd5,0x47,0x02,0x01,0xda,0xad,0xc1,
+        0xf4,0x67,0xd6,0x75,0xa5,0x47,0xf9,0x26,0xb5,0xa7,0xb0,0x2b,0x8d,0x92,0x13,0x35,
+    },
+    {
+        0x8b,0x43,0x65,0xe5,0x36,0x26,0x63,0xdd,0xa7,0x07,0x19,0x42,0xd0,0xf2,0x04,0x37,
+        0x2e,0x1c,0x82,0xca,0xc6,0x3e,0xb6,0xa0,0x95,0x0b,0x77,0x24,0x8d,0xf3,0x81,0xff,
+    },
+    {
+        0x66,0xb3,0x43,0x86,0x7d,0x8b,0x03,0xf9,0xdb,0x9e,0xf6,0x6e,0xb2,0xbd,0x84,0xd7,
+        0x07,0x3e,0xdb,0x43,0xc8,0xd0,0xd8,0xdd,0x12,0x82,0xe6,0x25,0x82,0xa4,0x10,0xe2,
+    },
+    {
+        0xe6,0x52,0x82,0x43,0x00,0x93,0x1a,0x89,0x62,0x20,0x10,0x51,0x6a,0xdb,0x4c,0x9a,
+        0xce,0x4f,0x96,0xe4,0x1a,0xb3,0xab,0xe5,0x64,0x10,0xec,0xe3,0x02,0x8d,0x51,0x0e,
+    },
+    {
+        0x5a,0xde,0xa3,0xb5,0xea,0x12,0x7b,0xae,0x9e,0x2b,0x16,0x8e,0xe0,0xab,0x67,0x3b,
+        0xdd,0xaf,0x8f,0xb0,0x6c,0x16,0xcf,0x9d,0xf5,0x56,0x4b,0xf1,0x70,0x70,0xae,0xd8,
+    },
+    {
+        0x85,0xdd,0xc5,0xa6,0x8b,0xd4,0x66,0xa9,0x5a,0x93,0x01,0xb8,0x30,0x35,0x75,0x43,
+        0xae,0x76,0xa1,0xae,0x6c,0x6b,0xd9,0xe4,0x1a,0x30,0xcc,0x45,0x93,0x05,0xd9,0x43,
+    },
+    {
+        0x90,0xe0,0xf9,0xb1,0x9c,0x26,0x71,0x9e,0xc1,0x42,0xf7,0xff,0x24,0x83,0x25,0x6a,
+        0x7b,0xeb,0x41,0xd5,0x5c,0x7e,0x9c,0x59,0xec,0x53,0xb3,0x99,0x10,0xb2,0xae,0x59,
+    },
+    {
+        0xc0,0x83,0x6a,0x0e,0x34,0x53,0x45,0x06,0x15,0x78,0x89,0x73,0x8e,0x12,0xb0,0xa5,
+        0x36,0xb3,0xee,0xed,0x04,0x2b,0x34,0xa7,0xb7,0x43,0x9b,0xb2,0x85,0x05,0x3e,0xdf,
+    },
+    {
+        0xa1,0x8c,0xd7,0x75,0x11,0xda,0xc1,0x7a,0xa2,0x9c,0x4e,0x82,0xdf,0x2c,0xa8,0xc2,
+        0x37,0x55,0x18,0xad,0xae,0x3b,0xa4,0xa7,0xe6,0x75,0x34,0x64,0xf6,0x52,0x2d,0xad,
+    },
+    {
+        0x2e,0xdf,0xdd,0x6f,0x5e,0x25,0x65,0xfe,0xe3,0xda,0x37,0xf7,0xd0,0x1d,0x50,0xff,
+        0x86,0x3b,0x18,0x93,0xdb,0x05,0xf9,0x3f,0xb2,0xa5,0x28,0x99,0x3a,0xe7,0x67,0x09,
+    },
+    {
+        0x7d,0x54,0xe3,0x94,0xa0,0x18,0x3f,0x13,0x93,0x11,0xc1,0xba,0x3e,0xfb,0xda,0xbc,
+        0x8a,0x94,0xd6,0xaa,0x30,0x55,0xfb,0x0c,0xd3,0xc4,0xd5,0x34,0x8e,0x77,0x39,0x6e,
+    },
+    {
+        0xa5,0x10,0x49,0xa3,0x26,0x2b,0x65,0x23,0xab,0xf6,0xbb,0xa2,0x34,0x1b,0xf4,0x9c,
+        0xae,0xbb,0xdb,0xf5,0xd6,0x67,0x3d,0x93,0x82,0x8c,0xdb,0xa8,0x2c,0x25,0x31,0x72,
+    },
+    {
+        0xfe,0x10,0x61,0x5e,0x57,0xba,0x6b,0xd8,0xf6,0xcf,0xe2,0xef,0x8e,0xe8,0x0d,0xc9,
+        0x4d,0xe9,0x27,0xf5,0xb0,0x22,0xcc,0xbd,0x88,0x53,0x8e,0x7f,0x8e,0xa7,0xf4,0x2d,
+    },
+    {
+        0xef,0x55,0xc1,0x90,0x35,0x55,0xfc,0x9d,0xd2,0x07,0x7a,0xc9,0xba,0x11,0x37,0x01,
+        0xb0,0x08,0x72,0x85,0x02,0xb5,0x7b,0xb8,0x91,0x46,0xf9,0x0b,0x98,0x3e,0x64,0xf9,
+    },
+    {
+        0x83,0x35,0x36,0x23,0x9a,0x64,0x68,0xa3,0x33,0x08,0x9c,0xd6,0xe9,0x28,0x88,0x23,
+        0xcd,0x4f,0xad,0x0a,0x7c,0x49,0x2f,0x34,0x13,0xb3,0x8c,0x67,0x6d,0xad,0xbc,0xa7,
+    },
+    {
+        0x5f,0x82,0x85,0x8f,0x3a,0xde,0xdd,0xbc,0x94,0x46,0x46,0x9b,0xa3,0x7e,0x1b,0x82,
+        0x86,0x9e,0xfc,0xb9,0xce,0xb8,0x10,0x75,0x67,0x3c,0xcb,0x72,0xf3,0xc3,0x86,0x44,
+    },
+    {
+        0x7f,0xb2,0xfa,0x49,0x6b,0x92,0xb8,0xf0,0xb3,0x9a,0xdd,0xb4,0xf3,0xe1,0xc1,0xa6,
+        0x9c,0xfc,0x28,0xe9,0x4e,0xf6,0x3d,0x89,0x37,0x39,0xdf,0xa8,0x8d,0x9d,0x75,0xfd,
+    },
+    {
+        0x17,0x3c,0x30,0xe5,0x19,0xe4,0xb6,0x4d,0x5b,0x5f,0x31,0x07,0x74,0xd9,0x98,0x22,
+        0xb5,0x55,0x08,0x29,0xd2,0x45,0xcf,0x5f,0x61,0x07,0x79,0xd8,0x44,0x7e,0x09,0xc2,
+    },
+    {
+        0x5b,0x0d,0xba,0xcf,0x20,0x36,0xec,0xbb,0x87,0xb1,0x45,0x10,0x82,0xac,0x2d,0x5c,
+        0xa6,0x8e,0x15,0xc5,0x8f,0x1d,0xe8,0xc0,0x1c,0x07,0xa8,0x47,0xd1,0xa8,0xb2,0x41,
+    },
+    {
+        0x1b,0x9e,0x78,0xc3,0xb7,0x77,0x31,0xa8,0xc0,0x1d,0x44,0xaf,0xf7,0x0f,0x22,0x52,
+        0xbe,0x90,0x52,0xb6,0xc1,0xf1,0x41,0xd9,0x6a,0x4d,0x9d,0x96,0x14,0xc6,0xba,0x39,
+    },
+    {
+        0xf7,0x75,0xc2,0xaa,0x90,0x95,0x67,0xb4,0x45,0x34,0x52,0x8f,0x50,0x43,0xe3,0x2a,
+        0xf3,0xf9,0x6f,0xfd,0x0e,0xfa,0x02,0x4f,0x9b,0x67,0x15,0xe9,0x7e,0xfd,0x88,0x1b,
+    },
+    {
+        0x2a,0xc9,0x58,0x6a,0xb4,0xc4,0x68,0xf7,0x62,0xd2,0xff,0xfa,0x20,0x5c,0xa4,0x38,
+        0x2f,0x6e,0x3f,0xe4,0xac,0xef,0xfc,0x16,0x98,0x57,0x14,0x1b,0x2a,0xd3,0x56,0xd4,
+    },
+    {
+        0xdb,0x0d,0xcf,0x1c,0x6a,0x87,0x9c,0xec,0xff,0x48,0x16,0x72,0xae,0x7c,0xd8,0xea,
+        0xa8,0x0f,0x7b,0xca,0xd3,0xb3,0xc4,0xa0,0x94,0xda,0xd1,0x5a,0x7b,0x9c,0xe8,0x1c,
+    },
+    {
+        0x78,0x3b,0x8e,0xc1,0x26,0x93,0x63,0x88,0x84,0x4b,0x10,0x83,0x6a,0xbb,0x4f,0xf3,
+        0x0f,0x19,0xe2,0xeb,0x67,0xc4,0xdb,0xfa,0x66,0x21,0x19,0x3a,0x98,0x04,0x29,0x37,
+    },
+    {
+        0x00,0x2c,0x9c,0xc6,0x25,0xac,0x8a,0xb3,0x9f,0xf8,0xe2,0xc1,0xdf,0xe6,0x1d,0xae,
+        0xc3,0x91,0x75,0xa6,0xfe,0xb7,0x5e,0x2c,0x3d,0x3c,0x93,0xd7,0xbd,0x9d,0x3a,0x6c,
+    },
+    {
+        0xa4,0x90,0x58,0x97,0xdc,0xd7,0x6c,0x2d,0xe7,0x36,0x65,0x6a,0x61,0x7e,0x51,0xf6,
+        0x89,0xf8,0x7e,0x6a,0x0d,0x01,0x6b,0xcb,0x8f,0x89,0xdc,0xb3,0xce,0x2d,0x74,0xe5,
+    },
+    {
+        0xe1,0xa4,0x7d,0xb4,0xcd,0xef,0xe4,0x29,0x0d,0xd8,0x5c,0x18,0x09,0xb6,0xca,0x53,
+        0x22,0xad,0xbf,0x7e,0x4b,0x80,0xd2,0xc7,0x75,0xa4,0x8f,0x1d,0x33,0xfa,0x77,0xc1,
+    },
+    {
+        0x1e,0x5c,0x61,0xe8,0x88,0xff,0x86,0x87,0x96,0xc3,0xef,0xfc,0x2a,0xd4,0x53,0xb2,
+        0x0f,0x7c,0xa7,0xd9,0xf5,0x8a,0x10,0x5f,0xe5,0xcc,0xe7,0x3a,0xf4,0xf0,0xca,0xe4,
+    },
+    {
+        0xda,0x67,0x55,0x19,0xe1,0xab,0xec,0x28,0x1f,0xa4,0xe1,0x09,0x2b,0x2b,0x85,0xab,
+        0x15,0xc3,0x8d,0x3a,0x72,0x9f,0xf5,0x10,0xee,0x48,0xaf,0xe4,0xf2,0x87,0x34,0xbb,
+    },
+    {
+        0x67,0x6f,0x14,0xf6,0x9b,0xfb,0x5a,0x83,0x9e,0xcc,0x63,0x65,0x1d,0x9d,0x6c,0x54,
+        0xae,0x0a,0x95,0xab,0x38,0x86,0x3c,0xf0,0x45,0x4b,0x1d,0xb2,0x45,0x3e,0xfd,0xec,
+    },
+    {
+        0x77,0x66,0xc5,0x1b,0xf0,0x22,0xd7,0x36,0x2d,0x73,0x87,0x90,0x77,0x6f,0x8f,0xd7,
+        0x8e,0x08,0x6d,0x9a,0xc0,0x3b,0xd5,0xd5,0x32,0xd3,0x2f,0x89,0x3b,0xae,0x7b,0x09,
+    },
+    {
+        0xbf,0x89,0xa3,0xbc,0x5b,0xfb,0x12,0xcd,0x6b,0x62,0xe9,0x31,0xb3,0x3b,0x61,0x26,
+        0x0d,0xd8,0x01,0xf9,0xa2,0xc6,0xd4,0x15,0x89,0xb3,0xfc,0x23,0x88,0xf7,0xc5,0x98,
+    },
+    {
+        0x20,0xfb,0x54,0xe5,0x78,0x41,0x62,0xc3,0xf8,0x40,0x35,0xae,0x66,0xfe,0x1a,0xb6,
+        0x83,0xf6,0x0f,0x45,0x52,0x1a,0x2b,0x9f,0x33,0xfe,0xb6,0xc4,0xa6,0x09,0x0b,0x86,
+    },
+    {
+        0x15,0x13,0x6f,0x1d,0xd4,0xf9,0xb5,0x66,0x8d,0xc5,0xea,0x7c,0x9e,0x09,0x66,0x90,
+        0x57,0xeb,0x30,0x9e,0x38,0x78,0xb4,0x71,0x0c,0x4d,0x38,0x0a,0x19,0x94,0x32,0x16,
+    },
+    {
+        0xe9,0x8c,0x8f,0xe8,0xe9,0xb2,0x21,0x10,0xd4,0x0e,0xb2,0x28,0x0f,0x40,0x40,0x47,
+        0x81,0x6e,0xe0,0x5d,0x9a,0x0c,0x10,0xcc,0xb0,0xa2,0x37,0xc2,0x59,0x24,0x2c,0x33,
+    },
+    {
+        0x08,0x13,0x64,0x6c,0x84,0xae,0x45,0x47,0xee,0x0b,0x61,0x9d,0xcb,0x95,0x85,0xb1,
+        0xd4,0x50,0x4c,0xef,0x35,0x44,0x25,0xa4,0xf5,0x4f,0xc0,0x34,0xa2,0xd6,0x6d,0x3d,
+    },
+    {
+        0x2b,0x78,0x4f,0xa1,0xca,0x4d,0xe5,0x55,0xb9,0xdd,0xa7,0x1e,0xa2,0xac,0x3c,0x79,
+        0xda,0x62,0x11,0x1c,0xb0,0xef,0xa9,0x58,0x31,0x15,0xb8,0x13,0xd9,0x47,0x57,0xe6,
+    },
+    {
+        0x00,0x77,0x79,0x4e,0xbe,0x03,0x32,0x8b,0xfb,0x60,0x44,0x52,0xba,0xf1,0xfe,0x2e,
+        0x95,0x4c,0x57,0xd0,0x79,0xff,0x49,0x54,0x42,0xa0,0x7d,0x9c,0x3e,0xb6,0xd7,0x72,
+    },
+    {
+        0xe3,0xbc,0x8e,0x53,0xfa,0x3a,0x3b,0x16,0x27,0x63,0xbe,0xcd,0x43,0xb4,0xe3,0xd5,
+        0xb6,0x0b,0x09,0x3c,0xb0,0x22,0x30,0x6d,0x57,0xdc,0xe3,0x6d,0x6e,0x77,0xf4,0x96,
+    },
+    {
+        0x1a,0xef,0xdd,0x9f,0x62,0xc2,0x80,0x36,0xc6,0x5a,0x32,0xd4,0x7e,0x5d,0x4f,0x6f,
+        0x4e,0x34,0x00,0x0a,0xc0,0x98,0x1a,0x98,0x85,0xfb,0xaa,0x82,0x10,0x5f,0x18,0x08,
+    },
+    {
+        0x66,0x0c,0x04,0x97,0x82,0x88,0xaa,0x0b,0xb4,0xdc,0x9d,0xcb,0xf7,0xd0,0x35,0xd3,
+        0x3b,0xa0,0x64,0x25,0xb1,0xec,0x33,0x1a,0x92,0xc5,0x68,0xe7,0xd7,0x05,0xcf,0x1f,
+    },
+    {
+        0x7b,0xba,0x15,0xbe,0x4d,0xa9,0x74,0x30,0xbb,0xdb,0x0f,0xc8,0xf1,0xd9,0x55,0xc5,
+        0x71,0xb7,0x6a,0x2a,0x21,0x18,0xee,0x76,0x0d,0x28,0xfe,0x5b,0x83,0xc2,0xf5,0xe9,
+    },
+    {
+        0x40,0x7d,0x64,0x4c,0x65,0x87,0x92,0x70,0x44,0x43,0x1b,0x01,0x98,0x4e,0x35,0xd9,
+        0x8c,0xf1,0xa7,0xf5,0x2c,0x3f,0x17,0x3e,0xe1,0x3d,0xfd,0xd6,0x57,0x59,0xc5,0x43,
+    },
+    {
+        0x6b,0xf1,0x2a,0xe5,0x9d,0xf2,0xd4,0x82,0xce,0x0c,0xb6,0x83,0xd3,0xa4,0xcd,0x33,
+        0x7c,0x9d,0x09,0xe1,0xa0,0x9e,0x8e,0x0b,0xca,0xf1,0xc7,0x30,0x13,0x2e,0x25,0x8e,
+    },
+    {
+        0x08,0xc5,0xc4,0x96,0xbb,0xee,0xa9,0xfc,0xf7,0xef,0xbc,0xa0,0xba,0x8e,0x86,0xd4,
+        0x23,0xfd,0x8c,0x7a,0x77,0x2e,0x4a,0xdf,0x2d,0x76,0xe2,0xcf,0x7a,0xef,0xd3,0xc4,
+    },
+    {
+        0x91,0x44,0xe2,0x09,0x7b,0xdc,0xcd,0xbb,0x26,0xde,0x62,0xa8,0x40,0x16,0x6d,0x7b,
+        0x57,0xda,0xe2,0xd3,0x04,0xc0,0xa7,0xdb,0x13,0xb1,0x48,0x1d,0x49,0x4a,0x17,0x9f,
+    },
+    {
+        0x20,0x35,0x53,0x7f,0x2a,0xc5,0x6c,0xe0,0x6f,0x33,0x19,0xf6,0x8c,0x1f,0x1b,0x0e,
+        0xdf,0x8c,0xd7,0xc7,0xa5,0xfc,0xa7,0xb7,0x75,0x63,0x34,0x8f,0x11,0x97,0x80,0x3a,
+    },
+    {
+        0x2c,0x73,0x37,0x85,0x23,0x1a,0x18,0x7a,0x3d,0xfe,0xa4,0x24,0xc1,0x89,0x83,0x3c,
+        0x49,0x8b,0x69,0xf1,0xd7,0xd9,0xcc,0x49,0x2f,0xaa,0x7e,0x90,0xbd,0x8e,0xdd,0xc1,
+    },
+    {
+        0x5c,0x71,0x0d,0x93,0x4e,0x9c,0x7b,0x14,0x38,0x2e,0xc1,0xd6,0x02,0xd1,0x10,0x7b,
+        0x9a,0xf3,0xb7,0xd8,0xdf,0x47,0x63,0x3e,0x0a,0x78,0x6e,0xca,0x4c,0x2e,0x2b,0xf5,
+    },
+    {
+        0xff,0xfb,0xfd,0x0b,0xca,0x99,0x96,0x85,0x40,0x72,0x63,0x90,0x6f,0x5d,0x3e,0xb6,
+        0x1b,0x6e,0x99,0xae,0xbd,0xf0,0x79,0xfe,0xaa,0xe0,0xf3,0x15,0xb0,0xaa,0x70,0x96,
+    },
+    {
+        0xcd,0xef,0xdc,0xa2,0xc7,0xa3,0x89,0x81,0xa9,0xd4,0xf5,0x28,0xf2,0xe0,0x9a,0xbe,
+        0x35,0xf2,0x07,0x4c,0x39,0xd0,0x72,0x33,0x17,0xdc,0xd9,0x99,0x72,0x4b,0x72,0x10,
+    },
+    {
+        0x41,0x84,0xc8,0xa3,0xbc,0xf8,0x3f,0x2f,0x45,0x5e,0xa2,0x33,0x0b,0x18,0x5b,0xe4,
+        0xee,0x1b,0xc7,0x87,0x11,0x0c,0x29,0x0c,0x61,0x39,0x27,0x5d,0xf5,0xf0,0x6d,0xcf,
+    },
+    {
+        0xdd,0xea,0xbc,0x32,0x98,0xa9,0xfe,0x20,0x68,0x0a,0x5b,0x91,0x78,0xcf,0x95,0xc3,
+        0xcf,0xe5,0x94,0x9d,0x72,0x04,0x3d,0xa4,0x8c,0xf2,0x97,0x5e,0xde,0xf9,0x7f,0x8d,
+    },
+    {
+        0x63,0x17,0xb7,0x4c,0x64,0xcc,0xa2,0xa9,0x72,0x48,0x7c,0x61,0xa5,0xf8,0xce,0x7c,
+        0x45,0xdf,0xdc,0x2a,0xb1,0xac,0x4d,0x43,0xd7,0xc3,0xe2,0x36,0xa6,0x82,0xfa,0xb6,
+    },
+    {
+        0xc4,0x06,0x81,0x10,0x80,0xf7,0x10,0x29,0x08,0x67,0x24,0xb6,0xfe,0x0e,0xed,0xcf,
+        0x8b,0x8a,0x31,0x32,0xaa,0x6a,0x4e,0x02,0x56,0xbb,0x43,0x00,0x27,0x81,0x04,0x0a,
+    },
+    {
+        0xca,0x7c,0xca,0x23,0xe7,0x5f,0x2e,0x30,0x9a,0xbb,0x6b,0x74,0x50,0xcb,0xf5,0x4e,
+        0xf4,0x80,0x9d,0xb0,0xd0,0x6c,0xf4,0x7a,0x99,0xc0,0x43,0xce,0x28,0x76,0xe7,0x1d,
+    },
+    {
+        0xea,0x01,0xde,0x8a,0x42,0xae,0xbe,0xf8,0x4c,0x7a,0x11,0xc3,0x85,0x54,0x6c,0x34,
+        0x7d,0xe3,0x1e,0xa4,0xd2,0x3d,0x20,0x89,0x77,0x02,0xda,0x8a,0xee,0x0e,0x00,0x3d,
+    },
+    {
+        0xf3,0x0e,0x68,0xec,0x8d,0x48,0x1a,0xb8,0x14,0xf3,0xfe,0xf8,0x35,0x0d,0xb2,0x7e,
+        0x91,0x36,0x0d,0x65,0x51,0x8e,0xd9,0x02,0x0c,0x05,0xe8,0x8b,0x76,0xdc,0x3a,0xec,
+    },
+    {
+        0x47,0x86,0x12,0x23,0x19,0x84,0xb7,0x5e,0xac,0x4a,0x54,0x77,0x11,0x20,0xa7,0x32,
+        0xb6,0x76,0x75,0x41,0xce,0xd7,0x3d,0x22,0x15,0x99,0xa8,0x8a,0x1f,0x4d,0x44,0x82,
+    },
+    {
+        0x1b,0x9e,0x8f,0x5f,0xb2,0xb7,0x69,0x5b,0x0a,0xdc,0xd1,0xfa,0x30,0x4d,0xed,0xe2,
+        0xe4,0xaa,0xf2,0x63,0x2a,0xfb,0xb0,0x70,0x83,0xbb,0x47,0x94,0xcb,0xad,0x64,0xc1,
+    },
+    {
+        0x0e,0xa2,0xed,0x3b,0x6f,0x88,0x06,0x76,0xe6,0x9d,0x6d,0x69,0xa7,0x93,0x8c,0xaa,
+        0x48,0xfa,0x2d,0xa5,0xbb,0xb4,0x1a,0x3c,0xb2,0x31,0x50,0xea,0xd8,0x5e,0xf3,0x22,
+    },
+    {
+        0x58,0x1e,0xd2,0x09,0xbf,0x8c,0xee,0x48,0x0a,0x71,0x04,0xfa,0x25,0xf0,0x3f,0xd1,
+        0x85,0xfc,0x9e,0x3e,0xb5,0x71,0x2d,0x6a,0x28,0x00,0xb6,0xc3,0xa4,0x89,0x59,0xb6,
+    },
+    {
+        0x76,0x09,0xba,0x82,0x78,0xa8,0xc3,0xeb,0x1a,0x04,0xb8,0xeb,0x0f,0x72,0xb0,0x99,
+        0x9e,0x9e,0xe8,0x54,0x12,0xff,0x74,0x54,0x71,0xcc,0x1d,0xc1,0x0f,0x3c,0x06,0xbe,
+    },
+    {
+        0xf7,0x8d,0x6a,0x1f,0x51,0xe7,0x40,0x84,0xb4,0xa4,0x20,0xf1,0x30,0xaa,0x9d,0xed,
+        0xc8,0xf8,0x31,0x90,0x62,0x2d,0xcc,0x9b,0xb7,0x9c,0x67,0x34,0x00,0xec,0x2e,0xfe,
+    },
+    {
+        0xf9,0xf2,0x52,0x61,0x43,0xcd,0x04,0x11,0x7d,0x64,0x86,0xce,0xfd,0x2d,0xa6,0x57,
+        0xc2,0x35,0x64,0xb5,0xd6,0x78,0x68,0xe5,0x0d,0xe2,0x48,0x20,0xb3,0x1d,0x36,0xe4,
+    },
+    {
+        0x55,0x4a,0xaf,0xb2,0x9a,0x25,0xde,0x36,0x23,0x9b,0xae,0xbf,0x2a,0x0a,0xb9,0x30,
+        0x98,0x63,0xab,0xd1,0xce,0x1a,0x18,0x94,0x47,0x38,0xfa,0xe8,0xcb,0x4b,0xd7,0x82,
+    },
+    {
+        0x8c,0x2f,0xcf,0x83,0xfa,0x12,0xb7,0xa9,0xfe,0x16,0x76,0xae,0x2d,0xd7,0x42,0x16,
+        0x22,0xe3,0x65,0x73,0xff,0x7a,0xae,0x67,0xbb,0xea,0x84,0x9e,0xb3,0x77,0xce,0x55,
+    },
+    {
+        0xf5,0x2e,0x25,0xb9,0x75,0x6c,0xb2,0x89,0x13,0x9c,0xb8,0xd8,0xec,0xe2,0xcb,0xa5,
+        0xaa,0x7b,0xcb,0xdb,0x5a,0xa1,0xc8,0x00,0xfa,0xff,0x33,0x50,0x08,0x96,0x7f,0x90,
+    },
+    {
+        0x02,0xbb,0xd8,0x2d,0x92,0xe5,0xd7,0x9e,0xf9,0xe5,0x71,0xb6,0x60,0x81,0x7a,0xea,
+        0xf3,0xff,0xd8,0xcc,0xa0,0x60,0x37,0x40,0xaa,0x0f,0x85,0x32,0x2d,0xe6,0x4e,0xa9,
+    },
+    {
+        0x82,0xda,0x49,0xca,0xcc,0x24,0xa8,0x36,0x12,0x89,0x51,0x4f,0xb7,0xf7,0xb1,0x6e,
+        0x64,0x36,0x14,0x42,0x99,0x82,0x44,0x58,0x68,0x09,0x0d,0xa7,0x73,0x43,0x9f,0xe0,
+    },
+    {
+        0x17,0x9a,0xd0,0x50,0xbd,0x74,0x09,0x76,0xb6,0x03,0x1a,0x51,0x0a,0xe2,0xe5,0x5f,
+        0x18,0x06,0xc0,0xea,0x77,0xd4,0xe5,0xa1,0x8d,0xee,0x47,0x6b,0x7c,0xf3,0x93,0xc5,
+    },
+    {
+        0xad,0x13,0x4a,0x51,0xdb,0x28,0xae,0x2b,0x25,0xef,0x16,0x3a,0x37,0x65,0x26,0xff,
+        0x64,0x3b,0x5a,0x0d,0xc1,0x0f,0x9b,0xfb,0xbb,0x83,0xd6,0x67,0x1d,0x02,0x62,0xd2,
+    },
+    {
+        0xb3,0x7d,0x9d,0x13,0x4b,0x33,0xe3,0x15,0xc4,0x02,0x7f,0x41,0xc1,0x7d,0xa0,0x82,
+        0xb4,0xe9,0x2f,0x65,0x66,0xfb,0xe7,0x2e,0x13,0x0f,0x02,0xed,0xaa,0xb4,0x03,0xcd,
+    },
+    {
+        0x5b,0x63,0xda,0xee,0x59,0x07,0xe6,0xd6,0xe9,0x8e,0x6b,0xe1,0x80,0x56,0x61,0x7b,
+        0xd5,0x43,0x40,0xf2,0x1d,0xed,0x23,0x6a,0x0e,0x3d,0x60,0x50,0x3e,0x28,0x36,0xd1,
+    },
+    {
+        0x16,0xd0,0x85,0xa8,0x98,0x21,0xfe,0xa7,0x90,0x25,0x5b,0xd1,0x79,0x4f,0x08,0x0b,
+        0x14,0xf0,0x6a,0x34,0x5c,0xcc,0x32,0x8f,0x96,0xe1,0x99,0x24,0x9f,0x65,0xb9,0x12,
+    },
+    {
+        0x79,0xea,0x3d,0x5a,0x26,0x1a,0x72,0x3b,0x5b,0x94,0x70,0x83,0x09,0x8f,0x50,0x53,
+        0x60,0xfe,0x6a,0xf5,0x9c,0xca,0x85,0x7f,0x2e,0x27,0xed,0xda,0x39,0x9a,0xee,0xd2,
+    },
+    {
+        0x0a,0x26,0xa8,0x54,0x49,0xa4,0x58,0xca,0xbf,0x41,0x0f,0xf6,0xdd,0xba,0xb5,0x84,
+        0xb3,0x12,0xc6,0xd0,0xf0,0x01,0x0c,0x89,0x32,0x66,0x60,0x8a,0xb3,0x67,0x71,0x1d,
+    },
+    {
+        0xfe,0x95,0x40,0x43,0xba,0x26,0x66,0xd5,0x9e,0xb0,0x0c,0x15,0xda,0xb1,0x9e,0x10,
+        0xa4,0xd6,0xb8,0xb6,0x18,0xbc,0xbc,0xc3,0xe1,0x5c,0x01,0x52,0x50,0x75,0x2c,0xc4,
+    },
+    {
+        0x2d,0x5a,0x1f,0x8f,0x64,0xdf,0xcd,0x7b,0x0e,0x81,0x81,0x49,0x2f,0x1b,0x29,0xb2,
+        0x1e,0x3a,0xf5,0xf6,0xe1,0x03,0x11,0x46,0xae,0xd5,0x37,0xc3,0x51,0xcc,0x42,0x6e,
+    },
+    {
+        0xc8,0xe8,0xa4,0x3b,0x17,0xb5,0xa5,0x40,0xa2,0x2e,0x44,0x67,0x61,0x31,0x73,0x9b,
+        0x2f,0xdd,0x18,0x6d,0x38,0xd6,0x7e,0x45,0x9a,0xa1,0xee,0xd4,0xce,0xc9,0x0d,0xbc,
+    },
+    {
+        0x75,0x1d,0x6d,0xb4,0xc9,0xcc,0xc2,0xa4,0x1d,0xff,0xa8,0xcf,0x5f,0x26,0x98,0x04,
+        0xc7,0x84,0x17,0x97,0xdf,0x2c,0x28,0xc3,0xb6,0x56,0x06,0x6a,0x06,0xcc,0xf9,0x18,
+    },
+    {
+        0x5e,0x51,0x04,0x3f,0x66,0x17,0xd0,0xc5,0xf3,0xde,0xb5,0xc4,0xba,0x6d,0xbb,0x05,
+        0x6b,0x7c,0x9f,0xd2,0xe9,0x66,0xf4,0xbf,0x4a,0xc1,0x17,0xc4,0xdb,0x90,0x74,0x2b,
+    },
+    {
+        0xdb,0xd0,0x5c,0x3e,0xb6,0x45,0x59,0x7e,0xa5,0xd9,0x97,0xfa,0x34,0x6a,0xbc,0x5c,
+        0x2f,0x91,0x93,0xc2,0x91,0xb6,0xf8,0x67,0xaf,0x8e,0xc7,0xa8,0x7b,0xe6,0x13,0x34,
+    },
+    {
+        0xb2,0xc3,0xeb,0x0d,0x88,0x5e,0x54,0xff,0x22,0x7e,0x8b,0x5f,0xf9,0x86,0x63,0xbd,
+        0xa5,0xbc,0xbe,0xfc,0x9e,0x38,0x2f,0x01,0x17,0xc8,0xa1,0x48,0x64,0xa7,0x3c,0x7b,
+    },
+    {
+        0x89,0x3a,0x9a,0xc0,0x4e,0x29,0x19,0x77,0x85,0x1e,0x85,0x19,0x7c,0x0c,0x01,0x3a,
+        0x21,0x95,0xb1,0x86,0xa1,0x6a,0xdc,0xd3,0xab,0x4a,0xd1,0x1a,0x01,0xfc,0x71,0x75,
+    },
+    {
+        0xbf,0x32,0x3a,0xef,0x33,0x23,0x92,0xe2,0x50,0x39,0xb6,0x91,0xbc,0xac,0x0c,0xba,
+        0xb1,0xd7,0x16,0x0e,0xa6,0xea,0xfd,0xb0,0x55,0xb4,0xe6,0x36,0x4f,0xe4,0xa6,0x52,
+    },
+    {
+        0x6e,0x98,0x28,0xb0,0x79,0xfd,0x6f,0x93,0x5b,0xa2,0x3e,0x27,0x9e,0x0e,0x99,0x24,
+        0x18,0xde,0x41,0xdc,0xb6,0xbd,0xc8,0x52,0x18,0x3c,0xe9,0x45,0x14,0x12,0x91,0xd6,
+    },
+    {
+        0x58,0x7e,0x80,0xe8,0x21,0x7c,0xfe,0x60,0xe8,0x8a,0x16,0xa6,0xe3,0xf5,0x4e,0xe2,
+        0x7c,0xaa,0x65,0x91,0x7d,0xaa,0x28,0xac,0x4c,0x05,0x54,0x20,0x50,0xbc,0xd3,0x4c,
+    },
+    {
+        0xd2,0xf3,0x89,0x69,0xc0,0xc2,0x59,0x4f,0xce,0xc0,0xb8,0xdf,0x68,0xa4,0x20,0x59,
+        0xf4,0xfa,0x1f,0x56,0x55,0x99,0xd6,0x94,0x57,0xa7,0xb4,0xd8,0x58,0x01,0x98,0x06,
+    },
+    {
+        0xba,0xa6,0x03,0x4c,0x7a,0x83,0x0f,0x7b,0x2b,0xf8,0x19,0xe4,0xb6,0xd4,0xc5,0x4f,
+        0x92,0xad,0x7d,0x76,0xe5,0x91,0xcb,0xa7,0x1e,0x3f,0xc6,0xa5,0x23,0x6f,0x5d,0x39,
+    },
+    {
+        0x34,0xff,0x9d,0xf8,0xd7,0x8f,0xb6,0x26,0xac,0x05,0x21,0x16,0xb4,0xd9,0x4f,0xbf,
+        0x86,0xe5,0x3c,0x3f,0xf3,0xca,0x22,0x4f,0x2d,0xbd,0x59,0x19,0x57,0x16,0x45,0x42,
+    },
+    {
+        0xdf,0x4a,0x06,0x5e,0x84,0x00,0xfb,0x51,0x78,0x39,0xd8,0xff,0xe0,0xc8,0x52,0x01,
+        0x6a,0x08,0x24,0x25,0x66,0x81,0x15,0xca,0x4b,0xd2,0x16,0x33,0x3b,0xee,0x08,0x64,
+    },
+    {
+        0x33,0x00,0x07,0xae,0xb4,0x77,0xfc,0xc1,0xf9,0xdb,0x30,0xc4,0x9d,0x78,0x54,0x0d,
+        0x12,0x1d,0x0f,0xdf,0x31,0x75,0x93,0x85,0x5c,0xd0,0xb2,0x21,0x92,0x10,0x80,0x1b,
+    },
+    {
+        0xbe,0x84,0xd4,0x9d,0xd3,0xbb,0xc3,0xa0,0xb7,0x4d,0x93,0x7e,0x56,0x6a,0x30,0xf3,
+        0x4a,0xda,0x49,0x67,0xd1,0xf9,0x83,0xf1,0x1e,0xd1,0x5f,0xfb,0x1d,0x0e,0x76,0x2d,
+    },
+    {
+        0x65,0x64,0x09,0x20,0xbc,0x35,0xbd,0x24,0x23,0x3c,0x41,0x6b,0x2d,0x8e,0xd1,0x88,
+        0xd8,0xc7,0x8a,0x50,0xe5,0xbc,0x74,0x94,0x3f,0x71,0xde,0x99,0xd4,0xf8,0xd5,0xa4,
+    },
+    {
+        0x23,0xa3,0xa5,0x4d,0x8a,0xe3,0xff,0x82,0x12,0xd2,0xa8,0x1a,0x10,0x09,0x62,0x51,
+        0xc9,0x57,0x25,0x27,0x70,0x18,0xc5,0x69,0x44,0x57,0xcb,0x95,0x66,0x16,0x63,0xad,
+    },
+    {
+        0x6d,0x31,0x2c,0xcd,0x39,0xc9,0x62,0xd3,0x55,0x8e,0x49,0xa4,0x2c,0xb6,0xa3,0x38,
+        0x03,0x75,0x36,0xde,0x3c,0xd5,0xf7,0x7c,0xdc,0x6c,0x2c,0xec,0xdd,0xaa,0xd1,0x62,
+    },
+    {
+        0x3d,0x64,0x51,0xd5,0x61,0x36,0x59,0x80,0xfa,0x4f,0x44,0xe3,0xff,0x11,0x16,0x99,
+        0x1b,0x0c,0x40,0xc6,0x8d,0xb2,0x50,0x51,0x07,0xf5,0xd3,0x05,0xcf,0x26,0xc1,0x67,
+    },
+    {
+        0xd2,0x60,0xd6,0xc8,0xee,0xfe,0x9c,0x26,0xe8,0x21,0x0a,0x7f,0xa3,0xd1,0x44,0xfc,
+        0xd2,0x36,0x87,0x95,0x9e,0x2f,0x10,0x22,0xd2,0x44,0x47,0x9f,0x71,0xde,0x98,0x81,
+    },
+    {
+        0x00,0xab,0x83,0x31,0x54,0xf4,0x10,0xa6,0x48,0xc9,0x32,0x46,0x87,0x46,0xc6,0x81,
+        0x94,0xd3,0x03,0xa8,0x87,0x80,0x10,0x36,0xd7,0x78,0xcf,0xe0,0x19,0xd1,0x56,0x41,
+    },
+    {
+        0xed,0x99,0x29,0x74,0x33,0xf3,0x43,0x7c,0x53,0xe2,0x24,0xe1,0x19,0x96,0x49,0x23,
+        0xd8,0x6d,0xcf,0x09,0x75,0x7b,0x8c,0x3b,0x73,0x27,0x89,0xee,0xa1,0x6d,0xae,0x91,
+    },
+};
+
+
+// The salts are hashed with the terminating 0
+#define GenContext_Salts(macro) \
+    macro(beam_Key, "beam-Key") \
+    macro(beam_HKdf, "beam-HKdf") \
+    macro(beam_Schnorr, "beam-Schnorr") \
+    macro(bulletproof, "bulletproof") \
+    macro(bulletproof_sk, "bulletproof-sk") \
+    macro(bp_key, "bp-key") \
+    macro(hw_wlt_split, "hw-wlt-split") \
+    macro(hw_wlt_rcv, "hw-wlt-rcv") \
+    macro(hw_wlt_snd, "hw-wlt-snd") \
+    macro(hw_wlt_snd_sh, "hw-wlt-snd-sh") \
+    macro(beam_lelantus_1, "beam.lelantus.1") \
+    macro(beam_lelantus_2, "beam.lelantus.2") \
+    macro(kG_O, "kG-O") \
+    macro(skG_O, "skG-O")
+
+static void GenContext_Salt(HMacSalt* pRes, const char* szSalt, size_t nSalt)
+{
+    secp256k1_hmac_sha256 hmac;
+    secp256k1_hmac_sha256_initialize(&hmac, (const uint8_t*) szSalt, nSalt);
+
+    memcpy(pRes->m_pInner, hmac.inner.s, sizeof(pRes->m_pInner));
+    memcpy(pRes->m_pOuter, hmac.outer.s, sizeof(pRes->m_pOuter));
+}
+
+typedef struct
+{
+    int m_External;
+    uint32_t m_nBitsRangeproof;
+    uint32_t m_nBitsH;
+    uint32_t m_nBitsSecure;
+    uint32_t m_nCombTeeth;
+    uint32_t m_nCombSpacing;
+    int m_Bytes;
+    int m_Verify;
+
+} GenContext_Config;
+
+// the output either goes to stdout, or to the buffer
+static uint8_t* g_pOut = 0;
+static uint32_t g_nBytesOut = 0;
+
+static void GenContext_Write(const uint8_t* p, uint32_t n)
+{
+    if (g_pOut)
+    {
+        memcpy(g_pOut + g_nBytesOut, p, n);
+        g_nBytesOut += n;
+        return;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        printf("%s0x%02x,", (g_nBytesOut % 16) ? "" : " ", p[i]);
+        if (!(++g_nBytesOut % 16))
+            printf("\n");
+    }
+}
+
+static void GenContext_Lift(secp256k1_ge* pGe, const uint8_t* pX)
+{
+    secp256k1_fe x;
+    if (!secp256k1_fe_set_b32(&x, pX) || !secp256k1_ge_set_xo_var(pGe, &x, 0))
+    {
+        printf("bad base point\n");
+        exit(1);
+    }
+}
+
+static void GenContext_WriteGe(const secp256k1_ge* pGe, uint32_t nCount)
+{
+    // ge_storage bytes, the same for the 32 and 64-bit limbs on little-endian platforms
+    for (uint32_t i = 0; i < nCount; i++)
+    {
+        secp256k1_ge_storage ges;
+        secp256k1_ge_to_storage(&ges, pGe + i);
+        GenContext_Write((const uint8_t*) &ges, sizeof(ges));
+    }
+}
+
+static void GenContext_WriteGej(const secp256k1_gej* pGej, uint32_t nCount)
+{
+    secp256k1_ge* pGe = (secp256k1_ge*) malloc(sizeof(secp256k1_ge) * nCount);
+    if (!pGe)
+        exit(1);
+
+    secp256k1_ge_set_all_gej_var(pGe, pGej, nCount);
+    GenContext_WriteGe(pGe, nCount);
+
+    free(pGe);
+}
+
+static secp256k1_gej* GenContext_Alloc(uint32_t nCount)
+{
+    secp256k1_gej* pGej = (secp256k1_gej*) malloc(sizeof(secp256k1_gej) * nCount);
+    if (!pGej)
+        exit(1);
+    return pGej;
+}
+
+static void GenContext_Mul(secp256k1_gej* pRes, const secp256k1_ge* pGe, const secp256k1_scalar* pK)
+{
+    // variable-time double-and-add, public data only
+    secp256k1_gej_set_infinity(pRes);
+
+    for (int iBit = 255; iBit >= 0; iBit--)
+    {
+        secp256k1_gej_double_var(pRes, pRes, 0);
+        if (secp256k1_scalar_get_bits(pK, iBit, 1))
+            secp256k1_gej_add_ge_var(pRes, pRes, pGe, 0);
+    }
+}
+
+static void GenContext_Odds(const uint8_t* pX, uint32_t nBits)
+{
+    // P, 3P, 5P, ...
+    uint32_t nCount = c_MultiMac_OddCount(nBits);
+    secp256k1_gej* pGej = GenContext_Alloc(nCount);
+
+    secp256k1_ge ge;
+    GenContext_Lift(&ge, pX);
+
+    secp256k1_gej gej2;
+    secp256k1_gej_set_ge(pGej, &ge);
+    secp256k1_gej_double_var(&gej2, pGej, 0);
+
+    for (uint32_t i = 1; i < nCount; i++)
+        secp256k1_gej_add_var(pGej + i, pGej + i - 1, &gej2, 0);
+
+    GenContext_WriteGej(pGej, nCount);
+    free(pGej);
+}
+
+static void GenContext_Compensation(secp256k1_gej* pRes, const secp256k1_ge* pNums, const secp256k1_scalar* pK)
+{
+    secp256k1_scalar k;
+    secp256k1_scalar_negate(&k, pK);
+    GenContext_Mul(pRes, pNums, &k);
+}
+
+static void GenContext_Secure(const uint8_t* pX, uint32_t nBits)
+{
+    // j*P + Nums, then the compensation of the Nums added at every window
+    uint32_t nCount = 1u << nBits;
+    secp256k1_gej* pGej = GenContext_Alloc(nCount + 1);
+
+    secp256k1_ge ge, geNums;
+    GenContext_Lift(&ge, pX);
+    GenContext_Lift(&geNums, g_pX_Nums);
+
+    secp256k1_gej_set_ge(pGej, &geNums);
+    for (uint32_t i = 1; i < nCount; i++)
+        secp256k1_gej_add_ge_var(pGej + i, pGej + i - 1, &ge, 0);
+
+    // Sum(2^(iWnd * nBits))
+    secp256k1_scalar k, kWnd;
+    secp256k1_scalar_clear(&k);
+    secp256k1_scalar_set_int(&kWnd, 1);
+
+    for (uint32_t iBit = 0; iBit < 256; iBit += nBits)
+    {
+        secp256k1_scalar_add(&k, &k, &kWnd);
+
+        secp256k1_scalar kMul;
+        secp256k1_scalar_set_int(&kMul, nCount);
+        secp256k1_scalar_mul(&kWnd, &kWnd, &kMul);
+    }
+
+    GenContext_Compensation(pGej + nCount, &geNums, &k);
+
+    GenContext_WriteGej(pGej, nCount + 1);
+    free(pGej);
+}
+
+static void GenContext_Comb(const uint8_t* pX, uint32_t nTeeth, uint32_t nSpacing)
+{
+    uint32_t nBlocks = (256 + nTeeth * nSpacing - 1) / (nTeeth * nSpacing);
+    uint32_t nEntries = 1u << nTeeth;
+    secp256k1_gej* pGej = GenContext_Alloc(nBlocks * nEntries + 1);
+
+    secp256k1_ge ge, geNums;
+    GenContext_Lift(&ge, pX);
+    GenContext_Lift(&geNums, g_pX_Nums);
+
+    // running 2^(iTooth * nSpacing) * P over all the blocks
+    secp256k1_gej gejTooth;
+    secp256k1_gej_set_ge(&gejTooth, &ge);
+
+    for (uint32_t iBlock = 0; iBlock < nBlocks; iBlock++)
+    {
+        secp256k1_gej* pE = pGej + iBlock * nEntries;
+        secp256k1_gej_set_ge(pE, &geNums);
+
+        for (uint32_t iTooth = 0; iTooth < nTeeth; iTooth++)
+        {
+            // entries with this tooth as the highest bit
+            uint32_t nMsk = 1u << iTooth;
+            for (uint32_t i = 0; i < nMsk; i++)
+                secp256k1_gej_add_var(pE + (nMsk | i), pE + i, &gejTooth, 0);
+
+            for (uint32_t i = 0; i < nSpacing; i++)
+                secp256k1_gej_double_var(&gejTooth, &gejTooth, 0);
+        }
+    }
+
+    // nBlocks * (2^nSpacing - 1)
+    secp256k1_scalar k;
+    secp256k1_scalar_set_int(&k, nBlocks * ((1u << nSpacing) - 1));
+    GenContext_Compensation(pGej + nBlocks * nEntries, &geNums, &k);
+
+    GenContext_WriteGej(pGej, nBlocks * nEntries + 1);
+    free(pGej);
+}
+
+static void GenContext_RangeproofBytes()
+{
+    // [iByte][val] = Sum(bit(val, i) ? G_i : -H_i), i in this byte
+    secp256k1_gej pGej[0x100];
+
+    for (uint32_t iByte = 0; iByte < 8; iByte++)
+    {
+        secp256k1_ge pDelta[8]; // G_i + H_i
+
+        secp256k1_gej_set_infinity(pGej);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            secp256k1_ge geG, geH;
+            GenContext_Lift(&geG, g_pX_Rangeproof[iByte * 8 + i]);
+            GenContext_Lift(&geH, g_pX_Rangeproof[64 + iByte * 8 + i]);
+
+            secp256k1_gej gej;
+            secp256k1_gej_set_ge(&gej, &geG);
+            secp256k1_gej_add_ge_var(&gej, &gej, &geH, 0);
+            secp256k1_ge_set_gej_var(pDelta + i, &gej);
+
+            secp256k1_ge_neg(&geH, &geH);
+            secp256k1_gej_add_ge_var(pGej, pGej, &geH, 0);
+        }
+
+        for (uint32_t val = 1; val < 0x100; val++)
+        {
+            uint32_t iBit = 0;
+            while (!(1 & (val >> iBit)))
+                iBit++;
+
+            secp256k1_gej_add_ge_var(pGej + val, pGej + (val & (val - 1)), pDelta + iBit, 0);
+        }
+
+        GenContext_WriteGej(pGej, 0x100);
+    }
+}
+
+static void GenContext_Affine(const uint8_t* pX)
+{
+    // AffinePoint, big-endian
+    secp256k1_ge ge;
+    GenContext_Lift(&ge, pX);
+
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
+
+    uint8_t pBuf[32];
+    secp256k1_fe_get_b32(pBuf, &ge.x);
+    GenContext_Write(pBuf, sizeof(pBuf));
+    secp256k1_fe_get_b32(pBuf, &ge.y);
+    GenContext_Write(pBuf, sizeof(pBuf));
+}
+
+static void GenContext_All(const GenContext_Config* pCfg)
+{
+    // the order of the Context members
+    if (pCfg->m_External)
+    {
+        for (uint32_t i = 0; i < _countof(g_pX_Rangeproof); i++)
+            GenContext_Affine(g_pX_Rangeproof[i]);
+
+        GenContext_Affine(g_pX_H);
+        GenContext_Affine(g_pX_G);
+        GenContext_Affine(g_pX_J);
+        return;
+    }
+
+    for (uint32_t i = 0; i < _countof(g_pX_Rangeproof); i++)
+        GenContext_Odds(g_pX_Rangeproof[i], pCfg->m_nBitsRangeproof);
+
+    GenContext_Odds(g_pX_H, pCfg->m_nBitsH);
+
+    GenContext_Secure(g_pX_G, pCfg->m_nBitsSecure);
+    GenContext_Secure(g_pX_J, pCfg->m_nBitsSecure);
+
+    GenContext_Comb(g_pX_G, pCfg->m_nCombTeeth, pCfg->m_nCombSpacing);
+    GenContext_Comb(g_pX_J, pCfg->m_nCombTeeth, pCfg->m_nCombSpacing);
+
+    if (pCfg->m_Bytes)
+        GenContext_RangeproofBytes();
+
+    if (pCfg->m_Verify)
+        GenContext_Odds(g_pX_G, c_GenContext_nBitsMax);
+}
+
+static void GenContext_Default(GenContext_Config* pCfg)
+{
+    memset(pCfg, 0, sizeof(*pCfg));
+    pCfg->m_nBitsRangeproof = c_MultiMac_nBits_Rangeproof;
+    pCfg->m_nBitsH = c_MultiMac_nBits_H;
+    pCfg->m_nBitsSecure = c_MultiMac_nBits_Secure;
+    pCfg->m_nCombTeeth = c_MultiMac_Comb_nTeeth;
+    pCfg->m_nCombSpacing = c_MultiMac_Comb_nSpacing;
+#ifdef c_MultiMac_Rangeproof_nBytes
+    pCfg->m_Bytes = 1;
+#endif // c_MultiMac_Rangeproof_nBytes
+#ifdef c_MultiMac_nBits_Verify
+    static_assert(c_MultiMac_nBits_Verify == c_GenContext_nBitsMax, "");
+    pCfg->m_Verify = 1;
+#endif // c_MultiMac_nBits_Verify
+}
+
+#ifdef GenContext_Check
+
+static uint32_t g_Failed = 0;
+
+static void GenContext_Verify(const secp256k1_gej* pGej, const uint8_t* pX, const secp256k1_scalar* pK, const char* szWhat, uint32_t nBits)
+{
+    secp256k1_ge ge;
+    GenContext_Lift(&ge, pX);
+
+    secp256k1_gej gej;
+    GenContext_Mul(&gej, &ge, pK);
+
+    secp256k1_gej_neg(&gej, &gej);
+    secp256k1_gej_add_var(&gej, &gej, pGej, 0);
+
+    if (!secp256k1_gej_is_infinity(&gej))
+    {
+        printf("%s, %u bits: wrong result\n", szWhat, nBits);
+        g_Failed++;
+    }
+}
+
+static uint8_t* GenContext_ToBuf(void (*pfn)(const uint8_t*, uint32_t), const uint8_t* pX, uint32_t nBits, uint32_t nSize)
+{
+    g_pOut = (uint8_t*) malloc(nSize);
+    if (!g_pOut)
+        exit(1);
+    g_nBytesOut = 0;
+
+    pfn(pX, nBits);
+
+    uint8_t* pRes = g_pOut;
+    g_pOut = 0;
+    return pRes;
+}
+
+static void GenContext_CheckWidths()
+{
+    // hw_crypto with the tables of all the widths, the scalar bits are deterministic
+    secp256k1_scalar k;
+    uint8_t pK[32];
+    for (uint32_t i = 0; i < sizeof(pK); i++)
+        pK[i] = (uint8_t) (0x5a + i * 37);
+    secp256k1_scalar_set_b32(&k, pK, 0);
+
+    for (uint32_t nBits = 2; nBits <= c_GenContext_nBitsMax; nBits++)
+    {
+        secp256k1_ge_storage* pTbl = (secp256k1_ge_storage*) GenContext_ToBuf(GenContext_Odds, g_pX_H, nBits, sizeof(secp256k1_ge_storage) * c_MultiMac_OddCount(nBits));
+
+        secp256k1_scalar k2 = k; // would be modified
+        MultiMac_WNaf wnaf;
+        secp256k1_gej gej;
+
+        MultiMac_Context ctx;
+        ctx.m_pRes = &gej;
+        ctx.m_Secure.m_Count = 0;
+        ctx.m_Fast.m_pZDenom = 0;
+        ctx.m_Fast.m_Count = 1;
+        ctx.m_Fast.m_WndBits = nBits;
+        ctx.m_Fast.m_pGen0 = pTbl;
+        ctx.m_Fast.m_pK = &k2;
+        ctx.m_Fast.m_pWnaf = &wnaf;
+        MultiMac_Calculate(&ctx);
+
+        GenContext_Verify(&gej, g_pX_H, &k, "odds", nBits);
+        free(pTbl);
+    }
+
+    {
+        MultiMac_Secure* pTbl = (MultiMac_Secure*) GenContext_ToBuf(GenContext_Secure, g_pX_J, c_MultiMac_nBits_Secure, sizeof(MultiMac_Secure));
+
+        secp256k1_gej gej;
+        MultiMac_Context ctx;
+        ctx.m_pRes = &gej;
+        ctx.m_Fast.m_Count = 0;
+        ctx.m_Secure.m_Count = 1;
+        ctx.m_Secure.m_pGen = pTbl;
+        ctx.m_Secure.m_pK = &k;
+        MultiMac_Calculate(&ctx);
+
+        GenContext_Verify(&gej, g_pX_J, &k, "secure", c_MultiMac_nBits_Secure);
+        free(pTbl);
+    }
+}
+
+static void GenContext_CheckSalts()
+{
+#define THE_MACRO(name, sz) \
+    { \
+        static const HMacSalt saltC = HMacSalt_##name; \
+        HMacSalt salt; \
+        GenContext_Salt(&salt, sz, sizeof(sz)); \
+        if (memcmp(&salt, &saltC, sizeof(salt))) \
+        { \
+            printf("salt %s differs\n", sz); \
+            g_Failed++; \
+        } \
+    }
+
+    GenContext_Salts(THE_MACRO)
+#undef THE_MACRO
+}
+
+int main()
+{
+    GenContext_Config cfg;
+    GenContext_Default(&cfg);
+
+    g_pOut = (uint8_t*) malloc(sizeof(Context));
+    if (!g_pOut)
+        return 1;
+
+    GenContext_All(&cfg);
+
+    if ((g_nBytesOut != sizeof(Context)) || memcmp(g_pOut, Context_get(), sizeof(Context)))
+    {
+        printf("g_ContextBuf differs from the generated tables (%u bytes vs %u)\n", g_nBytesOut, (uint32_t) sizeof(Context));
+        g_Failed++;
+    }
+
+    free(g_pOut);
+    g_pOut = 0;
+
+    GenContext_CheckWidths();
+    GenContext_CheckSalts();
+
+    if (g_Failed)
+    {
+        printf("%u check(s) failed\n", g_Failed);
+        return 1;
+    }
+
+    printf("All checks passed\n");
+    return 0;
+}
+
+#else // GenContext_Check
+
+static void GenContext_PrintWords(const uint32_t* p, uint32_t n)
+{
+    printf("{ ");
+    for (uint32_t i = 0; i < n; i++)
+        printf("0x%08x,", p[i]);
+    printf(" }");
+}
+
+static void GenContext_PrintSalts()
+{
+    printf("// Generated by beamhw_gencontext --salts.\n");
+    printf("// HMAC-SHA256 keyed by the constant NonceGenerator salts (with the terminating 0): the states after the ipad and opad blocks.\n\n");
+    printf("#pragma once\n\n");
+
+#define THE_MACRO(name, sz) \
+    { \
+        HMacSalt salt; \
+        GenContext_Salt(&salt, sz, sizeof(sz)); \
+        printf("#define HMacSalt_%s { \\\n\t", #name); \
+        GenContext_PrintWords(salt.m_pInner, _countof(salt.m_pInner)); \
+        printf(", \\\n\t"); \
+        GenContext_PrintWords(salt.m_pOuter, _countof(salt.m_pOuter)); \
+        printf(" } // \"%s\"\n\n", sz); \
+    }
+
+    GenContext_Salts(THE_MACRO)
+#undef THE_MACRO
+}
+
+static int GenContext_ParseBits(const char* sz, uint32_t nMin, uint32_t nMax, uint32_t* pVal)
+{
+    int val = atoi(sz);
+    if ((val < (int) nMin) || (val > (int) nMax))
+        return 0;
+
+    *pVal = (uint32_t) val;
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    GenContext_Config cfg;
+    GenContext_Default(&cfg);
+
+    if ((2 == argc) && !strcmp(argv[1], "--salts"))
+    {
+        GenContext_PrintSalts();
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* sz = argv[i];
+        int bOk = 1;
+
+        if (!strcmp(sz, "--external"))
+            cfg.m_External = 1;
+        else if (!strcmp(sz, "--bytes"))
+            cfg.m_Bytes = 1;
+        else if (!strcmp(sz, "--no-bytes"))
+            cfg.m_Bytes = 0;
+        else if (!strcmp(sz, "--verify"))
+            cfg.m_Verify = 1;
+        else if (!strcmp(sz, "--no-verify"))
+            cfg.m_Verify = 0;
+        else if (!strcmp(sz, "--rangeproof") && (i + 1 < argc))
+            bOk = GenContext_ParseBits(argv[++i], 2, c_GenContext_nBitsMax, &cfg.m_nBitsRangeproof);
+        else if (!strcmp(sz, "--h") && (i + 1 < argc))
+            bOk = GenContext_ParseBits(argv[++i], 2, c_GenContext_nBitsMax, &cfg.m_nBitsH);
+        else if (!strcmp(sz, "--secure") && (i + 1 < argc))
+        {
+            bOk = GenContext_ParseBits(argv[++i], 1, 8, &cfg.m_nBitsSecure) &&
+                !(32 % cfg.m_nBitsSecure); // must divide the scalar word, on both 32 and 64-bit platforms
+        }
+        else if (!strcmp(sz, "--comb") && (i + 2 < argc))
+        {
+            bOk =
+                GenContext_ParseBits(argv[i + 1], 1, 8, &cfg.m_nCombTeeth) &&
+                GenContext_ParseBits(argv[i + 2], 1, 24, &cfg.m_nCombSpacing);
+            i += 2;
+        }
+        else
+            bOk = 0;
+
+        if (!bOk)
+        {
+            printf("Usage: beamhw_gencontext [--external] [--rangeproof <bits>] [--h <bits>] [--secure <bits>] [--comb <teeth> <spacing>] [--bytes | --no-bytes] [--verify | --no-verify]\n");
+            printf("       beamhw_gencontext --salts\n");
+            return 1;
+        }
+    }
+
+    GenContext_All(&cfg);
+    return 0;
+}
+
+#endif // GenContext_Check
@@ -0,0 +1,161 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host (non-BOLOS) implementation of the platform functions hw_crypto expects from the app.
+// Slots and the aux buffer live in RAM, user interaction is auto-approved. Embedding apps may
+// override KeyKeeper_DisplayEndpoint and KeyKeeper_ConfirmSpend (they are weak).
+
+#include <assert.h>
+#include <stdlib.h>
+#include <sys/random.h>
+#include "os.h"
+#include "HostApp.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "secp256k1/src/hash_impl.h"
+#pragma GCC diagnostic pop
+
+void SecureEraseMem(void* p, uint32_t n)
+{
+    explicit_bzero(p, n);
+}
+
+/////////////////////////////////////
+// Slots
+#define c_KeyKeeper_Slots 16
+
+static UintBig g_pSlot[c_KeyKeeper_Slots];
+
+static struct
+{
+    UintBig m_Seed;
+    uint32_t m_Counter;
+    int m_Enabled;
+
+} g_Rng;
+
+void HostApp_SetRngSeed(const UintBig* pSeed)
+{
+    g_Rng.m_Enabled = !!pSeed;
+    g_Rng.m_Counter = 0;
+
+    if (pSeed)
+        memcpy(g_Rng.m_Seed.m_pVal, pSeed->m_pVal, sizeof(g_Rng.m_Seed.m_pVal));
+    else
+        SecureEraseMem(&g_Rng.m_Seed, sizeof(g_Rng.m_Seed));
+}
+
+void HostApp_ResetSlots()
+{
+    SecureEraseMem(g_pSlot, sizeof(g_pSlot));
+}
+
+static void GetRandom(UintBig* pRes)
+{
+    if (g_Rng.m_Enabled)
+    {
+        secp256k1_sha256_t sha;
+        secp256k1_sha256_initialize(&sha);
+        secp256k1_sha256_write(&sha, g_Rng.m_Seed.m_pVal, sizeof(g_Rng.m_Seed.m_pVal));
+        secp256k1_sha256_write(&sha, (const uint8_t*) &g_Rng.m_Counter, sizeof(g_Rng.m_Counter));
+        secp256k1_sha256_finalize(&sha, pRes->m_pVal);
+
+        g_Rng.m_Counter++;
+    }
+    else
+    {
+        if (getrandom(pRes->m_pVal, sizeof(pRes->m_pVal), 0) != sizeof(pRes->m_pVal))
+            abort();
+    }
+}
+
+uint32_t KeyKeeper_getNumSlots(KeyKeeper* p)
+{
+    UNUSED(p);
+    return c_KeyKeeper_Slots;
+}
+
+static void RegenerateSlot(UintBig* pSlotValue)
+{
+    // use both rng and prev value to derive the new value
+    secp256k1_sha256_t sha;
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, pSlotValue->m_pVal, sizeof(*pSlotValue));
+
+    UintBig hv;
+    GetRandom(&hv);
+    secp256k1_sha256_write(&sha, hv.m_pVal, sizeof(hv));
+
+    secp256k1_sha256_finalize(&sha, pSlotValue->m_pVal);
+    SecureEraseMem(&hv, sizeof(hv));
+}
+
+void KeyKeeper_ReadSlot(KeyKeeper* p, uint32_t iSlot, UintBig* pRes)
+{
+    UNUSED(p);
+    assert(iSlot < c_KeyKeeper_Slots);
+    UintBig* pSlot = g_pSlot + iSlot;
+
+    if (IsUintBigZero(pSlot))
+        RegenerateSlot(pSlot); // 1st-time access
+
+    memcpy(pRes->m_pVal, pSlot->m_pVal, sizeof(*pSlot));
+}
+
+void KeyKeeper_RegenerateSlot(KeyKeeper* p, uint32_t iSlot)
+{
+    UNUSED(p);
+    assert(iSlot < c_KeyKeeper_Slots);
+
+    RegenerateSlot(g_pSlot + iSlot);
+}
+
+/////////////////////////////////////
+// AuxBuf
+static KeyKeeper_AuxBuf g_AuxBuf;
+
+const KeyKeeper_AuxBuf* KeyKeeper_GetAuxBuf(KeyKeeper* pKk)
+{
+    UNUSED(pKk);
+    return &g_AuxBuf;
+}
+
+void KeyKeeper_WriteAuxBuf(KeyKeeper* pKk, const void* p, uint32_t nOffset, uint32_t nSize)
+{
+    UNUSED(pKk);
+    assert(nOffset + nSize <= sizeof(KeyKeeper_AuxBuf));
+
+    uint8_t* pDst = (uint8_t*) &g_AuxBuf;
+
+    memcpy(pDst + nOffset, p, nSize);
+}
+
+/////////////////////////////////////
+// User interaction
+__attribute__((weak))
+void KeyKeeper_DisplayEndpoint(KeyKeeper* p, AddrID addrID, const UintBig* pAddr)
+{
+    UNUSED(p);
+    UNUSED(addrID);
+    UNUSED(pAddr);
+}
+
+__attribute__((weak))
+uint16_t KeyKeeper_ConfirmSpend(KeyKeeper* p, const TxSummary* pSummary)
+{
+    UNUSED(p);
+    UNUSED(pSummary);
+    return c_KeyKeeper_Status_Ok;
+}
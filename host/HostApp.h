@@ -0,0 +1,23 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "hw_crypto/keykeeper.h"
+
+// Makes the slot rng deterministic (for reproducible tests), or restores the system rng if pSeed is NULL
+void HostApp_SetRngSeed(const UintBig* pSeed);
+
+// Erases all the slots, they're regenerated on the next access
+void HostApp_ResetSlots();
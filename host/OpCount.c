@@ -0,0 +1,207 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-method operation counts of KeyKeeper_Invoke (requires BeamCrypto_OpCounters).
+// Usage: beamhw_opcount [--check | --golden]
+//   (default)  print the counts
+//   --check    compare against the budgets in OpCountGolden.h, fail if any is exceeded
+//   --golden   print the counts in OpCountGolden.h format
+
+#include <stdio.h>
+#include "os.h"
+#include "Scenarios.h"
+#include "HostApp.h"
+
+#ifndef BeamCrypto_OpCounters
+#	error BeamCrypto_OpCounters must be defined
+#endif // BeamCrypto_OpCounters
+
+#ifndef _countof
+#	define _countof(arr) sizeof(arr) / sizeof((arr)[0])
+#endif // _countof
+
+#define c_OpCount_MaxLabels 64
+#define c_OpCount_Coins 4 // TxAddCoins size, the budgets depend on it
+
+typedef struct
+{
+    const char* m_szLabel;
+    OpCounters m_Ops;
+
+} OpCountEntry;
+
+typedef struct
+{
+    HostInvoker m_Base;
+    OpCountEntry m_pEntry[c_OpCount_MaxLabels];
+    char m_pLabels[c_OpCount_MaxLabels][40];
+    uint32_t m_nEntries;
+
+} OpCountInvoker;
+
+static const OpCountEntry g_pGolden[] = {
+#include "OpCountGolden.h"
+};
+
+#define OpCount_Fields(macro) \
+    macro(FeMul) \
+    macro(FeSqr) \
+    macro(FeInv) \
+    macro(FeSqrt) \
+    macro(GejDouble) \
+    macro(GejAdd) \
+    macro(ScalarMul) \
+    macro(ScalarInv) \
+    macro(Sha256)
+
+static uint16_t OpCount_Invoke(HostInvoker* pBase, const char* szLabel, KeyKeeper* pKk, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize)
+{
+    if (!szLabel)
+        return KeyKeeper_Invoke(pKk, pIn, nIn, pOut, pOutSize);
+
+    memset(&g_OpCounters, 0, sizeof(g_OpCounters));
+    uint16_t errCode = KeyKeeper_Invoke(pKk, pIn, nIn, pOut, pOutSize);
+
+    OpCountInvoker* p = (OpCountInvoker*) pBase;
+    if (p->m_nEntries < c_OpCount_MaxLabels)
+    {
+        char* szCopy = p->m_pLabels[p->m_nEntries];
+        snprintf(szCopy, sizeof(p->m_pLabels[0]), "%s", szLabel);
+
+        OpCountEntry* pEntry = p->m_pEntry + p->m_nEntries++;
+        pEntry->m_szLabel = szCopy;
+        pEntry->m_Ops = g_OpCounters;
+    }
+
+    return errCode;
+}
+
+static const OpCountEntry* OpCount_FindGolden(const char* szLabel)
+{
+    for (uint32_t i = 0; i < _countof(g_pGolden); i++)
+        if (!strcmp(g_pGolden[i].m_szLabel, szLabel))
+            return g_pGolden + i;
+    return 0;
+}
+
+static void OpCount_Print(const OpCountInvoker* p)
+{
+    printf("%-28s", "Method");
+#define THE_MACRO(name) printf(" %9s", #name);
+    OpCount_Fields(THE_MACRO)
+#undef THE_MACRO
+    printf("\n");
+
+    for (uint32_t i = 0; i < p->m_nEntries; i++)
+    {
+        const OpCountEntry* pEntry = p->m_pEntry + i;
+        printf("%-28s", pEntry->m_szLabel);
+#define THE_MACRO(name) printf(" %9u", pEntry->m_Ops.m_##name);
+        OpCount_Fields(THE_MACRO)
+#undef THE_MACRO
+        printf("\n");
+    }
+}
+
+static void OpCount_PrintGolden(const OpCountInvoker* p)
+{
+    printf("// Generated by beamhw_opcount --golden. Fields: ");
+#define THE_MACRO(name) printf("%s ", #name);
+    OpCount_Fields(THE_MACRO)
+#undef THE_MACRO
+    printf("\n");
+
+    for (uint32_t i = 0; i < p->m_nEntries; i++)
+    {
+        const OpCountEntry* pEntry = p->m_pEntry + i;
+        printf("{ \"%s\", {", pEntry->m_szLabel);
+#define THE_MACRO(name) printf(" %u,", pEntry->m_Ops.m_##name);
+        OpCount_Fields(THE_MACRO)
+#undef THE_MACRO
+        printf(" } },\n");
+    }
+}
+
+static uint32_t OpCount_Check(const OpCountInvoker* p)
+{
+    uint32_t nFailed = 0;
+
+    for (uint32_t i = 0; i < p->m_nEntries; i++)
+    {
+        const OpCountEntry* pEntry = p->m_pEntry + i;
+        const OpCountEntry* pGolden = OpCount_FindGolden(pEntry->m_szLabel);
+        if (!pGolden)
+        {
+            printf("%s: no budget\n", pEntry->m_szLabel);
+            nFailed++;
+            continue;
+        }
+
+#define THE_MACRO(name) \
+        if (pEntry->m_Ops.m_##name > pGolden->m_Ops.m_##name) \
+        { \
+            printf("%s: %s = %u, exceeds budget %u\n", pEntry->m_szLabel, #name, pEntry->m_Ops.m_##name, pGolden->m_Ops.m_##name); \
+            nFailed++; \
+        } \
+        else \
+            if (pEntry->m_Ops.m_##name < pGolden->m_Ops.m_##name) \
+                printf("%s: %s = %u, below budget %u (consider updating OpCountGolden.h)\n", pEntry->m_szLabel, #name, pEntry->m_Ops.m_##name, pGolden->m_Ops.m_##name);
+
+        OpCount_Fields(THE_MACRO)
+#undef THE_MACRO
+    }
+
+    return nFailed;
+}
+
+int main(int argc, char* argv[])
+{
+    static OpCountInvoker s_Inv;
+    s_Inv.m_Base.m_pfnInvoke = OpCount_Invoke;
+
+    // the counts of variable-time code depend on the slot values
+    UintBig hvSeed;
+    memset(hvSeed.m_pVal, 0x31, sizeof(hvSeed.m_pVal));
+    HostApp_SetRngSeed(&hvSeed);
+    HostApp_ResetSlots();
+
+    for (const HostScenario* pSc = HostScenario_GetAll(c_OpCount_Coins); pSc->m_szName; pSc++)
+        pSc->m_pfnRun(&s_Inv.m_Base, pSc->m_nParam);
+
+    if (s_Inv.m_Base.m_Errors)
+    {
+        printf("%u invocations failed\n", s_Inv.m_Base.m_Errors);
+        return 1;
+    }
+
+    if ((argc > 1) && !strcmp(argv[1], "--golden"))
+    {
+        OpCount_PrintGolden(&s_Inv);
+        return 0;
+    }
+
+    OpCount_Print(&s_Inv);
+
+    if ((argc > 1) && !strcmp(argv[1], "--check"))
+    {
+        uint32_t nFailed = OpCount_Check(&s_Inv);
+        if (nFailed)
+        {
+            printf("%u budget(s) exceeded\n", nFailed);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,31 @@
+// Generated by beamhw_opcount --golden. Fields: FeMul FeSqr FeInv FeSqrt GejDouble GejAdd ScalarMul ScalarInv Sha256 
+{ "Version", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "GetNumSlots", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "GetPKdf(owner)", { 859, 338, 1, 0, 6, 106, 0, 0, 0, } },
+{ "GetPKdf(child)", { 859, 338, 1, 0, 6, 106, 1, 0, 18, } },
+{ "GetPKdf(owner, again)", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "GetPKdf(child, again)", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "GetImage", { 859, 338, 1, 0, 6, 106, 2, 0, 25, } },
+{ "BatchInvoke(GetImage x3)", { 2577, 1014, 3, 0, 18, 318, 6, 0, 75, } },
+{ "GetImages(x3)", { 2583, 1014, 1, 0, 18, 318, 3, 0, 21, } },
+{ "DisplayEndpoint", { 428, 169, 1, 0, 3, 53, 1, 0, 8, } },
+{ "AuxWrite", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "AuxRead", { 0, 0, 0, 0, 0, 0, 0, 0, 0, } },
+{ "SignOfflineAddr", { 2146, 845, 3, 0, 15, 265, 3, 0, 63, } },
+{ "CreateOutput", { 48164, 19447, 4, 2, 310, 5907, 10, 0, 320, } },
+{ "CreateOutput(asset)", { 48350, 19992, 4, 4, 306, 5917, 9, 0, 305, } },
+{ "CreateOutputs(x2)", { 96111, 38810, 6, 4, 620, 11782, 18, 0, 604, } },
+{ "TxAddCoins(4)", { 3735, 1771, 4, 1, 49, 443, 17, 0, 59, } },
+{ "TxAddCoinsEx(4)", { 3735, 1771, 4, 1, 49, 443, 17, 0, 59, } },
+{ "TxSplit", { 859, 338, 1, 0, 6, 106, 1, 0, 14, } },
+{ "TxSend1", { 1287, 507, 2, 0, 9, 159, 2, 0, 28, } },
+{ "TxReceive", { 1759, 1192, 3, 2, 12, 214, 3, 0, 36, } },
+{ "TxSend2", { 1629, 1196, 2, 1, 130, 136, 9, 0, 35, } },
+{ "CreateShieldedVouchers(1)", { 3840, 1491, 6, 0, 18, 477, 10, 0, 117, } },
+{ "CreateShieldedVouchers(4)", { 14076, 5457, 21, 0, 63, 1749, 33, 0, 275, } },
+{ "CreateShieldedInput_1", { 1073, 695, 1, 1, 20, 117, 7, 0, 89, } },
+{ "CreateShieldedInput_2", { 450, 427, 1, 1, 3, 54, 2, 0, 14, } },
+{ "CreateShieldedInput_3", { 0, 0, 0, 0, 0, 0, 0, 0, 2, } },
+{ "CreateShieldedInput_4", { 450, 427, 1, 1, 3, 54, 9, 0, 11, } },
+{ "TxAddCoins(shielded)", { 2943, 1519, 3, 1, 64, 337, 15, 0, 75, } },
+{ "TxSendShielded", { 6983, 4695, 8, 4, 411, 663, 679, 9, 407, } },
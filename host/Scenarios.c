@@ -0,0 +1,540 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The request builders follow BeamStackTest1..5 (Tests.c), the TxSendShielded sequence is shared via TestVectors.h
+
+#include <stdio.h>
+#include "os.h"
+#include "Scenarios.h"
+#include "TestVectors.h"
+
+void DeriveAddress(const KeyKeeper* p, AddrID addrID, secp256k1_scalar* pKey, UintBig* pAddr);
+
+#define c_HostScenario_MaxCoins 255
+
+#ifndef _countof
+#	define _countof(arr) sizeof(arr) / sizeof((arr)[0])
+#endif
+
+static KeyKeeper g_Kk1, g_Kk2;
+
+#pragma pack (push, 1)
+static union
+{
+    uint8_t m_pBuf[2048];
+
+    struct {
+        Proto_In_TxAddCoins m_In;
+        CoinID m_pCid[c_HostScenario_MaxCoins];
+    } m_AddCoins;
+
+    struct {
+        Proto_In_TxAddCoinsEx m_In;
+        CoinID m_pCid[c_HostScenario_MaxCoins];
+    } m_AddCoinsEx;
+
+    struct {
+        Proto_In_CreateShieldedInput_3 m_In;
+        CompactPoint m_pG[8];
+    } m_Inp3;
+
+    struct {
+        Proto_In_AuxWrite m_In;
+        uint8_t m_pData[64];
+    } m_AuxWrite;
+
+} g_Req;
+#pragma pack (pop)
+
+static uint8_t g_pRes[2048];
+
+uint16_t HostInvoker_Direct(HostInvoker* pInv, const char* szLabel, KeyKeeper* pKk, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize)
+{
+    UNUSED(pInv);
+    UNUSED(szLabel);
+    return KeyKeeper_Invoke(pKk, pIn, nIn, pOut, pOutSize);
+}
+
+static uint16_t Scenario_Invoke(HostInvoker* pInv, const char* szLabel, KeyKeeper* pKk, const void* pIn, uint32_t nIn)
+{
+    uint32_t nOut = sizeof(g_pRes);
+    uint16_t errCode = pInv->m_pfnInvoke(pInv, szLabel, pKk, (const uint8_t*) pIn, nIn, g_pRes, &nOut);
+
+    if (c_KeyKeeper_Status_Ok != errCode)
+        pInv->m_Errors++;
+
+    return errCode;
+}
+
+void HostScenario_InitKeyKeeper(KeyKeeper* pKk, uint8_t nSeed)
+{
+    UintBig hv;
+    memset(hv.m_pVal, 0, sizeof(hv.m_pVal));
+    hv.m_pVal[0] = nSeed;
+
+    memset(pKk, 0, sizeof(*pKk));
+    Kdf_Init(&pKk->m_MasterKey, &hv);
+}
+
+static void Scenario_InitBoth()
+{
+    HostScenario_InitKeyKeeper(&g_Kk1, 0);
+    HostScenario_InitKeyKeeper(&g_Kk2, 4);
+}
+
+static void Scenario_SetCoin(CoinID* pCid, uint64_t nIdx, Amount amount, AssetID aid)
+{
+    CoinID cid;
+    memset(&cid, 0, sizeof(cid));
+    cid.m_Idx = nIdx;
+    cid.m_Type = 0x22;
+    cid.m_SubIdx = 3u << 24;
+    cid.m_Amount = amount;
+    cid.m_AssetID = aid;
+
+    memcpy(pCid, &cid, sizeof(cid));
+}
+
+static uint32_t Scenario_AddCoins(uint8_t nIns, uint8_t nOuts)
+{
+    memset(&g_Req.m_AddCoins.m_In, 0, sizeof(g_Req.m_AddCoins.m_In));
+    g_Req.m_AddCoins.m_In.m_OpCode = g_Proto_Code_TxAddCoins;
+    g_Req.m_AddCoins.m_In.m_Reset = 1;
+    g_Req.m_AddCoins.m_In.m_Ins = nIns;
+    g_Req.m_AddCoins.m_In.m_Outs = nOuts;
+
+    return sizeof(g_Req.m_AddCoins.m_In) + sizeof(CoinID) * (nIns + nOuts);
+}
+
+static void Scenario_SetKrn(TxCommonIn* pTx)
+{
+    TxCommonIn tx;
+    tx.m_Krn.m_Fee = 8;
+    tx.m_Krn.m_hMin = 100500;
+    tx.m_Krn.m_hMax = 100600;
+
+    memcpy(pTx, &tx, sizeof(tx));
+}
+
+static void Scenario_GetPoint(CompactPoint* pPt, uint8_t nSeed)
+{
+    // any valid point will do, GetImage is the simplest way to get it
+    Proto_In_GetImage req;
+    memset(&req, 0, sizeof(req));
+    req.m_OpCode = g_Proto_Code_GetImage;
+    req.m_hvSrc.m_pVal[0] = nSeed;
+    req.m_bG = 1;
+
+    uint32_t nOut = sizeof(g_pRes);
+    KeyKeeper_Invoke(&g_Kk1, (const uint8_t*) &req, sizeof(req), g_pRes, &nOut);
+
+    memcpy(pPt, &((const Proto_Out_GetImage*) g_pRes)->m_ptImageG, sizeof(*pPt));
+}
+
+/////////////////////////////////////
+// Scenarios
+static void Scenario_Simple(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    {
+        Proto_In_Version req;
+        req.m_OpCode = g_Proto_Code_Version;
+        Scenario_Invoke(pInv, "Version", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        Proto_In_GetNumSlots req;
+        req.m_OpCode = g_Proto_Code_GetNumSlots;
+        Scenario_Invoke(pInv, "GetNumSlots", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        Proto_In_GetPKdf req;
+        req.m_OpCode = g_Proto_Code_GetPKdf;
+        req.m_Kind = 0;
+        Scenario_Invoke(pInv, "GetPKdf(owner)", &g_Kk1, &req, sizeof(req));
+
+        req.m_Kind = 1;
+        Scenario_Invoke(pInv, "GetPKdf(child)", &g_Kk1, &req, sizeof(req));
+
+        req.m_Kind = 0;
+        Scenario_Invoke(pInv, "GetPKdf(owner, again)", &g_Kk1, &req, sizeof(req));
+
+        req.m_Kind = 1;
+        Scenario_Invoke(pInv, "GetPKdf(child, again)", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        Proto_In_GetImage req;
+        memset(&req, 0, sizeof(req));
+        req.m_OpCode = g_Proto_Code_GetImage;
+        memset(req.m_hvSrc.m_pVal, 0x5a, sizeof(req.m_hvSrc.m_pVal));
+        req.m_iChild = 14;
+        req.m_bG = 1;
+        req.m_bJ = 1;
+        Scenario_Invoke(pInv, "GetImage", &g_Kk1, &req, sizeof(req));
+
+        // same, as many per request as GetImages allows
+        uint8_t* pPos = g_Req.m_pBuf;
+        *pPos++ = g_Proto_Code_BatchInvoke;
+        *pPos++ = c_KeyKeeper_GetImages_MaxCount;
+
+        for (uint32_t i = 0; i < c_KeyKeeper_GetImages_MaxCount; i++)
+        {
+            uint16_t nSub = sizeof(req);
+            memcpy(pPos, &nSub, sizeof(nSub));
+            pPos += sizeof(nSub);
+
+            req.m_iChild = 15 + i;
+            memcpy(pPos, &req, sizeof(req));
+            pPos += sizeof(req);
+        }
+
+        Scenario_Invoke(pInv, "BatchInvoke(GetImage x3)", &g_Kk1, g_Req.m_pBuf, (uint32_t) (pPos - g_Req.m_pBuf));
+
+        // same, batched by the method
+        Proto_In_GetImages* pIn = (Proto_In_GetImages*) g_Req.m_pBuf;
+        GetImages_In* pRec = (GetImages_In*) (pIn + 1);
+
+        pIn->m_OpCode = g_Proto_Code_GetImages;
+        pIn->m_Count = c_KeyKeeper_GetImages_MaxCount;
+
+        for (uint32_t i = 0; i < pIn->m_Count; i++)
+        {
+            pRec[i].m_hvSrc = req.m_hvSrc;
+            pRec[i].m_iChild = 15 + i;
+            pRec[i].m_bG = req.m_bG;
+            pRec[i].m_bJ = req.m_bJ;
+        }
+
+        Scenario_Invoke(pInv, "GetImages(x3)", &g_Kk1, pIn, sizeof(*pIn) + sizeof(GetImages_In) * pIn->m_Count);
+    }
+
+    {
+        Proto_In_DisplayEndpoint req;
+        req.m_OpCode = g_Proto_Code_DisplayEndpoint;
+        req.m_AddrID = 101;
+        Scenario_Invoke(pInv, "DisplayEndpoint", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        memset(&g_Req.m_AuxWrite, 0x3c, sizeof(g_Req.m_AuxWrite));
+        g_Req.m_AuxWrite.m_In.m_OpCode = g_Proto_Code_AuxWrite;
+        g_Req.m_AuxWrite.m_In.m_Offset = 0;
+        g_Req.m_AuxWrite.m_In.m_Size = sizeof(g_Req.m_AuxWrite.m_pData);
+        Scenario_Invoke(pInv, "AuxWrite", &g_Kk1, &g_Req.m_AuxWrite, sizeof(g_Req.m_AuxWrite));
+
+        Proto_In_AuxRead req;
+        req.m_OpCode = g_Proto_Code_AuxRead;
+        req.m_Offset = 0;
+        req.m_Size = sizeof(g_Req.m_AuxWrite.m_pData);
+        Scenario_Invoke(pInv, "AuxRead", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        Proto_In_SignOfflineAddr req;
+        req.m_OpCode = g_Proto_Code_SignOfflineAddr;
+        req.m_AddrID = 101;
+        Scenario_Invoke(pInv, "SignOfflineAddr", &g_Kk1, &req, sizeof(req));
+    }
+}
+
+static void Scenario_CreateOutput(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    Proto_In_CreateOutput req;
+    memset(&req, 0, sizeof(req));
+    req.m_OpCode = g_Proto_Code_CreateOutput;
+    Scenario_SetCoin(&req.m_Cid, 15, 4500000000ull, 0);
+
+    Scenario_Invoke(pInv, "CreateOutput", &g_Kk1, &req, sizeof(req));
+
+    Scenario_SetCoin(&req.m_Cid, 16, 774440000, 8);
+    Scenario_Invoke(pInv, "CreateOutput(asset)", &g_Kk1, &req, sizeof(req));
+
+    // as many outputs as fit the response, of different assets
+    Proto_In_CreateOutputs* pIn = (Proto_In_CreateOutputs*) g_Req.m_pBuf;
+    CreateOutputs_In* pRec = (CreateOutputs_In*) (pIn + 1);
+
+    memset(pIn, 0, sizeof(*pIn));
+    pIn->m_OpCode = g_Proto_Code_CreateOutputs;
+    pIn->m_Count = c_KeyKeeper_CreateOutputs_MaxCount;
+
+    for (uint32_t i = 0; i < pIn->m_Count; i++)
+    {
+        memset(pRec + i, 0, sizeof(pRec[i]));
+        Scenario_SetCoin(&pRec[i].m_Cid, 17 + i, 4500000000ull + i, (1 & i) ? 8 : 0);
+        Scenario_GetPoint(pRec[i].m_pT, (uint8_t) (i * 2 + 1));
+        Scenario_GetPoint(pRec[i].m_pT + 1, (uint8_t) (i * 2 + 2));
+
+        if (1 & i)
+            Scenario_GetPoint(&pRec[i].m_ptAssetGen, (uint8_t) (i + 9));
+    }
+
+    Scenario_Invoke(pInv, "CreateOutputs(x2)", &g_Kk1, pIn, sizeof(*pIn) + sizeof(CreateOutputs_In) * pIn->m_Count);
+}
+
+static void Scenario_TxAddCoinsAny(HostInvoker* pInv, uint32_t nCoins, int bEx)
+{
+    Scenario_InitBoth();
+
+    if (nCoins > c_HostScenario_MaxCoins)
+        nCoins = c_HostScenario_MaxCoins;
+
+    // mix of beam and asset coins, both inputs and outputs
+    uint8_t nIns = (uint8_t) ((nCoins + 1) / 2);
+    uint8_t nOuts = (uint8_t) (nCoins - nIns);
+
+    uint32_t nIn;
+    CoinID* pCid;
+
+    if (bEx)
+    {
+        // same coins, with the 32-bit counts
+        memset(&g_Req.m_AddCoinsEx.m_In, 0, sizeof(g_Req.m_AddCoinsEx.m_In));
+        g_Req.m_AddCoinsEx.m_In.m_OpCode = g_Proto_Code_TxAddCoinsEx;
+        g_Req.m_AddCoinsEx.m_In.m_Reset = 1;
+        g_Req.m_AddCoinsEx.m_In.m_Ins = nIns;
+        g_Req.m_AddCoinsEx.m_In.m_Outs = nOuts;
+
+        nIn = sizeof(g_Req.m_AddCoinsEx.m_In) + sizeof(CoinID) * nCoins;
+        pCid = g_Req.m_AddCoinsEx.m_pCid;
+    }
+    else
+    {
+        nIn = Scenario_AddCoins(nIns, nOuts);
+        pCid = g_Req.m_AddCoins.m_pCid;
+    }
+
+    for (uint32_t i = 0; i < nCoins; i++)
+        Scenario_SetCoin(pCid + i, i + 1, 100 + i, (i % 4) ? 0 : 18);
+
+    static char s_szLabel[32];
+    snprintf(s_szLabel, sizeof(s_szLabel), bEx ? "TxAddCoinsEx(%u)" : "TxAddCoins(%u)", nCoins);
+
+    Scenario_Invoke(pInv, s_szLabel, &g_Kk1, &g_Req, nIn);
+}
+
+static void Scenario_TxAddCoins(HostInvoker* pInv, uint32_t nCoins)
+{
+    Scenario_TxAddCoinsAny(pInv, nCoins, 0);
+}
+
+static void Scenario_TxAddCoinsEx(HostInvoker* pInv, uint32_t nCoins)
+{
+    Scenario_TxAddCoinsAny(pInv, nCoins, 1);
+}
+
+static void Scenario_TxSplit(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    uint32_t nIn = Scenario_AddCoins(1, 1);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid, 1, 100, 0);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid + 1, 2, 92, 0);
+    Scenario_Invoke(pInv, 0, &g_Kk1, &g_Req, nIn);
+
+    Proto_In_TxSplit req;
+    memset(&req, 0, sizeof(req));
+    req.m_OpCode = g_Proto_Code_TxSplit;
+    Scenario_SetKrn(&req.m_Tx);
+
+    Scenario_Invoke(pInv, "TxSplit", &g_Kk1, &req, sizeof(req));
+}
+
+static void Scenario_TxSendReceive(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    // kk1 sends 100 of asset 18, kk2 receives them (as in BeamStackTest2)
+    uint32_t nIn = Scenario_AddCoins(2, 0);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid, 1, 100, 18);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid + 1, 2, 8, 0);
+    Scenario_Invoke(pInv, 0, &g_Kk1, &g_Req, nIn);
+
+    nIn = Scenario_AddCoins(0, 2);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid, 1, 70, 18);
+    Scenario_SetCoin(g_Req.m_AddCoins.m_pCid + 1, 2, 30, 18);
+    Scenario_Invoke(pInv, 0, &g_Kk2, &g_Req, nIn);
+
+    TxKernelCommitments comms;
+    UintBig hvUserAggr;
+    Signature paymentProof;
+    secp256k1_scalar sk;
+
+    {
+        Proto_In_TxSend1 req;
+        memset(&req, 0, sizeof(req));
+        req.m_OpCode = g_Proto_Code_TxSend1;
+        Scenario_SetKrn(&req.m_Tx);
+        DeriveAddress(&g_Kk2, 102, &sk, &req.m_Mut.m_Peer);
+        req.m_Mut.m_AddrID = 101;
+        req.m_iSlot = 2;
+
+        Scenario_Invoke(pInv, "TxSend1", &g_Kk1, &req, sizeof(req));
+
+        const Proto_Out_TxSend1* pRes = (const Proto_Out_TxSend1*) g_pRes;
+        comms = pRes->m_Comms;
+        hvUserAggr = pRes->m_UserAgreement;
+    }
+
+    {
+        Proto_In_TxReceive req;
+        memset(&req, 0, sizeof(req));
+        req.m_OpCode = g_Proto_Code_TxReceive;
+        Scenario_SetKrn(&req.m_Tx);
+        DeriveAddress(&g_Kk1, 101, &sk, &req.m_Mut.m_Peer);
+        req.m_Mut.m_AddrID = 102;
+        req.m_Comms = comms;
+
+        Scenario_Invoke(pInv, "TxReceive", &g_Kk2, &req, sizeof(req));
+
+        const Proto_Out_TxReceive* pRes = (const Proto_Out_TxReceive*) g_pRes;
+        comms = pRes->m_Tx.m_Comms;
+        paymentProof = pRes->m_PaymentProof;
+    }
+
+    {
+        Proto_In_TxSend2 req;
+        memset(&req, 0, sizeof(req));
+        req.m_OpCode = g_Proto_Code_TxSend2;
+        Scenario_SetKrn(&req.m_Tx);
+        DeriveAddress(&g_Kk2, 102, &sk, &req.m_Mut.m_Peer);
+        req.m_Mut.m_AddrID = 101;
+        req.m_iSlot = 2;
+        req.m_Comms = comms;
+        req.m_UserAgreement = hvUserAggr;
+        req.m_PaymentProof = paymentProof;
+
+        Scenario_Invoke(pInv, "TxSend2", &g_Kk1, &req, sizeof(req));
+    }
+
+    SecureEraseMem(&sk, sizeof(sk));
+}
+
+static void Scenario_CreateShieldedVouchers(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    Proto_In_CreateShieldedVouchers req;
+    memset(&req, 0, sizeof(req));
+    req.m_OpCode = g_Proto_Code_CreateShieldedVouchers;
+    req.m_AddrID = 101;
+    memset(req.m_Nonce0.m_pVal, 0x77, sizeof(req.m_Nonce0.m_pVal));
+
+    req.m_Count = 1;
+    Scenario_Invoke(pInv, "CreateShieldedVouchers(1)", &g_Kk1, &req, sizeof(req));
+
+    req.m_Count = 4;
+    Scenario_Invoke(pInv, "CreateShieldedVouchers(4)", &g_Kk1, &req, sizeof(req));
+}
+
+static void Scenario_CreateShieldedInput(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    Scenario_InitBoth();
+
+    CompactPoint pt;
+    Scenario_GetPoint(&pt, 1);
+
+    {
+        // as in BeamStackTest4
+        Proto_In_CreateShieldedInput_1 req;
+        memset(&req, 0, sizeof(req));
+        req.m_OpCode = g_Proto_Code_CreateShieldedInput_1;
+
+        ShieldedInput_Fmt fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.m_Amount = 43300;
+        fmt.m_AssetID = 15;
+        fmt.m_nViewerIdx = 443;
+        memcpy(&req.m_InpFmt, &fmt, sizeof(fmt));
+
+        ShieldedInput_SpendParams sp;
+        sp.m_hMin = 431000;
+        sp.m_hMax = 432000;
+        sp.m_WindowEnd = 4672342;
+        sp.m_Sigma_M = 8;
+        sp.m_Sigma_n = 4;
+        memcpy(&req.m_SpendParams, &sp, sizeof(sp));
+
+        Scenario_Invoke(pInv, "CreateShieldedInput_1", &g_Kk1, &req, sizeof(req));
+    }
+
+    {
+        Proto_In_CreateShieldedInput_2 req;
+        for (uint32_t i = 0; i < _countof(req.m_pABCD); i++)
+            req.m_pABCD[i] = pt;
+        req.m_OpCode = g_Proto_Code_CreateShieldedInput_2;
+        req.m_NoncePub = pt;
+
+        Scenario_Invoke(pInv, "CreateShieldedInput_2", &g_Kk1, &req, sizeof(req));
+    }
+
+    // Sigma_M = 8 points: 4 via CreateShieldedInput_3, the remaining 4 via CreateShieldedInput_4
+    for (uint32_t i = 0; i < _countof(g_Req.m_Inp3.m_pG); i++)
+        g_Req.m_Inp3.m_pG[i] = pt;
+
+    g_Req.m_Inp3.m_In.m_OpCode = g_Proto_Code_CreateShieldedInput_3;
+    g_Req.m_Inp3.m_In.m_NumPoints = 4;
+    Scenario_Invoke(pInv, "CreateShieldedInput_3", &g_Kk1, &g_Req, sizeof(g_Req.m_Inp3.m_In) + sizeof(CompactPoint) * 4);
+
+    static_assert(sizeof(Proto_In_CreateShieldedInput_4) == 1, "");
+    g_Req.m_pBuf[sizeof(g_Req.m_Inp3.m_In) - 1] = g_Proto_Code_CreateShieldedInput_4; // overwrites m_NumPoints, points follow it
+    Scenario_Invoke(pInv, "CreateShieldedInput_4", &g_Kk1, g_Req.m_pBuf + sizeof(g_Req.m_Inp3.m_In) - 1, 1 + sizeof(CompactPoint) * 4);
+}
+
+static void Scenario_TxSendShielded(HostInvoker* pInv, uint32_t nParam)
+{
+    UNUSED(nParam);
+    HostScenario_InitKeyKeeper(&g_Kk1, 0);
+
+    Scenario_Invoke(pInv, "TxAddCoins(shielded)", &g_Kk1, g_pMsgSendShielded0, sizeof(g_pMsgSendShielded0));
+
+    // ShieldedOutParams upload, not accounted
+    Scenario_Invoke(pInv, 0, &g_Kk1, g_pMsgSendShielded1, sizeof(g_pMsgSendShielded1));
+    Scenario_Invoke(pInv, 0, &g_Kk1, g_pMsgSendShielded2, sizeof(g_pMsgSendShielded2));
+    Scenario_Invoke(pInv, 0, &g_Kk1, g_pMsgSendShielded3, sizeof(g_pMsgSendShielded3));
+    Scenario_Invoke(pInv, 0, &g_Kk1, g_pMsgSendShielded4, sizeof(g_pMsgSendShielded4));
+    Scenario_Invoke(pInv, 0, &g_Kk1, g_pMsgSendShielded5, sizeof(g_pMsgSendShielded5));
+
+    Scenario_Invoke(pInv, "TxSendShielded", &g_Kk1, g_pMsgSendShielded6, sizeof(g_pMsgSendShielded6));
+}
+
+const HostScenario* HostScenario_GetAll(uint32_t nCoins)
+{
+    static HostScenario s_pScenarios[] = {
+        { "Simple", Scenario_Simple, 0 },
+        { "CreateOutput", Scenario_CreateOutput, 0 },
+        { "TxAddCoins", Scenario_TxAddCoins, 0 },
+        { "TxAddCoinsEx", Scenario_TxAddCoinsEx, 0 },
+        { "TxSplit", Scenario_TxSplit, 0 },
+        { "TxSendReceive", Scenario_TxSendReceive, 0 },
+        { "CreateShieldedVouchers", Scenario_CreateShieldedVouchers, 0 },
+        { "CreateShieldedInput", Scenario_CreateShieldedInput, 0 },
+        { "TxSendShielded", Scenario_TxSendShielded, 0 },
+        { 0, 0, 0 }
+    };
+
+    s_pScenarios[2].m_nParam = nCoins;
+    s_pScenarios[3].m_nParam = nCoins;
+    return s_pScenarios;
+}
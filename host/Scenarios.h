@@ -0,0 +1,45 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "hw_crypto/keykeeper.h"
+
+// Request scenarios that drive KeyKeeper_Invoke for every protocol method.
+// Each measured invocation goes through the invoker, which decides what to record (timing, op counts, etc.).
+
+typedef struct HostInvoker HostInvoker;
+
+struct HostInvoker
+{
+    // szLabel is NULL for setup invocations that shouldn't be accounted
+    uint16_t (*m_pfnInvoke)(HostInvoker*, const char* szLabel, KeyKeeper*, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize);
+
+    uint32_t m_Errors; // incremented by the scenarios for each unexpected status
+};
+
+uint16_t HostInvoker_Direct(HostInvoker*, const char* szLabel, KeyKeeper*, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize);
+
+typedef struct
+{
+    const char* m_szName;
+    void (*m_pfnRun)(HostInvoker*, uint32_t nParam);
+    uint32_t m_nParam;
+
+} HostScenario;
+
+// NULL-terminated. nCoins sets the number of coins in the TxAddCoins and TxAddCoinsEx scenarios
+const HostScenario* HostScenario_GetAll(uint32_t nCoins);
+
+void HostScenario_InitKeyKeeper(KeyKeeper*, uint8_t nSeed);
@@ -0,0 +1,227 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host SHA-256 compression with the x86 SHA extensions, selected at startup by CPUID.
+// On other CPUs (and other architectures) g_pfnSha256Transform stays null, and the portable secp256k1 one is used.
+// Without the SHA extensions but with AVX2 the 8-lane multi-buffer compression is selected for the batched derivations.
+
+#include "hw_crypto/ecc_decl.h"
+
+#ifndef BeamCrypto_Sha256Accel
+#	error BeamCrypto_Sha256Accel must be defined
+#endif // BeamCrypto_Sha256Accel
+
+Sha256_Transform_t g_pfnSha256Transform = 0;
+Sha256_TransformLanes_t g_pfnSha256TransformLanes = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <string.h>
+#include <immintrin.h>
+#include <cpuid.h>
+
+static const uint32_t g_pSha256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+__attribute__((target("sha,sse4.1")))
+static void Sha256_Transform_Ni(uint32_t* pState, const uint8_t* pBlock)
+{
+    const __m128i msk = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull); // big-endian words
+
+    // the SHA instructions keep the state as ABEF / CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) pState), 0xB1); // CDAB
+    __m128i st1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (pState + 4)), 0x1B); // EFGH
+    __m128i st0 = _mm_alignr_epi8(tmp, st1, 8); // ABEF
+    st1 = _mm_blend_epi16(st1, tmp, 0xF0); // CDGH
+
+    const __m128i st0Prev = st0;
+    const __m128i st1Prev = st1;
+
+    __m128i pW[4]; // message schedule, 4 words each
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        __m128i* pW0 = pW + (i & 3);
+
+        if (i < 4)
+            *pW0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (pBlock + i * 16)), msk);
+        else
+        {
+            // W[t] = W[t-16] + s0(W[t-15]) + W[t-7] + s1(W[t-2])
+            const __m128i w1 = pW[(i - 1) & 3];
+            tmp = _mm_add_epi32(_mm_sha256msg1_epu32(*pW0, pW[(i - 3) & 3]), _mm_alignr_epi8(w1, pW[(i - 2) & 3], 4));
+            *pW0 = _mm_sha256msg2_epu32(tmp, w1);
+        }
+
+        tmp = _mm_add_epi32(*pW0, _mm_loadu_si128((const __m128i*) (g_pSha256_K + i * 4)));
+        st1 = _mm_sha256rnds2_epu32(st1, st0, tmp);
+        st0 = _mm_sha256rnds2_epu32(st0, st1, _mm_shuffle_epi32(tmp, 0x0E));
+    }
+
+    st0 = _mm_add_epi32(st0, st0Prev);
+    st1 = _mm_add_epi32(st1, st1Prev);
+
+    tmp = _mm_shuffle_epi32(st0, 0x1B); // FEBA
+    st1 = _mm_shuffle_epi32(st1, 0xB1); // DCHG
+    _mm_storeu_si128((__m128i*) pState, _mm_blend_epi16(tmp, st1, 0xF0)); // DCBA
+    _mm_storeu_si128((__m128i*) (pState + 4), _mm_alignr_epi8(st1, tmp, 8)); // HGFE
+}
+
+// 8 independent blocks, a lane per 32-bit element
+#define Avx_Add(a, b) _mm256_add_epi32(a, b)
+#define Avx_Xor3(a, b, c) _mm256_xor_si256(_mm256_xor_si256(a, b), c)
+#define Avx_Rotr(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+__attribute__((target("avx2")))
+static void Sha256_Transform_Avx2(uint32_t* const* ppState, const uint8_t* const* ppBlock)
+{
+    __m256i pS[8], pW[16];
+
+    for (uint32_t i = 0; i < 8; i++)
+        pS[i] = _mm256_set_epi32(
+            (int) ppState[7][i], (int) ppState[6][i], (int) ppState[5][i], (int) ppState[4][i],
+            (int) ppState[3][i], (int) ppState[2][i], (int) ppState[1][i], (int) ppState[0][i]);
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        uint32_t pV[8];
+        for (uint32_t iLane = 0; iLane < 8; iLane++)
+        {
+            uint32_t val;
+            memcpy(&val, ppBlock[iLane] + i * 4, sizeof(val));
+            pV[iLane] = __builtin_bswap32(val);
+        }
+
+        pW[i] = _mm256_loadu_si256((const __m256i*) pV);
+    }
+
+    __m256i a = pS[0], b = pS[1], c = pS[2], d = pS[3], e = pS[4], f = pS[5], g = pS[6], h = pS[7];
+
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        __m256i* pW0 = pW + (i & 15);
+
+        if (i >= 16)
+        {
+            // W[t] = W[t-16] + s0(W[t-15]) + W[t-7] + s1(W[t-2])
+            const __m256i w15 = pW[(i - 15) & 15];
+            const __m256i w2 = pW[(i - 2) & 15];
+
+            __m256i s0 = Avx_Xor3(Avx_Rotr(w15, 7), Avx_Rotr(w15, 18), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = Avx_Xor3(Avx_Rotr(w2, 17), Avx_Rotr(w2, 19), _mm256_srli_epi32(w2, 10));
+
+            *pW0 = Avx_Add(Avx_Add(*pW0, s0), Avx_Add(pW[(i - 7) & 15], s1));
+        }
+
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = Avx_Add(Avx_Add(h, Avx_Xor3(Avx_Rotr(e, 6), Avx_Rotr(e, 11), Avx_Rotr(e, 25))), Avx_Add(ch, Avx_Add(*pW0, _mm256_set1_epi32((int) g_pSha256_K[i]))));
+
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = Avx_Add(Avx_Xor3(Avx_Rotr(a, 2), Avx_Rotr(a, 13), Avx_Rotr(a, 22)), maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = Avx_Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Avx_Add(t1, t2);
+    }
+
+    pS[0] = Avx_Add(pS[0], a);
+    pS[1] = Avx_Add(pS[1], b);
+    pS[2] = Avx_Add(pS[2], c);
+    pS[3] = Avx_Add(pS[3], d);
+    pS[4] = Avx_Add(pS[4], e);
+    pS[5] = Avx_Add(pS[5], f);
+    pS[6] = Avx_Add(pS[6], g);
+    pS[7] = Avx_Add(pS[7], h);
+
+    // all the lanes are loaded before storing, a state may be shared by several (padding) lanes
+    uint32_t pRes[8][8];
+    for (uint32_t i = 0; i < 8; i++)
+        _mm256_storeu_si256((__m256i*) pRes[i], pS[i]);
+
+    for (uint32_t iLane = 0; iLane < 8; iLane++)
+        for (uint32_t i = 0; i < 8; i++)
+            ppState[iLane][i] = pRes[i][iLane];
+}
+
+static int Sha256Accel_HasAvx2()
+{
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+        return 0;
+
+    // the OS must preserve the ymm registers
+    if (!(c & bit_OSXSAVE) || !(c & bit_AVX))
+        return 0;
+
+    unsigned int nLo, nHi;
+    __asm__ ("xgetbv" : "=a" (nLo), "=d" (nHi) : "c" (0));
+    if ((nLo & 6) != 6)
+        return 0;
+
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d))
+        return 0;
+
+    return !!(b & bit_AVX2);
+}
+
+Sha256_TransformLanes_t Sha256Accel_GetLanes(void)
+{
+    return Sha256Accel_HasAvx2() ? Sha256_Transform_Avx2 : 0;
+}
+
+static int Sha256Accel_HasNi()
+{
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+        return 0;
+
+    if (!(c & bit_SSE4_1) || !(c & bit_SSSE3))
+        return 0;
+
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d))
+        return 0;
+
+    return !!(b & bit_SHA);
+}
+
+__attribute__((constructor))
+static void Sha256Accel_Init()
+{
+    if (Sha256Accel_HasNi())
+        g_pfnSha256Transform = Sha256_Transform_Ni; // faster per block than the 8 AVX2 lanes
+    else
+        g_pfnSha256TransformLanes = Sha256Accel_GetLanes();
+}
+
+#else // __x86_64__ || __i386__
+
+Sha256_TransformLanes_t Sha256Accel_GetLanes(void)
+{
+    return 0;
+}
+
+#endif // __x86_64__ || __i386__
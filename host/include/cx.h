@@ -0,0 +1,23 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Host stand-in for the BOLOS cx.h. The cx_ecpoint_t API is only used by the BeamCrypto_ExternalGej
+// build, which is not supported on host.
+#include <stdint.h>
+
+#ifdef BeamCrypto_ExternalGej
+#	error BeamCrypto_ExternalGej requires the BOLOS SDK
+#endif // BeamCrypto_ExternalGej
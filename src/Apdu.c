@@ -0,0 +1,172 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Platform-independent, also built on host (beamhw_apdu_test)
+
+#include "os.h"
+#include "sw.h"
+#include "Apdu.h"
+
+#if c_Apdu_ChainMax
+
+static struct
+{
+    uint8_t m_pBuf[c_Apdu_ChainMax];
+    uint16_t m_Size;
+    uint8_t m_Active;
+
+} g_ApduChain;
+
+static void Apdu_ChainReset()
+{
+    g_ApduChain.m_Size = 0;
+    g_ApduChain.m_Active = 0;
+}
+
+static void Apdu_ChainDrop()
+{
+    if (g_ApduChain.m_Active)
+        OnBeamHostRequestDrop(g_ApduChain.m_pBuf, g_ApduChain.m_Size);
+
+    Apdu_ChainReset();
+}
+
+static uint16_t Apdu_ChainAdd(uint8_t p1, const uint8_t* p, uint32_t n)
+{
+    if (p1 & ~(c_Apdu_P1_More | c_Apdu_P1_Cont))
+        return SW_WRONG_P1P2;
+
+    if (p1 & c_Apdu_P1_Cont)
+    {
+        if (!g_ApduChain.m_Active)
+            return SW_BAD_STATE; // wasn't started, or dropped
+    }
+    else
+        Apdu_ChainDrop(); // new chain
+
+    if (n > sizeof(g_ApduChain.m_pBuf) - g_ApduChain.m_Size)
+        return SW_WRONG_DATA_LENGTH;
+
+    memcpy(g_ApduChain.m_pBuf + g_ApduChain.m_Size, p, n);
+    g_ApduChain.m_Size += (uint16_t) n;
+    g_ApduChain.m_Active = 1;
+
+    return SW_OK;
+}
+
+#endif // c_Apdu_ChainMax
+
+uint16_t Apdu_OnRcv(uint8_t* pBuf, uint32_t nBufSize, int* pLen)
+{
+    uint32_t lenInp = *pLen;
+    *pLen = 0;
+
+     // Structure with fields of APDU command.
+#pragma pack (push, 1)
+    typedef struct {
+        uint8_t cla;    // Instruction class
+        uint8_t ins;    // Instruction code
+        uint8_t p1;     // Instruction parameter 1
+        uint8_t p2;     // Instruction parameter 2
+        uint8_t lc;     // Length of command data
+        uint8_t data[0];  // Command data, variable length
+    } command_t;
+#pragma pack (pop)
+
+    if (lenInp < sizeof(command_t))
+    {
+        PRINTF("=> /!\\ too short\n");
+        return SW_WRONG_DATA_LENGTH;
+    }
+
+    command_t* const pCmd = (command_t*) pBuf;
+    lenInp -= sizeof(command_t);
+
+    if (lenInp != pCmd->lc)
+    {
+        PRINTF("=> /!\\ Incorrect apdu LC: %.*H\n", lenInp, pBuf);
+        return SW_WRONG_DATA_LENGTH;
+    }
+
+    PRINTF("=> CLA=%02X | INS=%02X | P1=%02X | P2=%02X | Lc=%02X | CData=%.*H\n",
+        pCmd->cla,
+        pCmd->ins,
+        pCmd->p1,
+        pCmd->p2,
+        pCmd->lc,
+        pCmd->lc,
+        pCmd->data);
+
+    if (pCmd->cla != 0xE0) // CLA
+        return SW_CLA_NOT_SUPPORTED;
+
+    if ('B' != pCmd->ins)
+        return SW_INS_NOT_SUPPORTED;
+
+    uint8_t* pIn = pCmd->data;
+
+    uint32_t* pSizeOut = (uint32_t *) pLen;
+    _Static_assert(sizeof(*pLen) == sizeof(*pSizeOut), "");
+
+#if c_Apdu_ChainMax
+
+    uint16_t sw = pCmd->p2 ? SW_WRONG_P1P2 : SW_OK;
+    if ((SW_OK == sw) && pCmd->p1)
+        sw = Apdu_ChainAdd(pCmd->p1, pIn, lenInp);
+
+    if (SW_OK != sw)
+    {
+        Apdu_ChainDrop();
+        return sw;
+    }
+
+    if (pCmd->p1)
+    {
+        if (pCmd->p1 & c_Apdu_P1_More)
+        {
+            uint32_t nSize = g_ApduChain.m_Size;
+            *pSizeOut = nBufSize - sizeof(uint16_t);
+
+            if (OnBeamHostRequestPart(g_ApduChain.m_pBuf, &nSize, pBuf, pSizeOut))
+                Apdu_ChainDrop(); // failed, the response is ready
+            else
+            {
+                g_ApduChain.m_Size = (uint16_t) nSize;
+                *pSizeOut = 0;
+            }
+
+            return SW_OK; // wait for the rest
+        }
+
+        pIn = g_ApduChain.m_pBuf;
+        lenInp = g_ApduChain.m_Size;
+
+        Apdu_ChainReset(); // complete
+    }
+    else
+        Apdu_ChainDrop(); // by the standalone request, if pending
+
+#else // c_Apdu_ChainMax
+
+    if (pCmd->p1 || pCmd->p2)
+        return SW_WRONG_P1P2;
+
+#endif // c_Apdu_ChainMax
+
+    *pSizeOut = nBufSize - sizeof(uint16_t);
+
+    OnBeamHostRequest(pIn, lenInp, pBuf, pSizeOut);
+
+    return SW_OK;
+}
@@ -0,0 +1,50 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+// APDU transport of the KeyKeeper requests (CLA=E0, INS='B').
+// A request that doesn't fit a single APDU is sent in a chain of frames, flagged by P1:
+//   c_Apdu_P1_More - more frames follow. The data is accumulated (or consumed by the streamed requests), the response is empty
+//   c_Apdu_P1_Cont - continues the chain of the preceding frames, otherwise a new one is started
+// The unflagged frame is a standalone request, as before. Any rejected frame drops the chain.
+#define c_Apdu_P1_More 0x01
+#define c_Apdu_P1_Cont 0x02
+
+// Max size of the chained request (its unconsumed part, for the streamed ones). Not on the Nano S, there the chaining is rejected (SW_WRONG_P1P2)
+#ifndef c_Apdu_ChainMax
+#   ifdef BeamCrypto_ScarceStack
+#       define c_Apdu_ChainMax 0
+#   else // BeamCrypto_ScarceStack
+#       define c_Apdu_ChainMax 1024
+#   endif // BeamCrypto_ScarceStack
+#endif // c_Apdu_ChainMax
+
+// Handles the received APDU of *pLen bytes in pBuf. The response data is written to pBuf (*pLen is set to its size),
+// the status word is returned
+uint16_t Apdu_OnRcv(uint8_t* pBuf, uint32_t nBufSize, int* pLen);
+
+// The complete (reassembled) request. Implemented by the app
+void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSizeOut);
+
+// The chained request arrived so far, after each non-final frame. The streamed requests are consumed on the fly (see KeyKeeper_InvokePart),
+// the rest is left as-is. Implemented by the app.
+// Returns nonzero if the request has failed, then the response is in pOut, and the chain is dropped
+int OnBeamHostRequestPart(uint8_t* pIn, uint32_t* pnIn, uint8_t* pOut, uint32_t* pSizeOut);
+
+// The pending chain is dropped: by a rejected or failed frame, a standalone request, or a new chain. pIn is what remains of it.
+// Implemented by the app, the streamed request must discard what it has already consumed (see KeyKeeper_AbortPart)
+void OnBeamHostRequestDrop(const uint8_t* pIn, uint32_t nIn);
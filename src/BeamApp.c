@@ -575,6 +575,9 @@ bool InitMasterKey()
             memset(pKk, 0, sizeof(*pKk));
 
             Kdf_Init(&pKk->m_MasterKey, &u.hv0);
+#if c_KeyKeeper_nPKdf
+            KeyKeeper_InitMasterPub(pKk); // the wallet requests it on every connect
+#endif // c_KeyKeeper_nPKdf
 
             bOk = true;
 		}
@@ -1086,7 +1089,7 @@ void Gej_Get_Affine(const gej_t* p, AffinePoint* pAp)
 #endif // BeamCrypto_ExternalGej
 
 
-void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSizeOut)
+static void OnBeamHostRequestBegin()
 {
     if (!g_Computing.m_TicksRemaining)
     {
@@ -1099,17 +1102,16 @@ void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSiz
     }
 
     g_Computing.m_TicksRemaining = 20; // 2 seconds
+}
 
-    uint16_t errCode = KeyKeeper_Invoke(KeyKeeper_Get(), pIn, nIn, pOut, pSizeOut);
-
+static uint16_t OnBeamHostRequestEnd(uint16_t errCode, uint8_t* pOut, uint32_t* pSizeOut)
+{
 #ifdef BeamCrypto_ExternalGej
     if (!Gej_Finalyze())
         errCode = c_KeyKeeper_Status_InternalError;
 #endif // BeamCrypto_ExternalGej
 
-    if (c_KeyKeeper_Status_Ok == errCode)
-        pOut[0] = c_KeyKeeper_Status_Ok;
-    else
+    if (c_KeyKeeper_Status_Ok != errCode)
     {
         // return distinguishable error message
         pOut[0] = (uint8_t) errCode;
@@ -1121,6 +1123,35 @@ void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSiz
 
     if (1 == g_Computing.m_TicksRemaining)
         OnStepComputingClosed();
+
+    return errCode;
+}
+
+void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSizeOut)
+{
+    OnBeamHostRequestBegin();
+
+    uint16_t errCode = KeyKeeper_Invoke(KeyKeeper_Get(), pIn, nIn, pOut, pSizeOut);
+
+    if (c_KeyKeeper_Status_Ok == OnBeamHostRequestEnd(errCode, pOut, pSizeOut))
+        pOut[0] = c_KeyKeeper_Status_Ok;
+}
+
+int OnBeamHostRequestPart(uint8_t* pIn, uint32_t* pnIn, uint8_t* pOut, uint32_t* pSizeOut)
+{
+    if (!KeyKeeper_IsStreamed(pIn, *pnIn))
+        return 0; // just accumulated, nothing to compute yet
+
+    OnBeamHostRequestBegin();
+
+    uint16_t errCode = KeyKeeper_InvokePart(KeyKeeper_Get(), pIn, pnIn);
+
+    return c_KeyKeeper_Status_Ok != OnBeamHostRequestEnd(errCode, pOut, pSizeOut);
+}
+
+void OnBeamHostRequestDrop(const uint8_t* pIn, uint32_t nIn)
+{
+    KeyKeeper_AbortPart(KeyKeeper_Get(), pIn, nIn);
 }
 
 UX_STEP_CB(ux_step_alert, bb, EndModal(c_Modal_Ok), { g_szLine1, g_szLine2 });
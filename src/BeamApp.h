@@ -20,6 +20,7 @@
 
 #include "os.h"
 #include "ux.h"
+#include "Apdu.h" // OnBeamHostRequest
 
 // Modal loop emulation
 uint8_t DoModal();
@@ -41,8 +42,6 @@ void BeamStackTest1();
 void BeamStackTest2();
 void BeamStackTest3();
 
-void OnBeamHostRequest(uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pSizeOut);
-
 void ui_menu_main();
 void ui_menu_initial(); // can be different from main for testing
 void ui_menu_about();
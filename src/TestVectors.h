@@ -0,0 +1,43 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Protocol request/response layouts and recorded request sequences, shared by the on-device tests
+// and the host benchmark.
+
+#include "hw_crypto/keykeeper.h"
+
+#pragma pack (push, 1)
+#define THE_FIELD(type, name) type m_##name;
+
+#define THE_MACRO(id, name) \
+typedef struct { uint8_t m_OpCode; BeamCrypto_ProtoRequest_##name(THE_FIELD) } Proto_In_##name; \
+typedef struct { uint8_t m_RetVal; BeamCrypto_ProtoResponse_##name(THE_FIELD) } Proto_Out_##name; \
+static const uint8_t g_Proto_Code_##name = id;
+
+BeamCrypto_ProtoMethods(THE_MACRO)
+#undef THE_MACRO
+#undef THE_FIELD
+
+#pragma pack (pop)
+
+// TxSendShielded sequence (master key seed = 0): TxAddCoins, AuxWrite x5 (ShieldedOutParams), TxSendShielded
+static const uint8_t g_pMsgSendShielded0[] = { 0x18,0x01,0x02,0x01,0x01,0x06,0xe4,0x52,0xb1,0xce,0x54,0x9d,0xaa,0x6d,0x72,0x6f,0x6e,0x00,0x00,0x00,0x03,0xe0,0xc8,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0xf5,0x0e,0x5d,0x88,0x33,0x08,0x5f,0x6d,0x72,0x6f,0x6e,0x00,0x00,0x00,0x03,0x30,0x88,0x01,0x00,0x00,0x00,0x00,0x00,0x78,0x56,0x34,0x12,0xd6,0xb6,0xea,0x68,0x2a,0x96,0x23,0x5e,0x6d,0x72,0x6f,0x6e,0x00,0x00,0x00,0x03,0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x4c,0xc6,0x4d,0x16,0xed,0x2a,0x39,0x89,0x10,0x44,0x2c,0xca,0xfc,0x86,0xcb,0x84,0xfa,0x7d,0x9f,0x39,0x01,0xa0,0x0e,0x61,0x49,0xaf,0x8a,0x0d,0xd6,0x29,0xa7,0x66,0xa5,0x6b,0xde,0x73,0x32,0x2b,0x93,0x54,0xdf,0xb8,0x97,0x3b,0x74,0x26,0x9f,0xc0,0x29,0xc0,0x1c,0x0b,0x29,0x55,0x5c,0xb7,0x80,0xda,0x1b,0x22,0x84,0x52,0x38,0xaa,0x69,0x81,0xcc,0x95,0x25,0x53,0x6c,0x6c,0x5d,0x23,0x01,0xa0,0xe3,0x73,0x9a,0x88,0x0e,0x71,0x8f,0xb1,0xbb,0x6f,0x47,0xe0,0x5b,0xbb,0xf5,0x0a,0x8d,0x82,0xcd,0x5c,0x61,0x68,0x82,0x5f,0xae,0x85,0x32,0xa0,0x65,0xe4,0xf2,0x2e,0xcf,0x6d,0xa8,0x10,0x3f,0x24,0x86,0x55,0x81,0xd7,0x82,0xdf,0xf5,0xf5,0x1b,0xd6,0x87,0x82,0x21,0x61,0x00,0x90,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x2c,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x16,0x4d,0xc6,0x4c };
+static const uint8_t g_pMsgSendShielded1[] = { 0x28,0x00,0x00,0xe6,0x00,0x4c,0x23,0x6c,0xd0,0x76,0xa0,0x98,0xbf,0xff,0x94,0x54,0x1c,0xa6,0xa5,0x9b,0x35,0xc0,0x4d,0xb4,0x39,0xb8,0x40,0xe8,0xd6,0xc0,0xc1,0x6f,0x61,0x72,0xdd,0xf9,0x7d,0xc5,0x06,0x47,0x64,0xe1,0x13,0x29,0x86,0xe2,0xf3,0xee,0xdb,0xa8,0xab,0xbc,0x12,0x34,0x19,0xdb,0x34,0x9e,0x77,0x7a,0xed,0x0a,0xec,0xbb,0x06,0x5c,0xed,0x85,0xa6,0xff,0x69,0x6b,0x8c,0xb4,0x05,0xdb,0x9f,0x64,0x76,0x8d,0xd8,0x86,0xf9,0x3c,0xea,0xf8,0x99,0x0c,0x9b,0x30,0xaa,0x6a,0x28,0x39,0x74,0xd9,0x8a,0x9e,0x64,0x77,0x52,0xdf,0xa6,0x7a,0x4b,0x56,0x55,0x35,0x48,0x0d,0xfc,0x60,0xbd,0xfa,0x7d,0x34,0x12,0xd8,0xfb,0x8e,0x24,0x0d,0x71,0xfb,0xbf,0x2c,0x33,0x4a,0x30,0x51,0x5c,0x29,0x90,0xd6,0xb3,0xb2,0xfb,0x03,0xe5,0x3c,0x7a,0xb5,0x14,0xce,0x49,0x54,0x2d,0x1e,0x1a,0x6c,0x96,0xab,0xc0,0x88,0xbe,0xa5,0x70,0xac,0xb2,0xa8,0xe9,0xcd,0xdb,0x57,0x14,0x5d,0x19,0x04,0x7d,0x43,0x7d,0x73,0x7e,0x76,0xa7,0x36,0x3e,0x76,0x3a,0xc9,0x6d,0x6d,0xfb,0x5d,0x94,0x8a,0x8e,0x37,0xa9,0x32,0x1b,0xab,0x3e,0x99,0x49,0x51,0x9f,0x7d,0xf8,0x06,0x7d,0xa7,0xee,0x86,0xa7,0x09,0x16,0x3b,0x68,0xce,0xf3,0xa1,0xd0,0x22,0x7c,0x15,0x42,0x91,0x67,0xd1,0xd6,0x1a,0xe0,0x87,0xd2,0x57,0x42,0x87,0x9c,0x4d,0xdb,0xb2,0x64,0x2e,0x52 };
+static const uint8_t g_pMsgSendShielded2[] = { 0x28,0xe6,0x00,0xe6,0x00,0x28,0x7a,0x49,0xad,0x2e,0x67,0xdb,0x8c,0xa7,0xb4,0x8f,0x51,0x1e,0x6b,0x48,0x99,0x18,0xd7,0x2e,0x0e,0xaa,0xb2,0x46,0xe1,0x50,0x71,0x4b,0xaa,0xc2,0xda,0x36,0xf2,0x3a,0x13,0x96,0x45,0x84,0xc3,0x16,0x6a,0x49,0xc9,0xec,0x7e,0xc5,0xba,0xdb,0x71,0x7a,0x02,0x8b,0x1c,0x2f,0x07,0x35,0xae,0x9b,0x4e,0x62,0xa5,0xdd,0x21,0x97,0xfb,0x44,0x0b,0x16,0x91,0xf6,0x1f,0x77,0xd3,0x14,0xf7,0xdc,0x9c,0xa2,0x5c,0x46,0x86,0x18,0x31,0x13,0x83,0xa1,0x5d,0x65,0x99,0x09,0xbc,0x5c,0x69,0x07,0xd7,0xce,0xd0,0x40,0x28,0xcb,0x2f,0xfe,0xb2,0x09,0x24,0x5e,0x3e,0x16,0x81,0xbf,0x35,0xc1,0x02,0xd9,0xb3,0x6e,0x66,0x61,0x46,0x9d,0x66,0x75,0x1f,0xe8,0x1f,0x07,0xa0,0x29,0x14,0xdc,0x70,0x92,0x3c,0xff,0xe0,0x3c,0x98,0xdc,0x01,0x93,0xba,0x87,0x59,0x59,0x94,0xcd,0x06,0x36,0xb3,0xc7,0xfb,0x37,0xea,0x0d,0xc9,0x5e,0x3b,0x0c,0x0a,0x56,0x99,0x23,0xe8,0x8b,0xf4,0x82,0xa8,0xe3,0x1f,0xf6,0x4f,0x1f,0x7c,0x1f,0x4f,0x42,0x56,0xf0,0x01,0xbc,0x59,0x5f,0xd7,0x1b,0x33,0x49,0xf5,0xa7,0xa2,0xc4,0x0f,0x5c,0x20,0x87,0x86,0x3a,0xd1,0xf2,0x5a,0xb6,0x5a,0x9a,0xc4,0x85,0xfe,0x66,0xeb,0x74,0x19,0x63,0x21,0xd6,0xb4,0x1a,0x3e,0x4f,0x6d,0x81,0xa3,0xed,0xc0,0x69,0x89,0x94,0x0a,0xa8,0x58,0x2b,0xa7,0x15,0x86 };
+static const uint8_t g_pMsgSendShielded3[] = { 0x28,0xcc,0x01,0xe6,0x00,0x34,0x18,0xad,0xb9,0x73,0xc7,0xbb,0x12,0xc7,0x23,0x0f,0x39,0x95,0xaa,0x7e,0x49,0x74,0x61,0x4e,0x16,0x42,0x33,0x30,0x11,0x4f,0x34,0x6f,0xdb,0x95,0x89,0xdc,0x99,0x67,0xce,0x7e,0x0c,0xff,0x12,0x89,0x8e,0x5b,0x7d,0x7c,0xc3,0xfc,0xba,0xf4,0x9a,0xb8,0xf7,0xd3,0xf8,0x8d,0x49,0xc9,0x5b,0xb4,0x60,0xde,0x04,0x9f,0x3c,0xfb,0xdc,0x7a,0x0c,0xb1,0x4d,0x0f,0x0e,0x0a,0x88,0x92,0xf9,0x0a,0x02,0xa9,0x8c,0x63,0xc5,0x87,0xff,0xdf,0x93,0x6a,0xef,0xaa,0xcd,0x89,0x71,0x6a,0xb9,0x17,0xf3,0x5f,0xa3,0xc3,0x52,0xd0,0x72,0xa9,0x8f,0xea,0x4f,0x53,0xc2,0xed,0xb0,0xb6,0xdc,0x0a,0x9c,0xf8,0xda,0xe0,0x2c,0x43,0x13,0xb4,0xd5,0x16,0xb9,0x49,0x8d,0x7d,0x98,0xb4,0xc8,0x30,0x7a,0xb6,0x07,0xcf,0xa6,0xa4,0x62,0x63,0x2e,0xb3,0xef,0x25,0xbe,0x9d,0x46,0xd2,0x91,0x2c,0x5e,0xbb,0x8b,0x34,0xce,0xb9,0x2f,0x78,0xaa,0x03,0x2d,0xc1,0x12,0x55,0x44,0xb0,0x8b,0x51,0x2f,0x51,0xa9,0x1e,0x82,0x6b,0x2e,0xd3,0xba,0x4b,0x4f,0x64,0xc1,0x6b,0x1a,0x32,0xa0,0xcf,0x92,0xd4,0xda,0xd9,0x74,0x7a,0x4e,0x89,0x63,0xe5,0xba,0xc8,0x31,0xfd,0x7b,0x7d,0xe3,0x7c,0x04,0x06,0xb9,0x00,0x31,0x33,0x7c,0x2d,0xa2,0x1b,0x94,0x2b,0x14,0x81,0xa4,0xcd,0x7f,0xca,0x42,0x38,0x55,0xce,0x72,0xf7,0x96,0xf0,0x29,0xbf,0x90 };
+static const uint8_t g_pMsgSendShielded4[] = { 0x28,0xb2,0x02,0xe6,0x00,0xdb,0x15,0xea,0x81,0x33,0x86,0xc5,0xf7,0x6a,0xd8,0x71,0xf6,0x37,0xb9,0x06,0x80,0xfa,0xe7,0xd5,0x86,0x32,0xce,0x23,0x2f,0x29,0x78,0xef,0x4d,0xbd,0x09,0x1f,0x6f,0x95,0xdd,0xd8,0x4c,0xbb,0x34,0xda,0xef,0xaa,0x42,0x27,0xee,0x1d,0x06,0xca,0x5a,0x01,0x61,0xc1,0xcf,0xb7,0x3e,0x8f,0x29,0x8d,0x9b,0xec,0x47,0x2e,0x17,0xf3,0x07,0xa1,0x70,0xa4,0x6c,0xa0,0xad,0x9f,0x28,0xbf,0xe3,0xec,0x92,0x44,0x34,0xaa,0x2a,0x0c,0x01,0x05,0x78,0x84,0x81,0x29,0x74,0x1d,0x6e,0x52,0xb8,0x5b,0xd7,0xe1,0x08,0x75,0x51,0x29,0x5e,0x65,0xd6,0x2c,0x07,0x02,0x2b,0x97,0x6a,0x0a,0xce,0xf7,0x9b,0x98,0x96,0x94,0x97,0xc5,0x2c,0x53,0x5a,0x57,0x29,0xdb,0xe4,0xfd,0xd5,0x58,0x8f,0xf7,0xa7,0x7f,0x0e,0x6b,0x3c,0xa2,0x45,0x6e,0x15,0x33,0x95,0x54,0xa1,0x37,0xa1,0xd8,0xc6,0x01,0xd4,0x88,0xa4,0xca,0x26,0x11,0x8f,0xd7,0xb0,0x2c,0xee,0xfd,0x03,0x5e,0x54,0x7b,0x04,0xc5,0xfd,0xd1,0xb8,0xdf,0x76,0x84,0x6d,0x0d,0x2b,0x30,0x18,0x15,0x1b,0xf5,0x00,0xc5,0xf4,0x60,0xda,0xfa,0x2a,0xeb,0x35,0x7a,0x63,0x0c,0x1a,0x03,0x66,0x09,0x0b,0x50,0x2c,0x8f,0x63,0x56,0xd2,0x9c,0xf9,0x0e,0x80,0xed,0x40,0x3c,0xb0,0xe6,0xdd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd };
+static const uint8_t g_pMsgSendShielded5[] = { 0x28,0x98,0x03,0x0e,0x00,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd,0xcd };
+static const uint8_t g_pMsgSendShielded6[] = { 0x36,0xe0,0xc8,0x10,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x2b,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xfe,0x02,0x32,0xd7,0xa8,0x40,0xd8,0xb9,0x5a,0x20,0xfa,0xe8,0xe6,0xbb,0x19,0x7e,0xa7,0x67,0x86,0xd9,0x91,0xf3,0x1f,0x6a,0x77,0x14,0x78,0xcc,0x85,0x69,0x18,0xd6,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xba,0x06,0xbb,0x98,0x85,0x80,0x1d,0x0b,0x90,0x49,0xd5,0x25,0x09,0xd0,0x70,0xfe,0x0e,0xa6,0x5e,0x0a,0xc1,0xbb,0x97,0xa0,0xc4,0x88,0x17,0x13,0x6d,0xe6,0x60,0xfd,0x88,0x99,0x97,0xec,0xf7,0x42,0xd5,0xa1,0x2e,0x9d,0x52,0xd4,0x15,0x5e,0x39,0xe9,0x93,0x41,0x89,0x1d,0x9e,0xe8,0x44,0xa7,0x66,0x7c,0x64,0xcc,0xe0,0x0f,0xd7,0xf3,0x5b,0x1d,0x62,0x54,0x91,0x7b,0x9e,0xb2,0x16,0x4b,0x6b,0x80,0xe4,0x94,0x0c,0x32,0x4a,0x4e,0xe7,0x55,0x7a,0xfd,0x19,0x12,0xc5,0x96,0x8b,0x66,0x37,0x42,0x6d,0x8f,0x77,0x9a,0xc2,0x63,0xee,0xd4,0xe7,0x65,0x31,0xf3,0x50,0x27,0xba,0x08,0x54,0x48,0x78,0x11,0xad,0x98,0x11,0xd2,0x3a,0x63,0xf2,0xaf,0x98,0xb3,0xd6,0x18,0x2d,0x76,0x01,0x01,0x00 };
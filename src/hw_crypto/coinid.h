@@ -36,3 +36,9 @@ typedef struct
 
 uint32_t CoinID_getSubkey(const CoinID*);
 void CoinID_getHash(const CoinID*, UintBig*);
+void CoinID_GetAssetGen(AssetID, secp256k1_ge*); // hash-to-curve, not cached
+
+#ifdef BeamCrypto_Sha256Accel
+// Batched (multi-buffer) variant, up to c_Sha256_Lanes at once
+void CoinID_getHash_N(const CoinID* const* ppCid, UintBig* const* ppHash, unsigned int n);
+#endif // BeamCrypto_Sha256Accel
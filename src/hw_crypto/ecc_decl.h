@@ -16,6 +16,52 @@
 
 #define USE_BASIC_CONFIG
 
+#ifdef BeamCrypto_OpCounters
+
+#include <stdint.h>
+
+// Exact counts of the heavy primitives, machine-independent. Not thread-safe, meant for profiling and tests.
+typedef struct
+{
+	uint32_t m_FeMul;
+	uint32_t m_FeSqr;
+	uint32_t m_FeInv;
+	uint32_t m_FeSqrt;
+	uint32_t m_GejDouble;
+	uint32_t m_GejAdd;
+	uint32_t m_ScalarMul;
+	uint32_t m_ScalarInv;
+	uint32_t m_Sha256; // compressions
+
+} OpCounters;
+
+extern OpCounters g_OpCounters;
+
+#define SECP256K1_OPCOUNT(op) g_OpCounters.m_##op++
+
+#endif // BeamCrypto_OpCounters
+
+#ifdef BeamCrypto_Sha256Accel
+
+#include <stdint.h>
+
+// Platform-specific SHA-256 compression (host build), selected at startup. Null if not supported by the CPU, then the portable one is used.
+typedef void (*Sha256_Transform_t)(uint32_t* pState, const uint8_t* pBlock);
+extern Sha256_Transform_t g_pfnSha256Transform;
+
+#define SECP256K1_SHA256_TRANSFORM_EXT(s, buf) (g_pfnSha256Transform && (g_pfnSha256Transform(s, buf), 1))
+
+// Multi-buffer compression of c_Sha256_Lanes independent (state, block) pairs in lockstep.
+// Selected only if it outperforms the single-buffer one (i.e. not together with the SHA extensions), otherwise null.
+#define c_Sha256_Lanes 8
+typedef void (*Sha256_TransformLanes_t)(uint32_t* const* ppState, const uint8_t* const* ppBlock);
+extern Sha256_TransformLanes_t g_pfnSha256TransformLanes;
+
+// The multi-buffer implementation if supported by the CPU, regardless of the selection (for tests)
+Sha256_TransformLanes_t Sha256Accel_GetLanes(void);
+
+#endif // BeamCrypto_Sha256Accel
+
 #if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
 #	pragma GCC diagnostic push
 #	pragma GCC diagnostic ignored "-Wunused-function"
@@ -42,7 +88,9 @@ typedef secp256k1_hmac_sha256 secp256k1_hmac_sha256_t;
 #	pragma warning (pop)
 #endif
 
-#define static_assert(a, b) _Static_assert(a, b)
+#ifndef static_assert
+#	define static_assert(a, b) _Static_assert(a, b)
+#endif // static_assert
 
 #define c_ECC_nBytes sizeof(secp256k1_scalar)
 #define c_ECC_nBits (c_ECC_nBytes * 8)
@@ -86,5 +134,8 @@ void Gej_Mul2_Fast(gej_t* p, const gej_t* a, const UintBig* ka, const gej_t* b,
 void Gej_Set_Affine(gej_t* p, const AffinePoint* pAp);
 void Gej_Get_Affine(const gej_t* p, AffinePoint* pAp);
 
+#else // BeamCrypto_ExternalGej
+
+typedef secp256k1_gej gej_t;
 
 #endif // BeamCrypto_ExternalGej
@@ -0,0 +1,61 @@
+// Generated by beamhw_gencontext --salts.
+// HMAC-SHA256 keyed by the constant NonceGenerator salts (with the terminating 0): the states after the ipad and opad blocks.
+
+#pragma once
+
+#define HMacSalt_beam_Key { \
+	{ 0x23b14ecd,0x82a174dd,0x5337d2e7,0x672e8705,0x9842f350,0x248407af,0x720868f2,0xdc696484, }, \
+	{ 0x75ab99dd,0xd5f645ea,0x57d6c38a,0x96828eb4,0x244ec3f5,0xc2c33bb8,0xf8cf99e9,0x8a618ce5, } } // "beam-Key"
+
+#define HMacSalt_beam_HKdf { \
+	{ 0x52eaea3c,0x569bfe4c,0xfac44940,0x3e848f41,0xde5141b2,0xfa5aa9b3,0x0b2ec0c9,0x0c7b93ac, }, \
+	{ 0xcb0f8c72,0x543be953,0x30776cbe,0xe37da588,0xe80d21ec,0x367418f2,0x74c97c64,0xf8703ff3, } } // "beam-HKdf"
+
+#define HMacSalt_beam_Schnorr { \
+	{ 0xe6ddb0c3,0x4ba3ff09,0x0d70de96,0xd9692108,0x0758bf6d,0x34f3c585,0xc75e11dc,0x0a2d1fb6, }, \
+	{ 0xd7848e4b,0xb0240792,0x7cb63ada,0x4769465e,0xaf50c749,0x9d29066e,0x72720af7,0x8cccdfa7, } } // "beam-Schnorr"
+
+#define HMacSalt_bulletproof { \
+	{ 0xa959938b,0xdccb2259,0x05ef10f9,0x7d1ee1cf,0x8e3bf9b1,0x5cedfedb,0xb7b7fc27,0x2bb40937, }, \
+	{ 0xa1d9908d,0xfe660bfc,0xe0ead15e,0x5134ce8a,0x61401795,0xc2179144,0x54a869d4,0xc5eb53e0, } } // "bulletproof"
+
+#define HMacSalt_bulletproof_sk { \
+	{ 0xe475d7aa,0x586aecb0,0x220b9289,0xfdf95814,0xe2acd074,0x7e083c55,0x11add904,0xa086ee3a, }, \
+	{ 0x92c46173,0x84039c74,0x16ba4e37,0x938dcaf7,0x1e2b3ae8,0x8e8f0858,0x73a290aa,0x61a10748, } } // "bulletproof-sk"
+
+#define HMacSalt_bp_key { \
+	{ 0x099e4fb1,0x3fd8312a,0x335e41d7,0x1ba833f0,0x27f99e76,0x2f9e93b2,0xa921f4ed,0x56d70a0d, }, \
+	{ 0xb91f693e,0x3556e0ec,0x338450b0,0x66e9db99,0x827daf6f,0x42d8cfb1,0x713f3f71,0xd24cc494, } } // "bp-key"
+
+#define HMacSalt_hw_wlt_split { \
+	{ 0x6fee43b5,0xa9057a86,0x92e0050c,0x6e269acd,0x7cb9cec9,0xa015fdcf,0x34c4ca04,0xc0e90507, }, \
+	{ 0xebc9a551,0xce0bc3eb,0x687830a6,0xa5ccce35,0x693703ec,0x98a7ee52,0xe9b503ce,0x79a31df0, } } // "hw-wlt-split"
+
+#define HMacSalt_hw_wlt_rcv { \
+	{ 0x1eae60ad,0x986064be,0x017e9908,0x6e9a6e62,0xc5f1bcfe,0xe14cb733,0xb89845d2,0x158a7adf, }, \
+	{ 0x832c3fc3,0xd59f34d8,0x9b9cb4a7,0x74a123fc,0x943839cb,0x5f015734,0x6e29f675,0xaf6b09b0, } } // "hw-wlt-rcv"
+
+#define HMacSalt_hw_wlt_snd { \
+	{ 0xe6ed687e,0x92685769,0xf57e8381,0x983ece2f,0x330a6eaf,0x7bf7bed7,0xa1951f73,0x7115bc75, }, \
+	{ 0xc34631f0,0x7cfd2ccb,0xf713cd34,0xd94333be,0x5e61c1a2,0x8a803be6,0xbb2fab37,0xd12e987b, } } // "hw-wlt-snd"
+
+#define HMacSalt_hw_wlt_snd_sh { \
+	{ 0x5631a084,0xd407f568,0xb001e896,0xd46fa1d6,0x3ec5c57d,0x45003c92,0xe37e7a07,0x9e6b2b33, }, \
+	{ 0xeb542354,0xad3adf3b,0xc4066201,0x0e443cab,0xdb6110a8,0xe0d47d07,0x53b19d0c,0xa0d5daf9, } } // "hw-wlt-snd-sh"
+
+#define HMacSalt_beam_lelantus_1 { \
+	{ 0xcb9d1472,0xfc3da20e,0x06457572,0x60747c3b,0x67689a0a,0x4dac9ba9,0x6addc76c,0xa5d8b3f6, }, \
+	{ 0xe2bffb3c,0x9a551241,0x71805014,0x2fd95a75,0x12e1e4ac,0x9622b9b5,0xf650061a,0x5c9503c8, } } // "beam.lelantus.1"
+
+#define HMacSalt_beam_lelantus_2 { \
+	{ 0x1ed11ecb,0x32bb3790,0x690fe0bc,0x33471aaf,0x829e8789,0x14fb8bf7,0xae78581d,0xdec4f45c, }, \
+	{ 0x113d008e,0xe82be635,0xc6b9ee75,0xa5282c4c,0xa8b31d83,0xd790083f,0x5ad93744,0xde76fd97, } } // "beam.lelantus.2"
+
+#define HMacSalt_kG_O { \
+	{ 0xcadb31d8,0xd57a087f,0x974124f1,0x8df9503f,0x169991a8,0x781b5825,0x1a38dd34,0x276678eb, }, \
+	{ 0x50cc4de1,0xbfaf2015,0x041dd6a3,0x0b3fa4ef,0x714951d0,0x500aaab8,0xdadc5fb1,0x90fff55f, } } // "kG-O"
+
+#define HMacSalt_skG_O { \
+	{ 0xad656c6e,0xb955b3d6,0x61b2ce22,0x14833a31,0xb1466221,0x8c3b29a9,0x68cf2d37,0x77e3334e, }, \
+	{ 0xbf61cc5d,0x0d9e835b,0x0f9a49b3,0x0dcf2c2c,0x37ffe873,0x6b74b43c,0x3f76ee4d,0xaaa07b6a, } } // "skG-O"
+
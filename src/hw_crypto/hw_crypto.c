@@ -102,10 +102,11 @@ void Suffer(uint16_t n)
 
 #endif // TARGET_NANOS
 
-#ifdef BeamCrypto_ExternalGej
-
+#ifdef BeamCrypto_OpCounters
+OpCounters g_OpCounters;
+#endif // BeamCrypto_OpCounters
 
-typedef gej_t CustomGenerator;
+#ifdef BeamCrypto_ExternalGej
 
 void Gej_Mul(gej_t* p, const gej_t* a, const secp256k1_scalar* k, int bFast)
 {
@@ -170,8 +171,6 @@ void Point_Ge_from_Gej(secp256k1_ge* pGe, const gej_t* p)
 
 #else // BeamCrypto_ExternalGej
 
-typedef secp256k1_gej gej_t;
-
 void Gej_Init(gej_t* p)
 {
 	UNUSED(p);
@@ -352,15 +351,124 @@ static void WNaf_Cursor_MoveNext(MultiMac_WNaf* p, const secp256k1_scalar* pK, u
 		p->m_iElement += nMaxElements;
 }
 
+#ifndef BeamCrypto_ScarceStack
+// Cursors are scheduled by their next bit: per-bit lists linked via m_iNext, so that each bit only visits the cursors that fire on it.
+// Not on the Nano S: the list heads take 512 bytes of stack, there each bit scans all the cursors instead.
+#define c_WNaf_Schedule_End 0xffff
+
+typedef uint16_t WNaf_Schedule[c_ECC_nBits];
+
+inline static void WNaf_Schedule_Push(WNaf_Schedule pHead, MultiMac_WNaf* pWnaf, unsigned int iCursor)
+{
+	assert(iCursor < c_WNaf_Schedule_End);
+
+	pWnaf[iCursor].m_iNext = pHead[pWnaf[iCursor].m_iBit];
+	pHead[pWnaf[iCursor].m_iBit] = (uint16_t) iCursor;
+}
+#endif // BeamCrypto_ScarceStack
+
 static void MultiMac_Calculate_LoadFast(const MultiMac_Context* p, secp256k1_ge* pGe, unsigned int iGen, unsigned int iElem)
 {
 	unsigned int nPitch = c_MultiMac_OddCount(p->m_Fast.m_WndBits);
 	assert(iElem < nPitch);
 
+#ifdef c_MultiMac_Glv_MaxCount
+	int bNeg = (p->m_Glv.m_NegMsk >> iGen) & 1;
+	int bLambda = p->m_Glv.m_nHalf && (iGen >= p->m_Glv.m_nHalf);
+	if (bLambda)
+		iGen -= p->m_Glv.m_nHalf;
+#endif // c_MultiMac_Glv_MaxCount
+
 	unsigned int n = nPitch * iGen + iElem;
 	secp256k1_ge_from_storage(pGe, p->m_Fast.m_pGen0 + n);
+
+#ifdef c_MultiMac_Glv_MaxCount
+	if (bLambda)
+		secp256k1_ge_mul_lambda(pGe, pGe); // lambda*(x, y) == (beta*x, y), also valid for the common z-denominator
+	if (bNeg)
+		secp256k1_ge_neg(pGe, pGe);
+#endif // c_MultiMac_Glv_MaxCount
+}
+
+#ifdef c_MultiMac_Buckets_MinCount
+
+static unsigned int MultiMac_Buckets_GetWnd(const secp256k1_scalar* pK, unsigned int iBit, unsigned int nBits)
+{
+	unsigned int iWord = iBit / secp256k1_scalar_WordBits;
+	unsigned int nShift = iBit % secp256k1_scalar_WordBits;
+
+	unsigned int val = (unsigned int) (pK->d[iWord] >> nShift);
+	if (nShift + nBits > secp256k1_scalar_WordBits)
+		val |= (unsigned int) (pK->d[iWord + 1] << (secp256k1_scalar_WordBits - nShift));
+
+	return val & ((1U << nBits) - 1);
+}
+
+static void MultiMac_Buckets_SetWnd(secp256k1_scalar* pK, unsigned int iBit, unsigned int nBits, unsigned int val)
+{
+	unsigned int iWord = iBit / secp256k1_scalar_WordBits;
+	unsigned int nShift = iBit % secp256k1_scalar_WordBits;
+	const secp256k1_scalar_uint nMsk = (1U << nBits) - 1;
+
+	val &= nMsk;
+	pK->d[iWord] = (pK->d[iWord] & ~(nMsk << nShift)) | (((secp256k1_scalar_uint) val) << nShift);
+
+	if (nShift + nBits > secp256k1_scalar_WordBits)
+	{
+		unsigned int nLow = secp256k1_scalar_WordBits - nShift;
+		pK->d[iWord + 1] = (pK->d[iWord + 1] & ~(nMsk >> nLow)) | (val >> nLow);
+	}
+}
+
+inline static unsigned int MultiMac_Buckets_GetWidth(unsigned int iBit, unsigned int nWndBits)
+{
+	// the topmost window may be partial
+	unsigned int nRemaining = c_ECC_nBits - iBit;
+	return (nRemaining < nWndBits) ? nRemaining : nWndBits;
+}
+
+static int MultiMac_Buckets_Recode(secp256k1_scalar* pK, unsigned int nWndBits)
+{
+	// In-place signed-digit recoding. A window value above OddCount(nWndBits) stands for (value - 2^nWndBits), compensated by a carry into the next window.
+	// The topmost partial window is never negative. The carry out of the topmost window is returned, the caller should account for it.
+	unsigned int nHalf = c_MultiMac_OddCount(nWndBits);
+	unsigned int carry = 0;
+
+	for (unsigned int iBit = 0; iBit < c_ECC_nBits; iBit += nWndBits)
+	{
+		unsigned int nWidth = MultiMac_Buckets_GetWidth(iBit, nWndBits);
+		unsigned int val = MultiMac_Buckets_GetWnd(pK, iBit, nWidth) + carry;
+
+		carry = (val > nHalf) || (val >> nWidth);
+		MultiMac_Buckets_SetWnd(pK, iBit, nWidth, val);
+	}
+
+	return carry;
+}
+
+static unsigned int MultiMac_Buckets_GetWndBits(unsigned int nCount)
+{
+	// per window: nCount bucket additions (gej+ge), and 2 running-sum additions (gej+gej, ~1.5 times heavier) per bucket
+	unsigned int nBest = 0;
+	uint32_t nCostBest = 0;
+
+	for (unsigned int nWndBits = 2; nWndBits <= c_MultiMac_Buckets_nBitsMax; nWndBits++)
+	{
+		uint32_t nWnds = (c_ECC_nBits + nWndBits - 1) / nWndBits;
+		uint32_t nCost = nWnds * (nCount * 2 + c_MultiMac_OddCount(nWndBits) * 6);
+
+		if (!nBest || (nCost < nCostBest))
+		{
+			nBest = nWndBits;
+			nCostBest = nCost;
+		}
+	}
+
+	return nBest;
 }
 
+#endif // c_MultiMac_Buckets_MinCount
+
 #endif // BeamCrypto_ExternalGej
 
 void Point_Gej_from_Ge(gej_t*, const secp256k1_ge*);
@@ -439,44 +547,84 @@ static void wrap_gej_add_zinv_var(gej_t* r, const gej_t* a, const secp256k1_ge*
 }
 
 __stack_hungry__
-static void MultiMac_Calculate_PrePhase(MultiMac_Context* const p)
+#ifdef BeamCrypto_ScarceStack
+static unsigned int MultiMac_Calculate_PrePhase(MultiMac_Context* const p, unsigned int nBucketBits)
+#else // BeamCrypto_ScarceStack
+static unsigned int MultiMac_Calculate_PrePhase(MultiMac_Context* const p, WNaf_Schedule pSchedule, unsigned int nBucketBits)
+#endif // BeamCrypto_ScarceStack
 {
+	// returns the needed length of the doubling chain
 	secp256k1_gej_set_infinity(p->m_pRes);
 
 	if (!p->m_Fast.m_Count)
 	{
 		p->m_Fast.m_pZDenom = 0;
-		return;
+		return c_ECC_nBits;
 	}
 
+	// without 'secure' scalars and carries the chain can start at the topmost wNAF window
+	unsigned int nBits = (nBucketBits || p->m_Secure.m_Count) ? c_ECC_nBits : 0;
+
+#ifndef BeamCrypto_ScarceStack
+	for (unsigned int iBit = 0; iBit < c_ECC_nBits; iBit++)
+		pSchedule[iBit] = c_WNaf_Schedule_End;
+#endif // BeamCrypto_ScarceStack
+
 	for (unsigned int i = 0; i < p->m_Fast.m_Count; i++)
 	{
 		MultiMac_WNaf* pWnaf = p->m_Fast.m_pWnaf + i;
 		secp256k1_scalar* pS = p->m_Fast.m_pK + i;
 
+#ifdef c_MultiMac_Buckets_MinCount
+		int carry = nBucketBits ?
+			MultiMac_Buckets_Recode(pS, nBucketBits) :
+			WNaf_Cursor_Init(pWnaf, pS, p->m_Fast.m_WndBits);
+#else // c_MultiMac_Buckets_MinCount
+		UNUSED(nBucketBits);
 		int carry = WNaf_Cursor_Init(pWnaf, pS, p->m_Fast.m_WndBits);
+#endif // c_MultiMac_Buckets_MinCount
+
 		if (carry)
 		{
 			secp256k1_ge ge;
 			MultiMac_Calculate_LoadFast(p, &ge, i, 0);
 			wrap_gej_add_ge_var(p->m_pRes, p->m_pRes, &ge);
+
+			nBits = c_ECC_nBits; // added before the full chain
+		}
+
+		if (!nBucketBits && (c_WNaf_Invalid != pWnaf->m_iElement))
+		{
+#ifndef BeamCrypto_ScarceStack
+			WNaf_Schedule_Push(pSchedule, p->m_Fast.m_pWnaf, i);
+#endif // BeamCrypto_ScarceStack
+
+			if (nBits <= pWnaf->m_iBit)
+				nBits = pWnaf->m_iBit + 1;
 		}
 	}
+
+	return nBits;
 }
 
 __stack_hungry__
-static void MultiMac_Calculate_Secure_Read(secp256k1_ge* pGe, const MultiMac_Secure* pGen, unsigned int iElement)
+static void MultiMac_Secure_ReadEx(secp256k1_ge* pGe, const secp256k1_ge_storage* pPt, unsigned int nCount, unsigned int iElement)
 {
 	secp256k1_ge_storage ges;
 	ZERO_OBJ(ges); // suppress warning: potential unanitialized var used
 
-	for (unsigned int j = 0; j < c_MultiMac_Secure_nCount; j++)
-		secp256k1_ge_storage_cmov(&ges, pGen->m_pPt + j, iElement == j);
+	for (unsigned int j = 0; j < nCount; j++)
+		secp256k1_ge_storage_cmov(&ges, pPt + j, iElement == j);
 
 	secp256k1_ge_from_storage(pGe, &ges); // inline is ok here
 	SECURE_ERASE_OBJ(ges);
 }
 
+static void MultiMac_Calculate_Secure_Read(secp256k1_ge* pGe, const MultiMac_Secure* pGen, unsigned int iElement)
+{
+	MultiMac_Secure_ReadEx(pGe, pGen->m_pPt, c_MultiMac_Secure_nCount, iElement);
+}
+
 __stack_hungry__
 static void MultiMac_Calculate_SecureBit(const MultiMac_Context* p, unsigned int iBit)
 {
@@ -502,6 +650,8 @@ static void MultiMac_Calculate_SecureBit(const MultiMac_Context* p, unsigned int
 	}
 }
 
+#ifdef BeamCrypto_ScarceStack
+
 __stack_hungry__
 static void MultiMac_Calculate_FastBit(const MultiMac_Context* p, unsigned int iBit)
 {
@@ -539,6 +689,95 @@ static void MultiMac_Calculate_FastBit(const MultiMac_Context* p, unsigned int i
 	}
 }
 
+#else // BeamCrypto_ScarceStack
+
+__stack_hungry__
+static void MultiMac_Calculate_FastBit(const MultiMac_Context* p, WNaf_Schedule pSchedule, unsigned int iBit)
+{
+	unsigned int nMaxWnd = p->m_Fast.m_WndBits;
+	unsigned int nMaxElements = c_MultiMac_OddCount(nMaxWnd);
+
+	for (unsigned int i = pSchedule[iBit]; c_WNaf_Schedule_End != i; )
+	{
+		MultiMac_WNaf* pWnaf = p->m_Fast.m_pWnaf + i;
+		assert(((uint8_t) iBit) == pWnaf->m_iBit);
+
+		unsigned int iElem = pWnaf->m_iElement;
+		assert(c_WNaf_Invalid != iElem);
+
+		int bNegate = (iElem >= nMaxElements);
+		if (bNegate)
+		{
+			iElem = (nMaxElements * 2 - 1) - iElem;
+			assert(iElem < nMaxElements);
+		}
+
+		secp256k1_ge ge;
+		MultiMac_Calculate_LoadFast(p, &ge, i, iElem);
+
+		if (bNegate)
+			wrap_ge_neg(&ge, &ge);
+
+		wrap_gej_add_ge_var(p->m_pRes, p->m_pRes, &ge);
+
+		WNaf_Cursor_MoveNext(pWnaf, p->m_Fast.m_pK + i, nMaxWnd);
+
+		unsigned int iNext = pWnaf->m_iNext;
+
+		if ((c_WNaf_Invalid != pWnaf->m_iElement) && (pWnaf->m_iBit < iBit))
+			WNaf_Schedule_Push(pSchedule, p->m_Fast.m_pWnaf, i); // always to a lower bit, the current list isn't affected
+
+		i = iNext;
+	}
+}
+
+#endif // BeamCrypto_ScarceStack
+
+#ifdef c_MultiMac_Buckets_MinCount
+
+__attribute__((noinline)) // the buckets are too large to be inlined into the caller stack frame
+static void MultiMac_Calculate_BucketWnd(const MultiMac_Context* p, unsigned int iBit, unsigned int nWndBits)
+{
+	gej_t pBucket[c_MultiMac_OddCount(c_MultiMac_Buckets_nBitsMax)];
+
+	unsigned int nBuckets = c_MultiMac_OddCount(nWndBits);
+	unsigned int nWidth = MultiMac_Buckets_GetWidth(iBit, nWndBits);
+
+	for (unsigned int i = 0; i < nBuckets; i++)
+		secp256k1_gej_set_infinity(pBucket + i);
+
+	for (unsigned int i = 0; i < p->m_Fast.m_Count; i++)
+	{
+		unsigned int val = MultiMac_Buckets_GetWnd(p->m_Fast.m_pK + i, iBit, nWidth);
+		if (!val)
+			continue;
+
+		int bNegate = (val > nBuckets);
+		if (bNegate)
+			val = (1U << nWndBits) - val;
+
+		secp256k1_ge ge;
+		MultiMac_Calculate_LoadFast(p, &ge, i, 0);
+
+		if (bNegate)
+			wrap_ge_neg(&ge, &ge);
+
+		wrap_gej_add_ge_var(pBucket + val - 1, pBucket + val - 1, &ge);
+	}
+
+	// Sum(i * Bucket[i]) == Sum of the running sums, from the top
+	gej_t gejRunning;
+	secp256k1_gej_set_infinity(&gejRunning);
+
+	for (unsigned int i = nBuckets; i--; )
+	{
+		wrap_gej_add_var(&gejRunning, &gejRunning, pBucket + i);
+		wrap_gej_add_var(p->m_pRes, p->m_pRes, &gejRunning);
+	}
+}
+
+#endif // c_MultiMac_Buckets_MinCount
+
 __stack_hungry__
 static void MultiMac_Calculate_PostPhase(const MultiMac_Context* p)
 {
@@ -556,11 +795,25 @@ static void MultiMac_Calculate_PostPhase(const MultiMac_Context* p)
 }
 
 __stack_hungry__
-void MultiMac_Calculate(MultiMac_Context* p)
+static void MultiMac_Calculate_Internal(MultiMac_Context* p)
 {
-	MultiMac_Calculate_PrePhase(p);
+#ifndef BeamCrypto_ScarceStack
+	WNaf_Schedule pSchedule;
+#endif // BeamCrypto_ScarceStack
+	unsigned int nBucketBits = 0;
+
+#ifdef c_MultiMac_Buckets_MinCount
+	if (p->m_Fast.m_Count >= c_MultiMac_Buckets_MinCount)
+		nBucketBits = MultiMac_Buckets_GetWndBits(p->m_Fast.m_Count);
+#endif // c_MultiMac_Buckets_MinCount
+
+#ifdef BeamCrypto_ScarceStack
+	unsigned int nBits = MultiMac_Calculate_PrePhase(p, nBucketBits);
+#else // BeamCrypto_ScarceStack
+	unsigned int nBits = MultiMac_Calculate_PrePhase(p, pSchedule, nBucketBits);
+#endif // BeamCrypto_ScarceStack
 
-	for (unsigned int iBit = c_ECC_nBits; iBit--; )
+	for (unsigned int iBit = nBits; iBit--; )
 	{
 		wrap_gej_double_var(p->m_pRes, p->m_pRes); // would be fast if zero, no need to check explicitly
 
@@ -568,12 +821,131 @@ void MultiMac_Calculate(MultiMac_Context* p)
 			MultiMac_Calculate_SecureBit(p, iBit);
 
 		if (p->m_Fast.m_Count) // suppress the warning, potential usage of uninitialized m_Fast.m_WndBits
-			MultiMac_Calculate_FastBit(p, iBit);
+		{
+#ifdef c_MultiMac_Buckets_MinCount
+			if (nBucketBits)
+			{
+				if (!(iBit % nBucketBits))
+					MultiMac_Calculate_BucketWnd(p, iBit, nBucketBits);
+			}
+			else
+#endif // c_MultiMac_Buckets_MinCount
+#ifdef BeamCrypto_ScarceStack
+				MultiMac_Calculate_FastBit(p, iBit);
+#else // BeamCrypto_ScarceStack
+				MultiMac_Calculate_FastBit(p, pSchedule, iBit);
+#endif // BeamCrypto_ScarceStack
+		}
 	}
 
 	MultiMac_Calculate_PostPhase(p);
 }
 
+#ifdef c_MultiMac_Glv_MaxCount
+
+__stack_hungry__
+static void MultiMac_Calculate_Glv(const MultiMac_Context* p)
+{
+	// Each scalar is split into 2 halves of ~128 bits, the 2nd is applied to the beta-mapped generator (on-the-fly, in MultiMac_Calculate_LoadFast).
+	// Negative halves are negated, with the generator.
+	secp256k1_scalar pK[c_MultiMac_Glv_MaxCount * 2];
+	MultiMac_WNaf pWnaf[c_MultiMac_Glv_MaxCount * 2];
+
+	unsigned int n = p->m_Fast.m_Count;
+	assert(n <= c_MultiMac_Glv_MaxCount);
+
+	MultiMac_Context ctx = *p;
+	ctx.m_Fast.m_Count = n * 2;
+	ctx.m_Fast.m_pK = pK;
+	ctx.m_Fast.m_pWnaf = pWnaf;
+	ctx.m_Glv.m_nHalf = n;
+	ctx.m_Glv.m_NegMsk = 0;
+
+	for (unsigned int i = 0; i < n; i++)
+		secp256k1_scalar_split_lambda(pK + i, pK + n + i, p->m_Fast.m_pK + i);
+
+	for (unsigned int i = 0; i < n * 2; i++)
+	{
+		if (secp256k1_scalar_is_high(pK + i))
+		{
+			secp256k1_scalar_negate(pK + i, pK + i);
+			ctx.m_Glv.m_NegMsk |= 1U << i;
+		}
+	}
+
+	MultiMac_Calculate_Internal(&ctx);
+
+	SECURE_ERASE_OBJ(pK);
+}
+
+#endif // c_MultiMac_Glv_MaxCount
+
+void MultiMac_Calculate(MultiMac_Context* p)
+{
+#ifdef c_MultiMac_Glv_MaxCount
+	p->m_Glv.m_nHalf = 0;
+	p->m_Glv.m_NegMsk = 0;
+
+	if (!p->m_Secure.m_Count && p->m_Fast.m_Count && (p->m_Fast.m_Count <= c_MultiMac_Glv_MaxCount))
+	{
+		MultiMac_Calculate_Glv(p);
+		return;
+	}
+#endif // c_MultiMac_Glv_MaxCount
+
+	MultiMac_Calculate_Internal(p);
+}
+
+//////////////////////////////
+// Comb
+static unsigned int MultiMac_Comb_GetIndex(const secp256k1_scalar* pK, unsigned int iBlock, unsigned int iSpacing)
+{
+	// constant-time wrt scalar, only the positions are branched on
+	unsigned int iElement = 0;
+
+	for (unsigned int iTooth = 0; iTooth < c_MultiMac_Comb_nTeeth; iTooth++)
+	{
+		unsigned int iBit = (iBlock * c_MultiMac_Comb_nTeeth + iTooth) * c_MultiMac_Comb_nSpacing + iSpacing;
+		if (iBit >= c_ECC_nBits)
+			break;
+
+		unsigned int val = (unsigned int) (pK->d[iBit / secp256k1_scalar_WordBits] >> (iBit % secp256k1_scalar_WordBits)) & 1;
+		iElement |= val << iTooth;
+	}
+
+	return iElement;
+}
+
+__stack_hungry__
+void MultiMac_Comb_Calculate(secp256k1_gej* pRes, const MultiMac_Comb* pComb, const secp256k1_scalar* pK, unsigned int nCount)
+{
+	secp256k1_ge ge;
+	secp256k1_gej_set_infinity(pRes);
+
+	for (unsigned int iSpacing = c_MultiMac_Comb_nSpacing; iSpacing--; )
+	{
+		wrap_gej_double_var(pRes, pRes); // would be fast if zero, no need to check explicitly
+
+		for (unsigned int i = 0; i < nCount; i++)
+		{
+			for (unsigned int iBlock = 0; iBlock < c_MultiMac_Comb_nBlocks; iBlock++)
+			{
+				unsigned int iElement = MultiMac_Comb_GetIndex(pK + i, iBlock, iSpacing);
+				MultiMac_Secure_ReadEx(&ge, pComb[i].m_pPt[iBlock], c_MultiMac_Comb_nEntries, iElement);
+				wrap_gej_add_ge_var(pRes, pRes, &ge);
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < nCount; i++)
+	{
+		secp256k1_ge_from_storage(&ge, &pComb[i].m_Compensation);
+		wrap_gej_add_ge_var(pRes, pRes, &ge);
+	}
+
+	SECURE_ERASE_OBJ(ge);
+}
+
 //////////////////////////////
 // Batch normalization
 __stack_hungry__
@@ -671,12 +1043,6 @@ void Point_Gej_2_Normalize(gej_t* pGej)
 	Point_Gej_BatchRescale(pGej, _countof(pBuf), pBuf, &zDenom, 1);
 }
 
-typedef struct
-{
-	secp256k1_ge_storage m_pPt[c_MultiMac_OddCount(c_MultiMac_nBits_Custom)]; // odd powers
-	secp256k1_fe m_zDenom;
-} CustomGenerator;
-
 void Point_CalculateOdds(gej_t* pOdds, uint32_t n, const secp256k1_ge* pGe)
 {
 	assert(n);
@@ -730,14 +1096,24 @@ void secp256k1_hmac_sha256_write_CompactPoint(secp256k1_hmac_sha256_t* pHMac, co
 
 //////////////////////////////
 // NonceGenerator
-void NonceGenerator_InitBegin(NonceGenerator* p, secp256k1_hmac_sha256_t* pHMac, const char* szSalt, size_t nSalt)
+static void HMacSalt_Init(secp256k1_hmac_sha256_t* pHMac, const HMacSalt* pSalt)
+{
+	// same as secp256k1_hmac_sha256_initialize() keyed by the salt, the ipad/opad blocks are already compressed
+	memcpy(pHMac->inner.s, pSalt->m_pInner, sizeof(pSalt->m_pInner));
+	pHMac->inner.bytes = 64;
+
+	memcpy(pHMac->outer.s, pSalt->m_pOuter, sizeof(pSalt->m_pOuter));
+	pHMac->outer.bytes = 64;
+}
+
+void NonceGenerator_InitBegin(NonceGenerator* p, secp256k1_hmac_sha256_t* pHMac, const HMacSalt* pSalt)
 {
 	p->m_Counter = 0;
 	p->m_FirstTime = 1;
 	p->m_pContext = 0;
 	p->m_nContext = 0;
 
-	secp256k1_hmac_sha256_initialize(pHMac, (uint8_t*) szSalt, nSalt);
+	HMacSalt_Init(pHMac, pSalt);
 }
 
 void NonceGenerator_InitEnd(NonceGenerator* p, secp256k1_hmac_sha256_t* pHMac)
@@ -746,33 +1122,50 @@ void NonceGenerator_InitEnd(NonceGenerator* p, secp256k1_hmac_sha256_t* pHMac)
 }
 
 __stack_hungry__
-void NonceGenerator_Init(NonceGenerator* p, const char* szSalt, size_t nSalt, const UintBig* pSeed)
+void NonceGenerator_Init(NonceGenerator* p, const HMacSalt* pSalt, const UintBig* pSeed)
 {
 	secp256k1_hmac_sha256_t hmac;
 
-	NonceGenerator_InitBegin(p, &hmac, szSalt, nSalt);
+	NonceGenerator_InitBegin(p, &hmac, pSalt);
 	secp256k1_hmac_sha256_write_UintBig(&hmac, pSeed);
 	NonceGenerator_InitEnd(p, &hmac);
 }
 
+static void NonceGenerator_NextOkm_HMac(NonceGenerator* p, secp256k1_hmac_sha256_t* pHMac)
+{
+	// Expand, the hmac is keyed by m_Prk
+	if (p->m_FirstTime)
+		p->m_FirstTime = 0;
+	else
+		secp256k1_hmac_sha256_write_UintBig(pHMac, &p->m_Okm);
+
+	secp256k1_hmac_sha256_write(pHMac, p->m_pContext, p->m_nContext);
+
+	p->m_Counter++;
+	secp256k1_hmac_sha256_write(pHMac, &p->m_Counter, sizeof(p->m_Counter));
+
+	secp256k1_hmac_sha256_finalize(pHMac, p->m_Okm.m_pVal);
+}
+
 __stack_hungry__
 void NonceGenerator_NextOkm(NonceGenerator* p)
 {
-	// Expand
 	secp256k1_hmac_sha256_t hmac;
 	secp256k1_hmac_sha256_initialize(&hmac, p->m_Prk.m_pVal, sizeof(p->m_Prk.m_pVal));
 
-	if (p->m_FirstTime)
-		p->m_FirstTime = 0;
-	else
-		secp256k1_hmac_sha256_write_UintBig(&hmac, &p->m_Okm);
+	NonceGenerator_NextOkm_HMac(p, &hmac);
+}
 
-	secp256k1_hmac_sha256_write(&hmac, p->m_pContext, p->m_nContext);
+__stack_hungry__
+void NonceGenerator_PrepareHMac(const NonceGenerator* p, HMacSalt* pPrk)
+{
+	secp256k1_hmac_sha256_t hmac;
+	secp256k1_hmac_sha256_initialize(&hmac, p->m_Prk.m_pVal, sizeof(p->m_Prk.m_pVal));
 
-	p->m_Counter++;
-	secp256k1_hmac_sha256_write(&hmac, &p->m_Counter, sizeof(p->m_Counter));
+	memcpy(pPrk->m_pInner, hmac.inner.s, sizeof(pPrk->m_pInner));
+	memcpy(pPrk->m_pOuter, hmac.outer.s, sizeof(pPrk->m_pOuter));
 
-	secp256k1_hmac_sha256_finalize(&hmac, p->m_Okm.m_pVal);
+	SECURE_ERASE_OBJ(hmac);
 }
 
 static int ScalarImportNnz(secp256k1_scalar* pS, const uint8_t* p)
@@ -793,21 +1186,331 @@ void NonceGenerator_NextScalar(NonceGenerator* p, secp256k1_scalar* pS)
 	}
 }
 
-int memis0(const uint8_t* p, uint32_t n)
+__stack_hungry__
+void NonceGenerator_NextScalarEx(NonceGenerator* p, const HMacSalt* pPrk, secp256k1_scalar* pS)
 {
-	for (uint32_t i = 0; i < n; i++)
-		if (p[i])
-			return 0;
-	return 1;
+	secp256k1_hmac_sha256_t hmac;
+
+	while (1)
+	{
+		HMacSalt_Init(&hmac, pPrk);
+		NonceGenerator_NextOkm_HMac(p, &hmac);
+
+		if (ScalarImportNnz(pS, p->m_Okm.m_pVal))
+			break;
+	}
+
+	SECURE_ERASE_OBJ(hmac);
 }
 
-int IsUintBigZero(const UintBig* p)
+__stack_hungry__
+void NonceGenerator_NextScalars(NonceGenerator* p, secp256k1_scalar* pS, uint32_t nCount)
 {
-	return memis0(p->m_pVal, sizeof(p->m_pVal));
+	HMacSalt prk;
+	NonceGenerator_PrepareHMac(p, &prk);
+
+	for (uint32_t i = 0; i < nCount; i++)
+		NonceGenerator_NextScalarEx(p, &prk, pS + i);
+
+	SECURE_ERASE_OBJ(prk);
 }
 
+#ifdef BeamCrypto_Sha256Accel
+
 //////////////////////////////
-// Point
+// Multi-buffer hashing: independent hashes advanced in lockstep, so that their compressions are done in parallel.
+// A lockstep write must cross the block boundaries of all the hashes at once, i.e. they must have the same amount of data pending.
+#define c_Sha256_BatchMax c_Sha256_Lanes
+
+static void Sha256_Transform_N(uint32_t* const* ppState, const uint8_t* const* ppBlock, unsigned int n)
+{
+	Sha256_TransformLanes_t pfn = g_pfnSha256TransformLanes;
+
+	while (pfn && (n > 1))
+	{
+		unsigned int nLanes = (n < c_Sha256_Lanes) ? n : c_Sha256_Lanes;
+
+		uint32_t* ppS[c_Sha256_Lanes];
+		const uint8_t* ppB[c_Sha256_Lanes];
+
+		for (unsigned int i = 0; i < c_Sha256_Lanes; i++)
+		{
+			// the unused lanes repeat the last one, the result is the same
+			unsigned int iSrc = (i < nLanes) ? i : (nLanes - 1);
+			ppS[i] = ppState[iSrc];
+			ppB[i] = ppBlock[iSrc];
+
+			if (i < nLanes)
+				SECP256K1_OPCOUNT(Sha256);
+		}
+
+		pfn(ppS, ppB);
+
+		ppState += nLanes;
+		ppBlock += nLanes;
+		n -= nLanes;
+	}
+
+	for (unsigned int i = 0; i < n; i++)
+		secp256k1_sha256_transform(ppState[i], ppBlock[i]);
+}
+
+static void Sha256_Write_N(secp256k1_sha256_t* const* ppSha, const uint8_t* const* ppData, size_t nLen, unsigned int n)
+{
+	assert(n <= c_Sha256_BatchMax);
+
+	uint32_t* ppState[c_Sha256_BatchMax];
+	const uint8_t* ppBlock[c_Sha256_BatchMax];
+
+	for (size_t nDone = 0; n && (nDone < nLen); )
+	{
+		size_t nPending = ppSha[0]->bytes & 0x3f;
+		size_t nPortion = 64 - nPending;
+		if (nPortion > nLen - nDone)
+			nPortion = nLen - nDone;
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			secp256k1_sha256_t* pSha = ppSha[i];
+			assert((pSha->bytes & 0x3f) == nPending);
+
+			memcpy(pSha->buf + nPending, ppData[i] + nDone, nPortion);
+			pSha->bytes += nPortion;
+
+			ppState[i] = pSha->s;
+			ppBlock[i] = pSha->buf;
+		}
+
+		if (nPending + nPortion == 64)
+			Sha256_Transform_N(ppState, ppBlock, n);
+
+		nDone += nPortion;
+	}
+}
+
+static void Sha256_Finalize_N(secp256k1_sha256_t* const* ppSha, uint8_t* const* ppOut, unsigned int n)
+{
+	// same as secp256k1_sha256_finalize(), the pending amounts may differ
+	assert(n <= c_Sha256_BatchMax);
+
+	uint32_t* ppState[c_Sha256_BatchMax];
+	const uint8_t* ppBlock[c_Sha256_BatchMax];
+	unsigned int nExtra = 0;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		secp256k1_sha256_t* pSha = ppSha[i];
+		size_t nPending = pSha->bytes & 0x3f;
+
+		pSha->buf[nPending++] = 0x80;
+		if (nPending > 56)
+		{
+			// no room for the length, an extra block
+			memset(pSha->buf + nPending, 0, 64 - nPending);
+			ppState[nExtra] = pSha->s;
+			ppBlock[nExtra] = pSha->buf;
+			nExtra++;
+		}
+	}
+
+	Sha256_Transform_N(ppState, ppBlock, nExtra);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		secp256k1_sha256_t* pSha = ppSha[i];
+		size_t nPending = (pSha->bytes & 0x3f) + 1;
+		if (nPending > 56)
+			nPending = 0;
+
+		memset(pSha->buf + nPending, 0, 56 - nPending);
+		secp256k1_write_be32(pSha->buf + 56, (uint32_t) (pSha->bytes >> 29));
+		secp256k1_write_be32(pSha->buf + 60, (uint32_t) (pSha->bytes << 3));
+
+		ppState[i] = pSha->s;
+		ppBlock[i] = pSha->buf;
+	}
+
+	Sha256_Transform_N(ppState, ppBlock, n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		secp256k1_sha256_t* pSha = ppSha[i];
+		for (unsigned int j = 0; j < 8; j++)
+		{
+			secp256k1_write_be32(ppOut[i] + j * 4, pSha->s[j]);
+			pSha->s[j] = 0;
+		}
+	}
+}
+
+static void HMac_Init_N(secp256k1_hmac_sha256_t* const* ppHMac, const UintBig* const* ppKey, unsigned int n)
+{
+	// same as secp256k1_hmac_sha256_initialize() with 32-byte keys
+	assert(n <= c_Sha256_BatchMax);
+
+	uint8_t pRKey[c_Sha256_BatchMax][64];
+	const uint8_t* ppData[c_Sha256_BatchMax];
+	secp256k1_sha256_t* ppSha[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		memcpy(pRKey[i], ppKey[i]->m_pVal, sizeof(ppKey[i]->m_pVal));
+		memset(pRKey[i] + sizeof(ppKey[i]->m_pVal), 0, sizeof(pRKey[i]) - sizeof(ppKey[i]->m_pVal));
+
+		for (unsigned int j = 0; j < sizeof(pRKey[i]); j++)
+			pRKey[i][j] ^= 0x5c;
+
+		secp256k1_sha256_initialize(&ppHMac[i]->outer);
+		ppSha[i] = &ppHMac[i]->outer;
+		ppData[i] = pRKey[i];
+	}
+
+	Sha256_Write_N(ppSha, ppData, sizeof(pRKey[0]), n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		for (unsigned int j = 0; j < sizeof(pRKey[i]); j++)
+			pRKey[i][j] ^= 0x5c ^ 0x36;
+
+		secp256k1_sha256_initialize(&ppHMac[i]->inner);
+		ppSha[i] = &ppHMac[i]->inner;
+	}
+
+	Sha256_Write_N(ppSha, ppData, sizeof(pRKey[0]), n);
+
+	SECURE_ERASE_OBJ(pRKey);
+}
+
+static void HMac_Write_N(secp256k1_hmac_sha256_t* const* ppHMac, const uint8_t* const* ppData, size_t nLen, unsigned int n)
+{
+	assert(n <= c_Sha256_BatchMax);
+
+	secp256k1_sha256_t* ppSha[c_Sha256_BatchMax];
+	for (unsigned int i = 0; i < n; i++)
+		ppSha[i] = &ppHMac[i]->inner;
+
+	Sha256_Write_N(ppSha, ppData, nLen, n);
+}
+
+static void HMac_Finalize_N(secp256k1_hmac_sha256_t* const* ppHMac, uint8_t* const* ppOut, unsigned int n)
+{
+	// same as secp256k1_hmac_sha256_finalize()
+	assert(n <= c_Sha256_BatchMax);
+
+	uint8_t pTemp[c_Sha256_BatchMax][32];
+	uint8_t* ppTemp[c_Sha256_BatchMax];
+	secp256k1_sha256_t* ppSha[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		ppSha[i] = &ppHMac[i]->inner;
+		ppTemp[i] = pTemp[i];
+	}
+
+	Sha256_Finalize_N(ppSha, ppTemp, n);
+
+	for (unsigned int i = 0; i < n; i++)
+		ppSha[i] = &ppHMac[i]->outer;
+
+	Sha256_Write_N(ppSha, (const uint8_t* const*) ppTemp, sizeof(pTemp[0]), n);
+	Sha256_Finalize_N(ppSha, ppOut, n);
+
+	SECURE_ERASE_OBJ(pTemp);
+}
+
+static void HMac_Write_UintBig_N(secp256k1_hmac_sha256_t* const* ppHMac, const UintBig* const* pp, unsigned int n)
+{
+	const uint8_t* ppData[c_Sha256_BatchMax];
+	for (unsigned int i = 0; i < n; i++)
+		ppData[i] = pp[i]->m_pVal;
+
+	HMac_Write_N(ppHMac, ppData, sizeof(pp[0]->m_pVal), n);
+}
+
+static void NonceGenerator_InitEnd_N(NonceGenerator* const* ppNg, secp256k1_hmac_sha256_t* const* ppHMac, unsigned int n)
+{
+	uint8_t* ppOut[c_Sha256_BatchMax];
+	for (unsigned int i = 0; i < n; i++)
+		ppOut[i] = ppNg[i]->m_Prk.m_pVal;
+
+	HMac_Finalize_N(ppHMac, ppOut, n);
+}
+
+__stack_hungry__
+static void NonceGenerator_NextOkm_N(NonceGenerator* const* ppNg, unsigned int n)
+{
+	// same as NonceGenerator_NextOkm() for each, the generators must be in the same phase (same context size and 1st time flag)
+	assert(n <= c_Sha256_BatchMax);
+	if (!n)
+		return;
+
+	secp256k1_hmac_sha256_t pHMac[c_Sha256_BatchMax];
+	secp256k1_hmac_sha256_t* ppHMac[c_Sha256_BatchMax];
+	const UintBig* ppKey[c_Sha256_BatchMax];
+	const uint8_t* ppData[c_Sha256_BatchMax];
+	uint8_t* ppOut[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		ppHMac[i] = pHMac + i;
+		ppKey[i] = &ppNg[i]->m_Prk;
+		ppOut[i] = ppNg[i]->m_Okm.m_pVal;
+	}
+
+	HMac_Init_N(ppHMac, ppKey, n);
+
+	uint8_t bFirstTime = ppNg[0]->m_FirstTime;
+	for (unsigned int i = 0; i < n; i++)
+	{
+		assert((ppNg[i]->m_FirstTime == bFirstTime) && (ppNg[i]->m_nContext == ppNg[0]->m_nContext));
+		ppNg[i]->m_FirstTime = 0;
+		ppKey[i] = &ppNg[i]->m_Okm;
+		ppData[i] = ppNg[i]->m_pContext;
+	}
+
+	if (!bFirstTime)
+		HMac_Write_UintBig_N(ppHMac, ppKey, n);
+
+	HMac_Write_N(ppHMac, ppData, ppNg[0]->m_nContext, n);
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		ppNg[i]->m_Counter++;
+		ppData[i] = &ppNg[i]->m_Counter;
+	}
+
+	HMac_Write_N(ppHMac, ppData, sizeof(ppNg[0]->m_Counter), n);
+	HMac_Finalize_N(ppHMac, ppOut, n);
+
+	SECURE_ERASE_OBJ(pHMac);
+}
+
+static void NonceGenerator_NextScalar_N(NonceGenerator* const* ppNg, secp256k1_scalar* const* ppS, unsigned int n)
+{
+	NonceGenerator_NextOkm_N(ppNg, n);
+
+	for (unsigned int i = 0; i < n; i++)
+		if (!ScalarImportNnz(ppS[i], ppNg[i]->m_Okm.m_pVal))
+			NonceGenerator_NextScalar(ppNg[i], ppS[i]); // practically never happens, continue this one alone
+}
+
+#endif // BeamCrypto_Sha256Accel
+
+int memis0(const uint8_t* p, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++)
+		if (p[i])
+			return 0;
+	return 1;
+}
+
+int IsUintBigZero(const UintBig* p)
+{
+	return memis0(p->m_pVal, sizeof(p->m_pVal));
+}
+
+//////////////////////////////
+// Point
 uint8_t Point_Compact_from_Ge_Ex(UintBig* pX, const secp256k1_ge* pGe)
 {
 	if (secp256k1_ge_is_infinity(pGe))
@@ -908,12 +1611,20 @@ void Point_Ge_from_Gej(secp256k1_ge* pGe, const gej_t* pGej)
 
 void MulG(gej_t* pGej, const secp256k1_scalar* pK)
 {
+#ifdef BeamCrypto_ExternalGej
 	MulPoint(pGej, Context_get()->m_pGenGJ, pK);
+#else // BeamCrypto_ExternalGej
+	MultiMac_Comb_Calculate(pGej, Context_get()->m_pCombGJ, pK, 1);
+#endif // BeamCrypto_ExternalGej
 }
 
 void MulJ(gej_t* pGej, const secp256k1_scalar* pK)
 {
+#ifdef BeamCrypto_ExternalGej
 	MulPoint(pGej, Context_get()->m_pGenGJ + 1, pK);
+#else // BeamCrypto_ExternalGej
+	MultiMac_Comb_Calculate(pGej, Context_get()->m_pCombGJ + 1, pK, 1);
+#endif // BeamCrypto_ExternalGej
 }
 
 __stack_hungry__
@@ -952,11 +1663,17 @@ void Oracle_Expose(Oracle* p, const uint8_t* pPtr, size_t nSize)
 	secp256k1_sha256_write(&p->m_sha, pPtr, nSize);
 }
 
+void Oracle_Fork(const Oracle* p, Oracle* pRes)
+{
+	*pRes = *p;
+}
+
 __stack_hungry__
 void Oracle_NextHash(Oracle* p, UintBig* pHash)
 {
-	secp256k1_sha256_t sha = p->m_sha; // copy
-	secp256k1_sha256_finalize(&sha, pHash->m_pVal);
+	Oracle o2;
+	Oracle_Fork(p, &o2);
+	secp256k1_sha256_finalize(&o2.m_sha, pHash->m_pVal);
 	secp256k1_sha256_write_UintBig(&p->m_sha, pHash);
 }
 
@@ -1066,50 +1783,96 @@ void secp256k1_sha256_write_Gej_converted(secp256k1_sha256_t* pSha, const gej_t*
 }
 
 __stack_hungry__
-void CoinID_getHash(const CoinID* p, UintBig* pHash)
+void Oracle_ExposeGej_N(Oracle* p, gej_t* pGej, uint32_t n)
 {
-	secp256k1_sha256_t sha;
-	secp256k1_sha256_initialize(&sha);
+	assert(n <= c_Oracle_GejBatchMax);
+
+#ifdef BeamCrypto_ExternalGej
+	for (uint32_t i = 0; i < n; i++)
+		secp256k1_sha256_write_Gej(&p->m_sha, pGej + i);
+#else // BeamCrypto_ExternalGej
+
+	secp256k1_fe pBuf[c_Oracle_GejBatchMax];
+	secp256k1_fe zDenom;
+	Point_Gej_BatchRescale(pGej, n, pBuf, &zDenom, 1);
+
+	for (uint32_t i = 0; i < n; i++)
+		secp256k1_sha256_write_Ge(&p->m_sha, (secp256k1_ge*) (pGej + i));
+
+#endif // BeamCrypto_ExternalGej
+}
+
+static void CoinID_getHash_Write(const CoinID* p, secp256k1_sha256_t* pSha)
+{
+	secp256k1_sha256_initialize(pSha);
 
-	HASH_WRITE_STR(sha, "kidv-1");
-	secp256k1_sha256_write_Num(&sha, p->m_Idx);
-	secp256k1_sha256_write_Num(&sha, p->m_Type);
-	secp256k1_sha256_write_Num(&sha, p->m_SubIdx);
+	HASH_WRITE_STR(*pSha, "kidv-1");
+	secp256k1_sha256_write_Num(pSha, p->m_Idx);
+	secp256k1_sha256_write_Num(pSha, p->m_Type);
+	secp256k1_sha256_write_Num(pSha, p->m_SubIdx);
 	// newer scheme - account for the Value and Asset.
-	secp256k1_sha256_write_Num(&sha, p->m_Amount);
+	secp256k1_sha256_write_Num(pSha, p->m_Amount);
 
 	if (p->m_AssetID)
 	{
-		HASH_WRITE_STR(sha, "asset");
-		secp256k1_sha256_write_Num(&sha, p->m_AssetID);
+		HASH_WRITE_STR(*pSha, "asset");
+		secp256k1_sha256_write_Num(pSha, p->m_AssetID);
 	}
+}
 
+__stack_hungry__
+void CoinID_getHash(const CoinID* p, UintBig* pHash)
+{
+	secp256k1_sha256_t sha;
+	CoinID_getHash_Write(p, &sha);
 	secp256k1_sha256_finalize(&sha, pHash->m_pVal);
 }
 
+#ifdef BeamCrypto_Sha256Accel
+__stack_hungry__
+void CoinID_getHash_N(const CoinID* const* ppCid, UintBig* const* ppHash, unsigned int n)
+{
+	// the data is less than a block, only the finalization is compressed
+	assert(n <= c_Sha256_BatchMax);
+
+	secp256k1_sha256_t pSha[c_Sha256_BatchMax];
+	secp256k1_sha256_t* ppSha[c_Sha256_BatchMax];
+	uint8_t* ppOut[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		CoinID_getHash_Write(ppCid[i], pSha + i);
+		ppSha[i] = pSha + i;
+		ppOut[i] = ppHash[i]->m_pVal;
+	}
+
+	Sha256_Finalize_N(ppSha, ppOut, n);
+}
+#endif // BeamCrypto_Sha256Accel
+
 //////////////////////////////
 // Kdf
+static const char g_szKdf_Ctx1[] = "gen";
+static const char g_szKdf_Ctx2[] = "coF";
+
 __stack_hungry__
 void Kdf_Init(Kdf* p, const UintBig* pSeed)
 {
-	static const char szSalt[] = "beam-HKdf";
+	static const HMacSalt salt = HMacSalt_beam_HKdf;
 
 	NonceGenerator ng;
-	NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), pSeed);
+	NonceGenerator_Init(&ng, &salt, pSeed);
 
-	static const char szCtx1[] = "gen";
-	static const char szCtx2[] = "coF";
-
-	ng.m_pContext = (const uint8_t*) szCtx1;
-	ng.m_nContext = sizeof(szCtx1);
+	ng.m_pContext = (const uint8_t*) g_szKdf_Ctx1;
+	ng.m_nContext = sizeof(g_szKdf_Ctx1);
 
 	NonceGenerator_NextOkm(&ng);
 	p->m_Secret = ng.m_Okm;
 
 	ng.m_Counter = 0;
 	ng.m_FirstTime = 1;
-	ng.m_pContext = (const uint8_t*) szCtx2;
-	ng.m_nContext = sizeof(szCtx2);
+	ng.m_pContext = (const uint8_t*) g_szKdf_Ctx2;
+	ng.m_nContext = sizeof(g_szKdf_Ctx2);
 	NonceGenerator_NextScalar(&ng, &p->m_kCoFactor);
 
 	SECURE_ERASE_OBJ(ng);
@@ -1120,10 +1883,10 @@ void KdfRaw_Derive_PKey(const UintBig* pSecret, const UintBig* pHv, secp256k1_sc
 {
 	NonceGenerator ng;
 
-	static const char szSalt[] = "beam-Key";
+	static const HMacSalt salt = HMacSalt_beam_Key;
 
 	secp256k1_hmac_sha256_t hmac;
-	NonceGenerator_InitBegin(&ng, &hmac, szSalt, sizeof(szSalt));
+	NonceGenerator_InitBegin(&ng, &hmac, &salt);
 
 	secp256k1_hmac_sha256_write_UintBig(&hmac, pSecret);
 	secp256k1_hmac_sha256_write_UintBig(&hmac, pHv);
@@ -1150,19 +1913,23 @@ void Kdf_Derive_SKey(const Kdf* p, const UintBig* pHv, secp256k1_scalar* pK)
 #define FOURCC_FROM_BYTES(a, b, c, d) (((((((uint32_t) a << 8) | (uint32_t) b) << 8) | (uint32_t) c) << 8) | (uint32_t) d)
 #define FOURCC_FROM_STR(name) FOURCC_FROM_BYTES(ARRAY_ELEMENT_SAFE(#name,0), ARRAY_ELEMENT_SAFE(#name,1), ARRAY_ELEMENT_SAFE(#name,2), ARRAY_ELEMENT_SAFE(#name,3))
 
-__stack_hungry__
-void Kdf_getChild_Hv(uint32_t iChild, UintBig* pHv)
+static void Kdf_getChild_Hv_Write(uint32_t iChild, secp256k1_sha256_t* pSha)
 {
-	secp256k1_sha256_t sha;
-	secp256k1_sha256_initialize(&sha);
-	HASH_WRITE_STR(sha, "kid");
+	secp256k1_sha256_initialize(pSha);
+	HASH_WRITE_STR(*pSha, "kid");
 
 	const uint32_t nType = FOURCC_FROM_STR(SubK);
 
-	secp256k1_sha256_write_Num(&sha, iChild);
-	secp256k1_sha256_write_Num(&sha, nType);
-	secp256k1_sha256_write_Num(&sha, 0);
+	secp256k1_sha256_write_Num(pSha, iChild);
+	secp256k1_sha256_write_Num(pSha, nType);
+	secp256k1_sha256_write_Num(pSha, 0);
+}
 
+__stack_hungry__
+void Kdf_getChild_Hv(uint32_t iChild, UintBig* pHv)
+{
+	secp256k1_sha256_t sha;
+	Kdf_getChild_Hv_Write(iChild, &sha);
 	secp256k1_sha256_finalize(&sha, pHv->m_pVal);
 }
 
@@ -1188,95 +1955,236 @@ void Kdf_getChild(Kdf* p, uint32_t iChild, const Kdf* pParent)
 	SECURE_ERASE_OBJ(hv);
 }
 
-//////////////////////////////
-// Kdf - CoinID key derivation
+#ifdef BeamCrypto_Sha256Accel
 __stack_hungry__
-void CoinID_GetAssetGen(AssetID aid, secp256k1_ge* pGe)
+void KdfRaw_Derive_PKey_N(const UintBig* const* ppSecret, const UintBig* const* ppHv, secp256k1_scalar* const* ppK, unsigned int n)
 {
-	assert(aid);
+	assert(n <= c_Sha256_BatchMax);
 
-	Oracle oracle;
-	Oracle_Init(&oracle);
+	static const HMacSalt salt = HMacSalt_beam_Key;
 
-	HASH_WRITE_STR(oracle.m_sha, "B.Asset.Gen.V1");
-	secp256k1_sha256_write_Num(&oracle.m_sha, aid);
+	NonceGenerator pNg[c_Sha256_BatchMax];
+	NonceGenerator* ppNg[c_Sha256_BatchMax];
+	secp256k1_hmac_sha256_t pHMac[c_Sha256_BatchMax];
+	secp256k1_hmac_sha256_t* ppHMac[c_Sha256_BatchMax];
 
-	CompactPoint pt;
-	Oracle_NextPoint(&oracle, &pt, pGe);
-}
+	for (unsigned int i = 0; i < n; i++)
+	{
+		NonceGenerator_InitBegin(pNg + i, pHMac + i, &salt);
+		ppNg[i] = pNg + i;
+		ppHMac[i] = pHMac + i;
+	}
 
-__stack_hungry__
-void CoinID_GenerateAGen(AssetID aid, CustomGenerator* pAGen)
-{
-	assert(aid);
+	HMac_Write_UintBig_N(ppHMac, ppSecret, n);
+	HMac_Write_UintBig_N(ppHMac, ppHv, n);
+	NonceGenerator_InitEnd_N(ppNg, ppHMac, n);
 
-#ifdef BeamCrypto_ExternalGej
+	NonceGenerator_NextScalar_N(ppNg, ppK, n);
 
-	secp256k1_ge ge;
-	CoinID_GetAssetGen(aid, &ge);
-	Point_Gej_from_Ge(pAGen, &ge);
+	SECURE_ERASE_OBJ(pHMac);
+	SECURE_ERASE_OBJ(pNg);
+}
 
-#else // BeamCrypto_ExternalGej
+static void Kdf_Derive_SKey_N(const Kdf* const* ppKdf, const UintBig* const* ppHv, secp256k1_scalar* const* ppK, unsigned int n)
+{
+	assert(n <= c_Sha256_BatchMax);
 
-	static_assert(sizeof(*pAGen) >= sizeof(secp256k1_ge), "");
+	const UintBig* ppSecret[c_Sha256_BatchMax];
+	for (unsigned int i = 0; i < n; i++)
+		ppSecret[i] = &ppKdf[i]->m_Secret;
 
-	CoinID_GetAssetGen(aid, (secp256k1_ge*) pAGen);
-	MultiMac_Fast_Custom_Init(pAGen, (secp256k1_ge*) pAGen);
+	KdfRaw_Derive_PKey_N(ppSecret, ppHv, ppK, n);
 
-#endif // BeamCrypto_ExternalGej
+	for (unsigned int i = 0; i < n; i++)
+		wrap_scalar_mul(ppK[i], ppK[i], &ppKdf[i]->m_kCoFactor);
 }
 
 __stack_hungry__
-void CoinID_getCommRawEx(const secp256k1_scalar* pkG, secp256k1_scalar* pkH, const CustomGenerator* pAGen, gej_t* pGej)
+void Kdf_Init_N(Kdf* const* ppKdf, const UintBig* const* ppSeed, unsigned int n)
 {
-	Context* pCtx = Context_get();
+	assert(n <= c_Sha256_BatchMax);
 
-	// sk*G + v*H
+	static const HMacSalt salt = HMacSalt_beam_HKdf;
 
-#ifdef BeamCrypto_ExternalGej
+	NonceGenerator pNg[c_Sha256_BatchMax];
+	NonceGenerator* ppNg[c_Sha256_BatchMax];
+	secp256k1_hmac_sha256_t pHMac[c_Sha256_BatchMax];
+	secp256k1_hmac_sha256_t* ppHMac[c_Sha256_BatchMax];
+	secp256k1_scalar* ppK[c_Sha256_BatchMax];
 
-	MulG(pGej, pkG);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		NonceGenerator_InitBegin(pNg + i, pHMac + i, &salt);
+		ppNg[i] = pNg + i;
+		ppHMac[i] = pHMac + i;
+	}
 
-	gej_t gej;
-	Gej_Init(&gej);
+	HMac_Write_UintBig_N(ppHMac, ppSeed, n);
+	NonceGenerator_InitEnd_N(ppNg, ppHMac, n);
 
-	if (!pAGen)
+	for (unsigned int i = 0; i < n; i++)
 	{
-		Gej_Set_Affine(&gej, &pCtx->m_GenH);
-		pAGen = &gej;
+		pNg[i].m_pContext = (const uint8_t*) g_szKdf_Ctx1;
+		pNg[i].m_nContext = sizeof(g_szKdf_Ctx1);
 	}
 
-	Gej_MulFast(&gej, pAGen, pkH);
-	Gej_Add(pGej, pGej, &gej);
+	NonceGenerator_NextOkm_N(ppNg, n);
 
-	Gej_Destroy(&gej);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		ppKdf[i]->m_Secret = pNg[i].m_Okm;
 
-#else // BeamCrypto_ExternalGej
+		pNg[i].m_Counter = 0;
+		pNg[i].m_FirstTime = 1;
+		pNg[i].m_pContext = (const uint8_t*) g_szKdf_Ctx2;
+		pNg[i].m_nContext = sizeof(g_szKdf_Ctx2);
 
-	MultiMac_WNaf wnaf;
-	MultiMac_Context mmCtx;
-	mmCtx.m_pRes = pGej;
-	mmCtx.m_Secure.m_Count = 1;
-	mmCtx.m_Secure.m_pK = pkG;
-	mmCtx.m_Secure.m_pGen = pCtx->m_pGenGJ;
-	mmCtx.m_Fast.m_Count = 1;
-	mmCtx.m_Fast.m_pK = pkH;
-	mmCtx.m_Fast.m_pWnaf = &wnaf;
+		ppK[i] = &ppKdf[i]->m_kCoFactor;
+	}
+
+	NonceGenerator_NextScalar_N(ppNg, ppK, n);
+
+	SECURE_ERASE_OBJ(pHMac);
+	SECURE_ERASE_OBJ(pNg);
+}
+
+__stack_hungry__
+void Kdf_getChild_N(Kdf* const* ppKdf, const uint32_t* pChild, const Kdf* pParent, unsigned int n)
+{
+	assert(n <= c_Sha256_BatchMax);
+
+	secp256k1_sha256_t pSha[c_Sha256_BatchMax];
+	secp256k1_sha256_t* ppSha[c_Sha256_BatchMax];
+	UintBig pHv[c_Sha256_BatchMax];
+	UintBig* ppHv[c_Sha256_BatchMax];
+	uint8_t* ppOut[c_Sha256_BatchMax];
+	const Kdf* ppParent[c_Sha256_BatchMax];
+	secp256k1_scalar pSk[c_Sha256_BatchMax];
+	secp256k1_scalar* ppSk[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		Kdf_getChild_Hv_Write(pChild[i], pSha + i);
+		ppSha[i] = pSha + i;
+		ppHv[i] = pHv + i;
+		ppOut[i] = pHv[i].m_pVal;
+		ppParent[i] = pParent;
+		ppSk[i] = pSk + i;
+	}
+
+	// as Kdf_getChild_Hv2()
+	Sha256_Finalize_N(ppSha, ppOut, n);
+	Kdf_Derive_SKey_N(ppParent, (const UintBig* const*) ppHv, ppSk, n);
+
+	for (unsigned int i = 0; i < n; i++)
+		secp256k1_scalar_get_b32(pHv[i].m_pVal, pSk + i);
+
+	Kdf_Init_N(ppKdf, (const UintBig* const*) ppHv, n);
+
+	SECURE_ERASE_OBJ(pSk);
+	SECURE_ERASE_OBJ(pHv);
+}
+#endif // BeamCrypto_Sha256Accel
+
+//////////////////////////////
+// Kdf - CoinID key derivation
+__stack_hungry__
+void CoinID_GetAssetGen(AssetID aid, secp256k1_ge* pGe)
+{
+	assert(aid);
+
+	Oracle oracle;
+	Oracle_Init(&oracle);
+
+	HASH_WRITE_STR(oracle.m_sha, "B.Asset.Gen.V1");
+	secp256k1_sha256_write_Num(&oracle.m_sha, aid);
+
+	CompactPoint pt;
+	Oracle_NextPoint(&oracle, &pt, pGe);
+}
+
+__stack_hungry__
+void CoinID_GenerateAGen(AssetID aid, CustomGenerator* pAGen)
+{
+	assert(aid);
+
+#ifdef BeamCrypto_ExternalGej
+
+	secp256k1_ge ge;
+	CoinID_GetAssetGen(aid, &ge);
+	Point_Gej_from_Ge(pAGen, &ge);
+
+#else // BeamCrypto_ExternalGej
+
+	static_assert(sizeof(*pAGen) >= sizeof(secp256k1_ge), "");
+
+	CoinID_GetAssetGen(aid, (secp256k1_ge*) pAGen);
+	MultiMac_Fast_Custom_Init(pAGen, (secp256k1_ge*) pAGen);
+
+#endif // BeamCrypto_ExternalGej
+}
+
+__stack_hungry__
+void CoinID_getCommRawEx(const secp256k1_scalar* pkG, secp256k1_scalar* pkH, const CustomGenerator* pAGen, gej_t* pGej)
+{
+	Context* pCtx = Context_get();
+
+	// sk*G + v*H
+
+#ifdef BeamCrypto_ExternalGej
+
+	MulG(pGej, pkG);
+
+	gej_t gej;
+	Gej_Init(&gej);
+
+	if (!pAGen)
+	{
+		Gej_Set_Affine(&gej, &pCtx->m_GenH);
+		pAGen = &gej;
+	}
+
+	Gej_MulFast(&gej, pAGen, pkH);
+	Gej_Add(pGej, pGej, &gej);
+
+	Gej_Destroy(&gej);
+
+#else // BeamCrypto_ExternalGej
+
+	// v*H by the fast MultiMac (v is usually short), sk*G by the comb
+	union
+	{
+		struct {
+			MultiMac_WNaf wnaf;
+			MultiMac_Context mmCtx;
+		} p1;
+
+		gej_t gej;
+	} u;
+
+	u.p1.mmCtx.m_pRes = pGej;
+	u.p1.mmCtx.m_Secure.m_Count = 0;
+	u.p1.mmCtx.m_Fast.m_Count = 1;
+	u.p1.mmCtx.m_Fast.m_pK = pkH;
+	u.p1.mmCtx.m_Fast.m_pWnaf = &u.p1.wnaf;
 
 	if (pAGen)
 	{
-		mmCtx.m_Fast.m_pGen0 = pAGen->m_pPt;
-		mmCtx.m_Fast.m_WndBits = c_MultiMac_nBits_Custom;
-		mmCtx.m_Fast.m_pZDenom = &pAGen->m_zDenom;
+		u.p1.mmCtx.m_Fast.m_pGen0 = pAGen->m_pPt;
+		u.p1.mmCtx.m_Fast.m_WndBits = c_MultiMac_nBits_Custom;
+		u.p1.mmCtx.m_Fast.m_pZDenom = &pAGen->m_zDenom;
 	}
 	else
 	{
-		mmCtx.m_Fast.m_pGen0 = pCtx->m_pGenH;
-		mmCtx.m_Fast.m_WndBits = c_MultiMac_nBits_H;
-		mmCtx.m_Fast.m_pZDenom = 0;
+		u.p1.mmCtx.m_Fast.m_pGen0 = pCtx->m_pGenH;
+		u.p1.mmCtx.m_Fast.m_WndBits = c_MultiMac_nBits_H;
+		u.p1.mmCtx.m_Fast.m_pZDenom = 0;
 	}
 
-	MultiMac_Calculate(&mmCtx);
+	MultiMac_Calculate(&u.p1.mmCtx);
+
+	MulG(&u.gej, pkG);
+	wrap_gej_add_var(pGej, pGej, &u.gej);
 #endif // BeamCrypto_ExternalGej
 }
 
@@ -1289,15 +2197,21 @@ void CoinID_getCommRaw(const secp256k1_scalar* pK, Amount amount, const CustomGe
 }
 
 __stack_hungry__
-static void CoinID_getSkNonSwitch(const Kdf* pKdf, const CoinID* pCid, secp256k1_scalar* pK)
+static void CoinID_getSkNonSwitchChild(const Kdf* pKdfC, const CoinID* pCid, secp256k1_scalar* pK)
 {
 	UintBig hv;
 	CoinID_getHash(pCid, &hv);
 
+	Kdf_Derive_SKey(pKdfC, &hv, pK);
+}
+
+__stack_hungry__
+static void CoinID_getSkNonSwitch(const Kdf* pKdf, const CoinID* pCid, secp256k1_scalar* pK)
+{
 	Kdf kdfC;
 	Kdf_getChild(&kdfC, CoinID_getSubkey(pCid), pKdf);
 
-	Kdf_Derive_SKey(&kdfC, &hv, pK);
+	CoinID_getSkNonSwitchChild(&kdfC, pCid, pK);
 	SECURE_ERASE_OBJ(kdfC);
 }
 
@@ -1351,19 +2265,21 @@ static void CoinID_getSkComm_FromNonSwitchK(const CoinID* pCid, secp256k1_scalar
 }
 
 __stack_hungry__
-void CoinID_getSkComm(const Kdf* pKdf, const CoinID* pCid, secp256k1_scalar* pK, CompactPoint* pComm)
+static void CoinID_getSkComm_FromNonSwitch(const CoinID* pCid, secp256k1_scalar* pK, CompactPoint* pComm, const CustomGenerator* pAGen)
 {
-	CoinID_getSkNonSwitch(pKdf, pCid, pK);
-
+	// pAGen - the already prepared generator of the coin asset, or 0
 	CustomGenerator aGen;
 #ifdef BeamCrypto_ExternalGej
 	Gej_Init(&aGen);
 #endif // BeamCrypto_ExternalGej
 
-	if (pCid->m_AssetID)
+	if (pCid->m_AssetID && !pAGen)
+	{
 		CoinID_GenerateAGen(pCid->m_AssetID, &aGen);
+		pAGen = &aGen;
+	}
 
-	CoinID_getSkComm_FromNonSwitchK(pCid, pK, pComm, pCid->m_AssetID ? &aGen : 0);
+	CoinID_getSkComm_FromNonSwitchK(pCid, pK, pComm, pAGen);
 
 #ifdef BeamCrypto_ExternalGej
 	Gej_Destroy(&aGen);
@@ -1371,7 +2287,177 @@ void CoinID_getSkComm(const Kdf* pKdf, const CoinID* pCid, secp256k1_scalar* pK,
 }
 
 __stack_hungry__
-static void ShieldedInput_getSk(const KeyKeeper* p, const ShieldedInput_Blob* pInpBlob, const ShieldedInput_Fmt* pInpFmt, secp256k1_scalar* pK)
+void CoinID_getSkComm(const Kdf* pKdf, const CoinID* pCid, secp256k1_scalar* pK, CompactPoint* pComm)
+{
+	CoinID_getSkNonSwitch(pKdf, pCid, pK);
+	CoinID_getSkComm_FromNonSwitch(pCid, pK, pComm, 0);
+}
+
+void CoinID_getSkCommChild(const Kdf* pKdfC, const CoinID* pCid, secp256k1_scalar* pK, CompactPoint* pComm)
+{
+	CoinID_getSkNonSwitchChild(pKdfC, pCid, pK);
+	CoinID_getSkComm_FromNonSwitch(pCid, pK, pComm, 0);
+}
+
+#ifdef BeamCrypto_Sha256Accel
+__stack_hungry__
+static void CoinID_getSkNonSwitchChild_N(const Kdf* const* ppKdfC, const CoinID* const* ppCid, secp256k1_scalar* const* ppK, unsigned int n)
+{
+	assert(n <= c_Sha256_BatchMax);
+
+	UintBig pHv[c_Sha256_BatchMax];
+	UintBig* ppHv[c_Sha256_BatchMax];
+
+	for (unsigned int i = 0; i < n; i++)
+		ppHv[i] = pHv + i;
+
+	CoinID_getHash_N(ppCid, ppHv, n);
+	Kdf_Derive_SKey_N(ppKdfC, (const UintBig* const*) ppHv, ppK, n);
+}
+
+void CoinID_getSkChild_N(const Kdf* const* ppKdfC, const CoinID* const* ppCid, secp256k1_scalar* const* ppK, unsigned int n)
+{
+	// same as CoinID_getSkCommChild() without the commitment, the non-switch key derivations are batched
+	CoinID_getSkNonSwitchChild_N(ppKdfC, ppCid, ppK, n);
+
+	for (unsigned int i = 0; i < n; i++)
+		CoinID_getSkComm_FromNonSwitch(ppCid[i], ppK[i], 0, 0);
+}
+#endif // BeamCrypto_Sha256Accel
+
+//////////////////////////////
+// KeyKeeper - child Kdf cache
+// LRU of the derived child Kdfs. An entry with zero m_Stamp is empty, i.e. the zeroed KeyKeeper (as it is whenever the master key is set) has an empty cache.
+static KeyKeeper_ChildKdf* KeyKeeper_FindChildKdf(KeyKeeper* p, uint32_t iChild)
+{
+	for (uint32_t i = 0; i < c_KeyKeeper_nChildKdf; i++)
+	{
+		KeyKeeper_ChildKdf* pE = p->m_pChildKdf + i;
+		if (pE->m_Stamp && (pE->m_iChild == iChild))
+		{
+			pE->m_Stamp = ++p->m_CacheStamp;
+			return pE;
+		}
+	}
+
+	return 0;
+}
+
+static KeyKeeper_ChildKdf* KeyKeeper_AllocChildKdf(KeyKeeper* p, uint32_t iChild)
+{
+	// evict the least recently used (or an empty one). Its Kdf is to be overwritten by the caller
+	KeyKeeper_ChildKdf* pE = p->m_pChildKdf;
+	for (uint32_t i = 1; i < c_KeyKeeper_nChildKdf; i++)
+		if (p->m_pChildKdf[i].m_Stamp < pE->m_Stamp)
+			pE = p->m_pChildKdf + i;
+
+	pE->m_iChild = iChild;
+	pE->m_Stamp = ++p->m_CacheStamp;
+	return pE;
+}
+
+// The returned Kdf is valid until the next cache access
+__stack_hungry__
+static const Kdf* KeyKeeper_getChildKdf(KeyKeeper* p, uint32_t iChild)
+{
+	KeyKeeper_ChildKdf* pE = KeyKeeper_FindChildKdf(p, iChild);
+	if (!pE)
+	{
+		pE = KeyKeeper_AllocChildKdf(p, iChild);
+		Kdf_getChild(&pE->m_Kdf, iChild, &p->m_MasterKey);
+	}
+
+	return &pE->m_Kdf;
+}
+
+#ifdef BeamCrypto_Sha256Accel
+__stack_hungry__
+static void KeyKeeper_getChildKdf_N(KeyKeeper* p, const uint32_t* pChild, Kdf* pKdfC, unsigned int n)
+{
+	// copies of the child Kdfs. The missing ones are derived in a batch, and then cached
+	assert(n <= c_Sha256_BatchMax);
+
+	Kdf* ppMiss[c_Sha256_BatchMax];
+	uint32_t pMiss[c_Sha256_BatchMax];
+	uint8_t pSrc[c_Sha256_BatchMax]; // 1 + index of the missing Kdf, or 0 if cached
+	unsigned int nMiss = 0;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		pSrc[i] = 0;
+
+		const KeyKeeper_ChildKdf* pE = KeyKeeper_FindChildKdf(p, pChild[i]);
+		if (pE)
+		{
+			pKdfC[i] = pE->m_Kdf;
+			continue;
+		}
+
+		unsigned int iMiss = 0;
+		while ((iMiss < nMiss) && (pMiss[iMiss] != pChild[i]))
+			iMiss++;
+
+		if (iMiss == nMiss)
+		{
+			pMiss[nMiss] = pChild[i];
+			ppMiss[nMiss] = pKdfC + i;
+			nMiss++;
+		}
+
+		pSrc[i] = (uint8_t) (iMiss + 1);
+	}
+
+	Kdf_getChild_N(ppMiss, pMiss, &p->m_MasterKey, nMiss);
+
+	for (unsigned int iMiss = 0; iMiss < nMiss; iMiss++)
+		KeyKeeper_AllocChildKdf(p, pMiss[iMiss])->m_Kdf = *ppMiss[iMiss];
+
+	for (unsigned int i = 0; i < n; i++)
+		if (pSrc[i] && (ppMiss[pSrc[i] - 1] != pKdfC + i))
+			pKdfC[i] = *ppMiss[pSrc[i] - 1]; // repeated
+}
+#endif // BeamCrypto_Sha256Accel
+
+//////////////////////////////
+// KeyKeeper - asset generator cache
+// LRU of the prepared asset generators, same as the child Kdf cache. Public data, no need to erase.
+// Returns the generator of the asset, or 0 if there's no asset or no cache, then it should be generated by the caller (CoinID_GenerateAGen).
+// The returned generator is valid until the next cache access
+static const CustomGenerator* KeyKeeper_getAGen(KeyKeeper* p, AssetID aid)
+{
+#if c_KeyKeeper_nAGen
+	if (!aid)
+		return 0;
+
+	KeyKeeper_AGen* pVictim = p->m_pAGen;
+
+	for (uint32_t i = 0; i < c_KeyKeeper_nAGen; i++)
+	{
+		KeyKeeper_AGen* pE = p->m_pAGen + i;
+		if (pE->m_Stamp && (pE->m_Aid == aid))
+		{
+			pE->m_Stamp = ++p->m_CacheStamp;
+			return &pE->m_Gen;
+		}
+
+		if (pE->m_Stamp < pVictim->m_Stamp)
+			pVictim = pE;
+	}
+
+	CoinID_GenerateAGen(aid, &pVictim->m_Gen);
+	pVictim->m_Aid = aid;
+	pVictim->m_Stamp = ++p->m_CacheStamp;
+	return &pVictim->m_Gen;
+
+#else // c_KeyKeeper_nAGen
+	UNUSED(p);
+	UNUSED(aid);
+	return 0;
+#endif // c_KeyKeeper_nAGen
+}
+
+__stack_hungry__
+static void ShieldedInput_getSk(KeyKeeper* p, const ShieldedInput_Blob* pInpBlob, const ShieldedInput_Fmt* pInpFmt, secp256k1_scalar* pK)
 {
 	UintBig hv;
 	secp256k1_sha256_t sha;
@@ -1386,9 +2472,7 @@ static void ShieldedInput_getSk(const KeyKeeper* p, const ShieldedInput_Blob* pI
 	secp256k1_sha256_write_Num(&sha, pInpFmt->m_nViewerIdx);
 	secp256k1_sha256_finalize(&sha, hv.m_pVal);
 
-	Kdf kdfChild;
-	Kdf_getChild(&kdfChild, c_ShieldedInput_ChildKdf, &p->m_MasterKey);
-	Kdf_Derive_SKey(&kdfChild, &hv, pK);
+	Kdf_Derive_SKey(KeyKeeper_getChildKdf(p, c_ShieldedInput_ChildKdf), &hv, pK);
 }
 
 //////////////////////////////
@@ -1425,8 +2509,8 @@ static void RangeProof_Calculate_Before_S(RangeProof* const p, RangeProof_Worker
 	secp256k1_sha256_finalize(&oracle.m_sha, hv.m_pVal);
 
 	// NonceGen
-	static const char szSalt[] = "bulletproof";
-	NonceGenerator_Init(&pWrk->m_NonceGen, szSalt, sizeof(szSalt), &hv);
+	static const HMacSalt salt = HMacSalt_bulletproof;
+	NonceGenerator_Init(&pWrk->m_NonceGen, &salt, &hv);
 
 	NonceGenerator_NextScalar(&pWrk->m_NonceGen, &pWrk->m_alpha); // alpha
 
@@ -1466,9 +2550,9 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 	// Data buffers needed for calculating Part1.S
 	// Need to multi-exponentiate nDims * 2 == 128 elements.
 	// Calculating everything in a single pass is faster, but requires more buffers (stack memory)
-	// Each element size is sizeof(secp256k1_scalar) + sizeof(MultiMac_WNaf) == 34 bytes
+	// Each element size is sizeof(secp256k1_scalar) + sizeof(MultiMac_WNaf) == 36 bytes
 	//
-	// This requires of 4.25K stack memory
+	// This requires of 4.5K stack memory
 #define nDims (sizeof(Amount) * 8)
 #define Calc_S_Naggle_Max (nDims * 2)
 
@@ -1480,10 +2564,13 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 
 	static_assert(Calc_S_Naggle <= Calc_S_Naggle_Max, "Naggle too large");
 
+	HMacSalt prk; // all the scalars are from the same generator
+	NonceGenerator_PrepareHMac(&pWrk->m_NonceGen, &prk);
+
 #ifdef BeamCrypto_ExternalGej
 
 	secp256k1_scalar s;
-	NonceGenerator_NextScalar(&pWrk->m_NonceGen, &s);
+	NonceGenerator_NextScalarEx(&pWrk->m_NonceGen, &prk, &s);
 	MulG(pWrk->m_pGej + 1, &s); // can mul fast!
 
 	gej_t gej1, gej2;
@@ -1497,16 +2584,15 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 	secp256k1_scalar pS[Calc_S_Naggle];
 	MultiMac_WNaf pWnaf[Calc_S_Naggle];
 
-	secp256k1_scalar* const pRho = (secp256k1_scalar*) (pWrk->m_pGej + (Calc_S_Naggle < Calc_S_Naggle_Max)); // reuse its mem
-	// depending on naggling, the 1st point would be either pGej o pGej+1, hence we may use the other one
+	// rho*G by the comb goes to pGej[0], which accumulates. The flushes go to pGej[1], it's free until then, reuse its mem for rho
+	secp256k1_scalar* const pRho = (secp256k1_scalar*) (pWrk->m_pGej + 1);
 
-	NonceGenerator_NextScalar(&pWrk->m_NonceGen, pRho);
+	NonceGenerator_NextScalarEx(&pWrk->m_NonceGen, &prk, pRho);
+	MulG(pWrk->m_pGej, pRho);
 
 	MultiMac_Context mmCtx;
-
-	mmCtx.m_Secure.m_Count = 1;
-	mmCtx.m_Secure.m_pK = pRho;
-	mmCtx.m_Secure.m_pGen = Context_get()->m_pGenGJ;
+	mmCtx.m_pRes = pWrk->m_pGej + 1;
+	mmCtx.m_Secure.m_Count = 0;
 
 	mmCtx.m_Fast.m_pZDenom = 0;
 	mmCtx.m_Fast.m_Count = 0;
@@ -1526,13 +2612,9 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 		if (Calc_S_Naggle == mmCtx.m_Fast.m_Count)
 		{
 			// flush
-			mmCtx.m_pRes = pWrk->m_pGej + (iBit != Calc_S_Naggle); // 1st flush goes to pGej[0] directly
 			MultiMac_Calculate(&mmCtx);
+			wrap_gej_add_var(pWrk->m_pGej, pWrk->m_pGej + 1, pWrk->m_pGej);
 
-			if (iBit != Calc_S_Naggle)
-				wrap_gej_add_var(pWrk->m_pGej, pWrk->m_pGej + 1, pWrk->m_pGej);
-
-			mmCtx.m_Secure.m_Count = 0;
 			mmCtx.m_Fast.m_Count = 0;
 			mmCtx.m_Fast.m_pGen0 += Calc_S_Naggle * c_MultiMac_OddCount(c_MultiMac_nBits_Rangeproof);
 		}
@@ -1542,7 +2624,7 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 
 #endif // BeamCrypto_ExternalGej
 
-		NonceGenerator_NextScalar(&pWrk->m_NonceGen, pTrg);
+		NonceGenerator_NextScalarEx(&pWrk->m_NonceGen, &prk, pTrg);
 
 		if (!(iBit % nDims) && p->m_pKExtra)
 		{
@@ -1569,6 +2651,8 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 #endif // BeamCrypto_ExternalGej
 	}
 
+	SECURE_ERASE_OBJ(prk);
+
 #ifdef BeamCrypto_ExternalGej
 
 	Gej_Destroy(&gej2);
@@ -1576,11 +2660,8 @@ static void RangeProof_Calculate_S(RangeProof* const p, RangeProof_Worker* const
 
 #else // BeamCrypto_ExternalGej
 
-	mmCtx.m_pRes = pWrk->m_pGej + 1;
 	MultiMac_Calculate(&mmCtx);
-
-	if (Calc_S_Naggle < Calc_S_Naggle_Max)
-		wrap_gej_add_var(pWrk->m_pGej + 1, pWrk->m_pGej + 1, pWrk->m_pGej);
+	wrap_gej_add_var(pWrk->m_pGej + 1, pWrk->m_pGej + 1, pWrk->m_pGej);
 
 #endif // BeamCrypto_ExternalGej
 }
@@ -1610,6 +2691,16 @@ static void RangeProof_Calculate_A_Bits(gej_t* pRes, secp256k1_ge* pGeTmp, Amoun
 
 	Gej_Destroy(&gej);
 
+#elif defined(c_MultiMac_Rangeproof_nBytes)
+
+	static_assert(sizeof(v) == c_MultiMac_Rangeproof_nBytes, "");
+
+	for (uint32_t i = 0; i < c_MultiMac_Rangeproof_nBytes; i++)
+	{
+		secp256k1_ge_from_storage(pGeTmp, pCtx->m_pGenRangeproofBytes[i] + (uint8_t) (v >> (i * 8)));
+		wrap_gej_add_ge_var(pRes, pRes, pGeTmp);
+	}
+
 #else // BeamCrypto_ExternalGej
 
 	for (uint32_t i = 0; i < nDims; i++)
@@ -1660,10 +2751,10 @@ static int RangeProof_Calculate_After_S(RangeProof* const p, RangeProof_Worker*
 
 	{
 		// Use the challenges, sk, T1 and T2 to init the NonceGen for blinding the sk
-		static const char szSalt[] = "bulletproof-sk";
+		static const HMacSalt salt = HMacSalt_bulletproof_sk;
 
 		secp256k1_hmac_sha256_t hmac;
-		NonceGenerator_InitBegin(&pWrk->m_NonceGen, &hmac, szSalt, sizeof(szSalt));
+		NonceGenerator_InitBegin(&pWrk->m_NonceGen, &hmac, &salt);
 
 		UintBig hv;
 		secp256k1_scalar_get_b32(hv.m_pVal, &pWrk->m_sk);
@@ -1684,10 +2775,10 @@ static int RangeProof_Calculate_After_S(RangeProof* const p, RangeProof_Worker*
 
 	secp256k1_scalar zChallenge = pK[1];
 
+	NonceGenerator_NextScalars(&pWrk->m_NonceGen, pK, 2); // tau1/2
+
 	for (unsigned int i = 0; i < 2; i++)
 	{
-		NonceGenerator_NextScalar(&pWrk->m_NonceGen, pK + i); // tau1/2
-
 		MulG(pWrk->m_pGej + i, pK + i); // pub nonces of T1/T2
 
 		secp256k1_ge ge;
@@ -1744,6 +2835,15 @@ static int RangeProof_Calculate_After_S(RangeProof* const p, RangeProof_Worker*
 	return ok;
 }
 
+// The worker sk and commitment are already set
+static int RangeProof_Calculate_Wrk(RangeProof* const p, RangeProof_Worker* const pWrk)
+{
+	RangeProof_Calculate_Before_S(p, pWrk);
+	RangeProof_Calculate_S(p, pWrk);
+
+	return RangeProof_Calculate_After_S(p, pWrk);
+}
+
 __stack_hungry__
 int RangeProof_Calculate(RangeProof* p)
 {
@@ -1751,12 +2851,15 @@ int RangeProof_Calculate(RangeProof* p)
 	Gej_Init(wrk.m_pGej);
 	Gej_Init(wrk.m_pGej + 1);
 
-	CoinID_getSkComm(p->m_pKdf, &p->m_Cid, &wrk.m_sk, &wrk.m_Commitment);
-
-	RangeProof_Calculate_Before_S(p, &wrk);
-	RangeProof_Calculate_S(p, &wrk);
+	if (p->m_pKdfChild)
+	{
+		CoinID_getSkNonSwitchChild(p->m_pKdfChild, &p->m_Cid, &wrk.m_sk);
+		CoinID_getSkComm_FromNonSwitch(&p->m_Cid, &wrk.m_sk, &wrk.m_Commitment, p->m_pAGen);
+	}
+	else
+		CoinID_getSkComm(p->m_pKdf, &p->m_Cid, &wrk.m_sk, &wrk.m_Commitment);
 
-	int res = RangeProof_Calculate_After_S(p, &wrk);
+	int res = RangeProof_Calculate_Wrk(p, &wrk);
 
 	Gej_Destroy(wrk.m_pGej + 1);
 	Gej_Destroy(wrk.m_pGej);
@@ -1842,8 +2945,8 @@ static void RangeProof_Recover_Init(const RangeProof_Packed* pRangeproof, Oracle
 __stack_hungry__
 static int RangeProof_Recover1(RangeProof_Recovery_Context* pCtx)
 {
-	static const char szSalt[] = "bulletproof";
-	NonceGenerator_Init(&pCtx->m_Ng, szSalt, sizeof(szSalt), &pCtx->m_Seed);
+	static const HMacSalt salt = HMacSalt_bulletproof;
+	NonceGenerator_Init(&pCtx->m_Ng, &salt, &pCtx->m_Seed);
 
 	secp256k1_scalar alpha_minus_params, ro, tmp;
 	NonceGenerator_NextScalar(&pCtx->m_Ng, &alpha_minus_params);
@@ -1919,9 +3022,9 @@ static void RangeProof_Recover2(RangeProof_Recovery_Context* pCtx)
 
 	// recover the blinding factor
 	{
-		static const char szSaltSk[] = "bp-key";
+		static const HMacSalt saltSk = HMacSalt_bp_key;
 		NonceGenerator ngSk;
-		NonceGenerator_Init(&ngSk, szSaltSk, sizeof(szSaltSk), &pCtx->m_Seed);
+		NonceGenerator_Init(&ngSk, &saltSk, &pCtx->m_Seed);
 		NonceGenerator_NextScalar(&ngSk, &tau1);
 		NonceGenerator_NextScalar(&ngSk, &tau2);
 	}
@@ -1957,6 +3060,9 @@ static void RangeProof_Recover3(RangeProof_Recovery_Context* pCtx)
 
 	static_assert(!(nDims & 1), ""); // must be even
 
+	HMacSalt prk; // all the scalars are from the same generator
+	NonceGenerator_PrepareHMac(&pCtx->m_Ng, &prk);
+
 	for (unsigned int j = 0; j < 2; j++)
 	{
 		secp256k1_scalar pS[nDims / 2]; // 32 elements, 1K stack size. Perform 1st condensation in-place (otherwise we'd need to prepare 64 elements first)
@@ -1964,7 +3070,7 @@ static void RangeProof_Recover3(RangeProof_Recovery_Context* pCtx)
 		for (uint32_t i = 0; i < nDims; i++)
 		{
 			secp256k1_scalar val;
-			NonceGenerator_NextScalar(&pCtx->m_Ng, &val);
+			NonceGenerator_NextScalarEx(&pCtx->m_Ng, &prk, &val);
 
 			uint32_t bit = 1 & (pCtx->m_Amount >> i);
 			secp256k1_scalar tmp2;
@@ -2030,6 +3136,7 @@ static void RangeProof_Recover3(RangeProof_Recovery_Context* pCtx)
 		wrap_scalar_mul(pCtx->m_pExtra + j, pCtx->m_pExtra + j, pS);
 	}
 
+	SECURE_ERASE_OBJ(prk);
 }
 
 //////////////////////////////
@@ -2060,8 +3167,8 @@ void Signature_Sign(Signature* p, const UintBig* pMsg, const secp256k1_scalar* p
 	} u2;
 
 	NonceGenerator ng;
-	static const char szSalt[] = "beam-Schnorr";
-	NonceGenerator_InitBegin(&ng, &u2.hmac, szSalt, sizeof(szSalt));
+	static const HMacSalt salt = HMacSalt_beam_Schnorr;
+	NonceGenerator_InitBegin(&ng, &u2.hmac, &salt);
 
 	union
 	{
@@ -2110,64 +3217,236 @@ void Signature_SignPartial(Signature* p, const UintBig* pMsg, const secp256k1_sc
 	Signature_SignPartialEx(&p->m_k, &e, pSk, pNonce);
 }
 
-__stack_hungry__
-static int Signature_IsValid_Internal(const Signature* p, const UintBig* pMsg, CustomGenerator* pPkGen)
+#ifdef BeamCrypto_FastVerify
+
+//////////////////////////////
+// Variable-time verification. All the data is public, no need for the 'secure' G multiplication.
+// k*G + e*Pk is calculated by a joint wNAF over GLV-split scalars, G from the precomputed table of odd multiples (m_pGenVerifyG).
+
+#ifdef BeamCrypto_ExternalGej
+#	error BeamCrypto_FastVerify requires the native MultiMac
+#endif // BeamCrypto_ExternalGej
+
+static_assert((c_MultiMac_OddCount(c_MultiMac_nBits_Verify) * 2) < c_WNaf_Invalid, "");
+
+typedef struct
 {
-	gej_t gej;
-	Gej_Init(&gej);
+	secp256k1_scalar m_k;
+	MultiMac_WNaf m_Wnaf;
+	const secp256k1_ge_storage* m_pTbl;
+	uint8_t m_nWndBits;
+	uint8_t m_Lambda;
+	uint8_t m_Neg;
+	uint8_t m_Affine; // needs the common z-denominator correction
 
-	union
-	{
-		struct {
-			secp256k1_scalar k;
-			secp256k1_scalar s;
-			int overflow;
-			MultiMac_WNaf wnaf;
-		} p1;
+} FastVerify_Cursor;
 
-		secp256k1_ge geNonce;
-	} u;
+static void FastVerify_Load(secp256k1_ge* pGe, const FastVerify_Cursor* pCur, unsigned int iElem)
+{
+	unsigned int nMaxElements = c_MultiMac_OddCount(pCur->m_nWndBits);
 
-	// for historical reasons we don't check for overflow, i.e. theoretically there can be an ambiguity, but it makes not much sense for the attacker
-	secp256k1_scalar_set_b32(&u.p1.k, p->m_k.m_pVal, &u.p1.overflow);
+	int bNegate = (iElem >= nMaxElements);
+	if (bNegate)
+		iElem = (nMaxElements * 2 - 1) - iElem;
 
-#ifdef BeamCrypto_ExternalGej
-	MulG(&gej, &u.p1.k);
-#else // BeamCrypto_ExternalGej
-	MultiMac_Context ctx;
-	ctx.m_pRes = &gej;
-	ctx.m_Secure.m_Count = 1;
-	ctx.m_Secure.m_pGen = Context_get()->m_pGenGJ;
-	ctx.m_Secure.m_pK = &u.p1.k;
+	secp256k1_ge_from_storage(pGe, pCur->m_pTbl + iElem);
 
-#endif // BeamCrypto_ExternalGej
+	if (pCur->m_Lambda)
+		secp256k1_ge_mul_lambda(pGe, pGe);
 
-	if (!pPkGen)
-	{
-		// unlikely, but allowed for historical reasons
-#ifndef BeamCrypto_ExternalGej
-		ctx.m_Fast.m_Count = 0;
-#endif // BeamCrypto_ExternalGej
-	}
+	if (bNegate != pCur->m_Neg)
+		wrap_ge_neg(pGe, pGe);
+}
+
+static void FastVerify_Add(gej_t* pRes, const FastVerify_Cursor* pCur, unsigned int iElem, const secp256k1_fe* pZDenom)
+{
+	secp256k1_ge ge;
+	FastVerify_Load(&ge, pCur, iElem);
+
+	if (pZDenom && pCur->m_Affine)
+		wrap_gej_add_zinv_var(pRes, pRes, &ge, pZDenom);
 	else
-	{
-		Signature_GetChallenge(p, pMsg, &u.p1.s);
+		wrap_gej_add_ge_var(pRes, pRes, &ge);
+}
 
-#ifdef BeamCrypto_ExternalGej
-		Gej_MulFast(pPkGen, pPkGen, &u.p1.s);
-		Gej_Add(&gej, &gej, pPkGen);
-#else // BeamCrypto_ExternalGej
-		ctx.m_Fast.m_Count = 1;
-		ctx.m_Fast.m_pZDenom = &pPkGen->m_zDenom;
-		ctx.m_Fast.m_pGen0 = pPkGen->m_pPt;
-		ctx.m_Fast.m_WndBits = c_MultiMac_nBits_Custom;
-		ctx.m_Fast.m_pK = &u.p1.s;
-		ctx.m_Fast.m_pWnaf = &u.p1.wnaf;
-#endif // BeamCrypto_ExternalGej
-	}
+static void FastVerify_AddScalar(FastVerify_Cursor* pCur, const secp256k1_scalar* pK, const secp256k1_ge_storage* pTbl, unsigned int nWndBits, int bAffine)
+{
+	secp256k1_scalar_split_lambda(&pCur[0].m_k, &pCur[1].m_k, pK);
+
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		pCur[i].m_pTbl = pTbl;
+		pCur[i].m_nWndBits = (uint8_t) nWndBits;
+		pCur[i].m_Lambda = (uint8_t) i;
+		pCur[i].m_Affine = (uint8_t) bAffine;
+		pCur[i].m_Neg = (uint8_t) secp256k1_scalar_is_high(&pCur[i].m_k);
+
+		if (pCur[i].m_Neg)
+			secp256k1_scalar_negate(&pCur[i].m_k, &pCur[i].m_k);
+	}
+}
+
+static int FastVerify_IsNegNonce(gej_t* pGej, const CompactPoint* pNonce)
+{
+	// pGej == -Nonce, without decompressing the nonce (sqrt). X is compared in jacobian coordinates, then only the y parity is needed.
+	if (pNonce->m_Y > 1)
+		return 0; // not well-formed
+
+	if (secp256k1_gej_is_infinity(pGej))
+		return !pNonce->m_Y && IsUintBigZero(&pNonce->m_X);
+
+	secp256k1_fe x;
+	if (!secp256k1_fe_set_b32(&x, pNonce->m_X.m_pVal))
+		return 0; // not well-formed
+
+	if (!secp256k1_gej_eq_x_var(&x, pGej))
+		return 0;
+
+	secp256k1_ge ge;
+	Point_Ge_from_Gej(&ge, pGej); // inverse, still much cheaper than sqrt
+	secp256k1_fe_normalize_var(&ge.y);
+
+	return secp256k1_fe_is_odd(&ge.y) != pNonce->m_Y;
+}
+
+__stack_hungry__
+static int Signature_IsValid_Fast(const Signature* p, const UintBig* pMsg, const secp256k1_ge* pPk)
+{
+	CustomGenerator gen;
+	FastVerify_Cursor pCur[4];
+	unsigned int nCur = 2;
+
+	// for historical reasons we don't check for overflow, see Signature_IsValid_Internal
+	secp256k1_scalar k;
+	int overflow;
+	secp256k1_scalar_set_b32(&k, p->m_k.m_pVal, &overflow);
+	FastVerify_AddScalar(pCur, &k, Context_get()->m_pGenVerifyG, c_MultiMac_nBits_Verify, 1);
+
+	const secp256k1_fe* pZDenom = 0;
+	if (!secp256k1_ge_is_infinity(pPk))
+	{
+		MultiMac_Fast_Custom_Init(&gen, pPk);
+		pZDenom = &gen.m_zDenom;
+
+		Signature_GetChallenge(p, pMsg, &k);
+		FastVerify_AddScalar(pCur + 2, &k, gen.m_pPt, c_MultiMac_nBits_Custom, 0);
+		nCur = 4;
+	}
+
+	gej_t gej;
+	secp256k1_gej_set_infinity(&gej);
+
+	unsigned int nBits = 0;
+	for (unsigned int i = 0; i < nCur; i++)
+	{
+		if (WNaf_Cursor_Init(&pCur[i].m_Wnaf, &pCur[i].m_k, pCur[i].m_nWndBits))
+		{
+			// can't happen for the split halves (~128 bits), but the full chain would handle it
+			FastVerify_Add(&gej, pCur + i, 0, pZDenom);
+			nBits = c_ECC_nBits;
+		}
+
+		if ((c_WNaf_Invalid != pCur[i].m_Wnaf.m_iElement) && (nBits <= pCur[i].m_Wnaf.m_iBit))
+			nBits = pCur[i].m_Wnaf.m_iBit + 1;
+	}
+
+	for (unsigned int iBit = nBits; iBit--; )
+	{
+		wrap_gej_double_var(&gej, &gej);
+
+		for (unsigned int i = 0; i < nCur; i++)
+		{
+			MultiMac_WNaf* pWnaf = &pCur[i].m_Wnaf;
+			if ((((uint8_t) iBit) != pWnaf->m_iBit) || (c_WNaf_Invalid == pWnaf->m_iElement))
+				continue;
+
+			FastVerify_Add(&gej, pCur + i, pWnaf->m_iElement, pZDenom);
+			WNaf_Cursor_MoveNext(pWnaf, &pCur[i].m_k, pCur[i].m_nWndBits);
+		}
+	}
+
+	if (pZDenom)
+		wrap_fe_mul(&gej.z, &gej.z, pZDenom);
+
+	return FastVerify_IsNegNonce(&gej, &p->m_NoncePub);
+}
+
+__stack_hungry__
+int Signature_IsValid(const Signature* p, const UintBig* pMsg, const CompactPoint* pPk)
+{
+	secp256k1_ge ge;
+	if (!Point_Ge_from_Compact(&ge, pPk))
+		return 0; // bad Pubkey
+
+	return Signature_IsValid_Fast(p, pMsg, &ge);
+}
+
+#else // BeamCrypto_FastVerify
+#	define Signature_IsValid_Secure Signature_IsValid // the only one
+#endif // BeamCrypto_FastVerify
+
+//////////////////////////////
+// Constant-time verification. With BeamCrypto_FastVerify it's only the reference for the tests
+
+__stack_hungry__
+static int Signature_IsValid_Internal(const Signature* p, const UintBig* pMsg, CustomGenerator* pPkGen)
+{
+	gej_t gej;
+	Gej_Init(&gej);
+
+	union
+	{
+		struct {
+			secp256k1_scalar s;
+			MultiMac_WNaf wnaf;
+			MultiMac_Context ctx;
+		} p1;
+
+		gej_t gejK;
+		secp256k1_ge geNonce;
+	} u;
+
+	// for historical reasons we don't check for overflow, i.e. theoretically there can be an ambiguity, but it makes not much sense for the attacker
+	secp256k1_scalar k;
+	int overflow;
+	secp256k1_scalar_set_b32(&k, p->m_k.m_pVal, &overflow);
+
+#ifdef BeamCrypto_ExternalGej
+
+	MulG(&gej, &k);
+
+	if (pPkGen)
+	{
+		Signature_GetChallenge(p, pMsg, &u.p1.s);
+
+		Gej_MulFast(pPkGen, pPkGen, &u.p1.s);
+		Gej_Add(&gej, &gej, pPkGen);
+	}
+
+#else // BeamCrypto_ExternalGej
+
+	// e*Pk by the fast MultiMac, k*G by the comb
+	if (pPkGen)
+	{
+		Signature_GetChallenge(p, pMsg, &u.p1.s);
+
+		u.p1.ctx.m_pRes = &gej;
+		u.p1.ctx.m_Secure.m_Count = 0;
+		u.p1.ctx.m_Fast.m_Count = 1;
+		u.p1.ctx.m_Fast.m_pZDenom = &pPkGen->m_zDenom;
+		u.p1.ctx.m_Fast.m_pGen0 = pPkGen->m_pPt;
+		u.p1.ctx.m_Fast.m_WndBits = c_MultiMac_nBits_Custom;
+		u.p1.ctx.m_Fast.m_pK = &u.p1.s;
+		u.p1.ctx.m_Fast.m_pWnaf = &u.p1.wnaf;
+
+		MultiMac_Calculate(&u.p1.ctx);
+	}
+	else
+		secp256k1_gej_set_infinity(&gej); // unlikely, but allowed for historical reasons
+
+	MulG(&u.gejK, &k);
+	wrap_gej_add_var(&gej, &gej, &u.gejK);
 
-#ifndef BeamCrypto_ExternalGej
-	MultiMac_Calculate(&ctx);
 #endif // BeamCrypto_ExternalGej
 
 	int res = Point_Ge_from_Compact(&u.geNonce, &p->m_NoncePub);
@@ -2181,8 +3460,9 @@ static int Signature_IsValid_Internal(const Signature* p, const UintBig* pMsg, C
 	return res;
 }
 
+
 __stack_hungry__
-int Signature_IsValid(const Signature* p, const UintBig* pMsg, const CompactPoint* pPk)
+int Signature_IsValid_Secure(const Signature* p, const UintBig* pMsg, const CompactPoint* pPk)
 {
 	CustomGenerator gen; // very large
 
@@ -2294,7 +3574,7 @@ void TxKernel_SpecialMsg(secp256k1_sha256_t* pSha, Amount fee, Height hMin, Heig
 //////////////////////////////
 // KeyKeeper - pub Kdf export
 __stack_hungry__
-static void Kdf2Pub(const Kdf* pKdf, KdfPub* pRes)
+void Kdf2Pub(const Kdf* pKdf, KdfPub* pRes)
 {
 	pRes->m_Secret = pKdf->m_Secret;
 
@@ -2321,19 +3601,65 @@ static void Kdf2Pub(const Kdf* pKdf, KdfPub* pRes)
 	Gej_Destroy(pGej);
 }
 
+#if c_KeyKeeper_nPKdf
+
+// Each Kdf2Pub is 2 secure multiplications, the results are memoized. The owner one is kept for the whole session, the children in an LRU.
+// Empty in the zeroed KeyKeeper, same as the other caches.
+void KeyKeeper_InitMasterPub(KeyKeeper* p)
+{
+	Kdf2Pub(&p->m_MasterKey, &p->m_MasterPub);
+	p->m_MasterPubValid = 1;
+}
+
+static KeyKeeper_ChildPKdf* KeyKeeper_getChildPKdf(KeyKeeper* p, uint32_t iChild)
+{
+	KeyKeeper_ChildPKdf* pVictim = p->m_pChildPKdf;
+
+	for (uint32_t i = 0; i < c_KeyKeeper_nPKdf; i++)
+	{
+		KeyKeeper_ChildPKdf* pE = p->m_pChildPKdf + i;
+		if (pE->m_Stamp && (pE->m_iChild == iChild))
+		{
+			pE->m_Stamp = ++p->m_CacheStamp;
+			return pE;
+		}
+
+		if (pE->m_Stamp < pVictim->m_Stamp)
+			pVictim = pE;
+	}
+
+	Kdf2Pub(KeyKeeper_getChildKdf(p, iChild), &pVictim->m_Pub);
+	pVictim->m_iChild = iChild;
+	pVictim->m_Stamp = ++p->m_CacheStamp;
+	return pVictim;
+}
+
 __stack_hungry__
-void KeyKeeper_GetPKdf(const KeyKeeper* p, KdfPub* pRes, const uint32_t* pChild)
+void KeyKeeper_GetPKdf(KeyKeeper* p, KdfPub* pRes, const uint32_t* pChild)
 {
 	if (pChild)
+		*pRes = KeyKeeper_getChildPKdf(p, *pChild)->m_Pub;
+	else
 	{
-		Kdf kdfChild;
-		Kdf_getChild(&kdfChild, *pChild, &p->m_MasterKey);
-		Kdf2Pub(&kdfChild, pRes);
+		if (!p->m_MasterPubValid)
+			KeyKeeper_InitMasterPub(p);
+		*pRes = p->m_MasterPub;
 	}
+}
+
+#else // c_KeyKeeper_nPKdf
+
+__stack_hungry__
+void KeyKeeper_GetPKdf(KeyKeeper* p, KdfPub* pRes, const uint32_t* pChild)
+{
+	if (pChild)
+		Kdf2Pub(KeyKeeper_getChildKdf(p, *pChild), pRes);
 	else
 		Kdf2Pub(&p->m_MasterKey, pRes);
 }
 
+#endif // c_KeyKeeper_nPKdf
+
 
 
 //////////////////
@@ -2359,6 +3685,7 @@ typedef struct { \
 	uint8_t m_StatusCode; \
 	BeamCrypto_ProtoResponse_##name(THE_MACRO_Field) \
 } OpOut_##name; \
+enum { c_Proto_Code_##name = id }; \
 PROTO_METHOD(name);
 
 BeamCrypto_ProtoMethods(THE_MACRO_OpCode)
@@ -2501,12 +3828,8 @@ PROTO_METHOD(GetImage)
 	uint32_t iChild;
 	N2H_uint(iChild, pIn->m_iChild, 32);
 
-	Kdf kdfC;
-	Kdf_getChild(&kdfC, iChild, &p->m_MasterKey);
-
 	secp256k1_scalar sk;
-	Kdf_Derive_SKey(&kdfC, &pIn->m_hvSrc, &sk);
-	SECURE_ERASE_OBJ(kdfC);
+	Kdf_Derive_SKey(KeyKeeper_getChildKdf(p, iChild), &pIn->m_hvSrc, &sk);
 
 	const uint8_t pFlag[] = {
 		pIn->m_bG, // copy, coz it'd be overwritten by the result
@@ -2516,79 +3839,425 @@ PROTO_METHOD(GetImage)
 
 	unsigned int nCount = 0;
 
-	for (unsigned int i = 0; i < _countof(pGej); i++)
+	for (unsigned int i = 0; i < _countof(pGej); i++)
+	{
+		if (!pFlag[i])
+			continue;
+
+		Gej_Init(pGej + i);
+		(i ? MulJ : MulG)(pGej + i, &sk);
+		nCount++;
+	}
+
+	if (!nCount)
+		return c_KeyKeeper_Status_Unspecified;
+
+#ifndef BeamCrypto_ExternalGej
+	if (_countof(pGej) == nCount)
+		Point_Gej_2_Normalize(pGej);
+#endif // BeamCrypto_ExternalGej
+
+	CompactPoint* pRes = &pOut->m_ptImageG;
+
+	for (unsigned int i = 0; i < _countof(pGej); i++)
+	{
+		if (pFlag[i])
+		{
+#ifndef BeamCrypto_ExternalGej
+			if (_countof(pGej) == nCount)
+				Point_Compact_from_Ge(pRes + i, (secp256k1_ge*)(pGej + i));
+			else
+#endif // BeamCrypto_ExternalGej
+				Point_Compact_from_Gej(pRes + i, pGej + i);
+
+			Gej_Destroy(pGej + i);
+		}
+		else
+			ZERO_OBJ(pRes[i]);
+	}
+
+	return c_KeyKeeper_Status_Ok;
+}
+
+// Same as GetImage for each record. The records are processed in chunks: their key derivations are batched (if accelerated),
+// and all the resulting points are normalized at once
+#ifdef BeamCrypto_ScarceStack
+#	define c_GetImages_Batch 1
+#else // BeamCrypto_ScarceStack
+#	define c_GetImages_Batch c_KeyKeeper_GetImages_MaxCount // the whole request
+#endif // BeamCrypto_ScarceStack
+
+#ifdef BeamCrypto_Sha256Accel
+static_assert(c_GetImages_Batch <= c_Sha256_BatchMax, "");
+#endif // BeamCrypto_Sha256Accel
+
+__stack_hungry__
+static void GetImages_Chunk(KeyKeeper* p, const GetImages_In* pRec_unaligned, GetImages_Out* pRes_unaligned, unsigned int n)
+{
+	assert(n <= c_GetImages_Batch);
+
+	secp256k1_scalar pSk[c_GetImages_Batch];
+	uint8_t pFlag[c_GetImages_Batch * 2];
+
+#ifdef BeamCrypto_Sha256Accel
+	{
+		Kdf pKdfC[c_GetImages_Batch];
+		const Kdf* ppKdfC[c_GetImages_Batch];
+		uint32_t pChild[c_GetImages_Batch];
+		UintBig pHv[c_GetImages_Batch];
+		const UintBig* ppHv[c_GetImages_Batch];
+		secp256k1_scalar* ppSk[c_GetImages_Batch];
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			N2H_uint(pChild[i], pRec_unaligned[i].m_iChild, 32);
+			pHv[i] = pRec_unaligned[i].m_hvSrc;
+
+			ppKdfC[i] = pKdfC + i;
+			ppHv[i] = pHv + i;
+			ppSk[i] = pSk + i;
+		}
+
+		KeyKeeper_getChildKdf_N(p, pChild, pKdfC, n);
+		Kdf_Derive_SKey_N(ppKdfC, ppHv, ppSk, n);
+
+		SECURE_ERASE_OBJ(pKdfC);
+	}
+#else // BeamCrypto_Sha256Accel
+	for (unsigned int i = 0; i < n; i++)
+	{
+		uint32_t iChild;
+		N2H_uint(iChild, pRec_unaligned[i].m_iChild, 32);
+
+		UintBig hv = pRec_unaligned[i].m_hvSrc;
+		Kdf_Derive_SKey(KeyKeeper_getChildKdf(p, iChild), &hv, pSk + i);
+	}
+#endif // BeamCrypto_Sha256Accel
+
+	// the records are fully read here, the results may overwrite them
+	for (unsigned int i = 0; i < n; i++)
+	{
+		pFlag[i * 2] = pRec_unaligned[i].m_bG;
+		pFlag[i * 2 + 1] = pRec_unaligned[i].m_bJ;
+	}
+
+	gej_t pGej[c_GetImages_Batch * 2];
+	unsigned int nPts = 0;
+
+	for (unsigned int i = 0; i < n * 2; i++)
+	{
+		if (!pFlag[i])
+			continue;
+
+		gej_t* pGej0 = pGej + nPts++;
+		Gej_Init(pGej0);
+		((1 & i) ? MulJ : MulG)(pGej0, pSk + (i >> 1));
+	}
+
+	SECURE_ERASE_OBJ(pSk);
+
+#ifndef BeamCrypto_ExternalGej
+	secp256k1_fe pBuf[c_GetImages_Batch * 2];
+	secp256k1_fe zDenom;
+	Point_Gej_BatchRescale(pGej, nPts, pBuf, &zDenom, 1);
+#endif // BeamCrypto_ExternalGej
+
+	nPts = 0;
+
+	for (unsigned int i = 0; i < n * 2; i++)
+	{
+		CompactPoint* pDst = &pRes_unaligned[i >> 1].m_ptImageG + (1 & i);
+
+		if (pFlag[i])
+		{
+			gej_t* pGej0 = pGej + nPts++;
+#ifdef BeamCrypto_ExternalGej
+			Point_Compact_from_Gej(pDst, pGej0);
+#else // BeamCrypto_ExternalGej
+			Point_Compact_from_Ge(pDst, (secp256k1_ge*) pGej0);
+#endif // BeamCrypto_ExternalGej
+			Gej_Destroy(pGej0);
+		}
+		else
+			ZERO_OBJ(*pDst);
+	}
+}
+
+PROTO_METHOD(GetImages)
+{
+	PROTO_UNUSED_ARGS;
+
+	uint32_t nCount = pIn->m_Count;
+
+	if ((nCount > c_KeyKeeper_GetImages_MaxCount) || (nIn != sizeof(GetImages_In) * nCount) || (nOut < sizeof(GetImages_Out) * nCount))
+		return c_KeyKeeper_Status_ProtoError;
+
+	const GetImages_In* pRec_unaligned = (const GetImages_In*) (pIn + 1);
+	GetImages_Out* pRes_unaligned = (GetImages_Out*) (pOut + 1);
+
+	for (uint32_t i = 0; i < nCount; i++)
+		if (!pRec_unaligned[i].m_bG && !pRec_unaligned[i].m_bJ)
+			return c_KeyKeeper_Status_Unspecified;
+
+	// pIn/pOut may overlap, and the results are larger than the records. Move the records to the end of the out buffer,
+	// then the results of each chunk (written after its records are read) never reach the pending ones
+	if (((const uint8_t*) pRec_unaligned < (uint8_t*) pRes_unaligned + nOut) && ((uint8_t*) pRes_unaligned < (const uint8_t*) pRec_unaligned + nIn))
+	{
+		GetImages_In* pMoved = (GetImages_In*) (((uint8_t*) pRes_unaligned) + nOut - nIn);
+		memmove(pMoved, pRec_unaligned, nIn);
+		pRec_unaligned = pMoved;
+	}
+
+	*pOutSize += sizeof(GetImages_Out) * nCount;
+
+	while (nCount)
+	{
+		uint32_t nBatch = (nCount < c_GetImages_Batch) ? nCount : c_GetImages_Batch;
+
+		GetImages_Chunk(p, pRec_unaligned, pRes_unaligned, nBatch);
+
+		pRec_unaligned += nBatch;
+		pRes_unaligned += nBatch;
+		nCount -= nBatch;
+	}
+
+	return c_KeyKeeper_Status_Ok;
+}
+
+PROTO_METHOD(CreateOutput)
+{
+	PROTO_UNUSED_ARGS;
+
+	if (nIn)
+		return c_KeyKeeper_Status_ProtoError; // size mismatch
+
+	RangeProof ctx;
+	N2H_CoinID(&ctx.m_Cid, &pIn->m_Cid);
+	ctx.m_pKdf = &p->m_MasterKey;
+	ctx.m_pKdfChild = KeyKeeper_getChildKdf(p, CoinID_getSubkey(&ctx.m_Cid));
+	ctx.m_pAGen = KeyKeeper_getAGen(p, ctx.m_Cid.m_AssetID);
+	ctx.m_pT_In = pIn->m_pT;
+	ctx.m_pT_Out = pIn->m_pT; // use same buf (since we changed to in/out buf design). Copy res later
+
+	secp256k1_scalar sBuf;
+	ctx.m_pTauX = &sBuf;
+
+	static_assert(sizeof(UintBig) == sizeof(secp256k1_scalar), "");
+
+	if (memis0(pIn->m_pKExtra->m_pVal, sizeof(pIn->m_pKExtra)))
+		ctx.m_pKExtra = 0;
+	else
+		ctx.m_pKExtra = pIn->m_pKExtra;
+
+	ctx.m_pAssetGen = IsUintBigZero(&pIn->m_ptAssetGen.m_X) ? 0 : &pIn->m_ptAssetGen;
+
+	if (!RangeProof_Calculate(&ctx))
+		return c_KeyKeeper_Status_Unspecified;
+
+	// copy into out. Do it carefully, since in/out share the same mem
+	static_assert(sizeof(pOut->m_pT) == sizeof(pIn->m_pT), "");
+	memmove(pOut->m_pT, pIn->m_pT, sizeof(pOut->m_pT)); // MUST use memmove!
+
+	secp256k1_scalar_get_b32(pOut->m_TauX.m_pVal, &sBuf);
+
+	return c_KeyKeeper_Status_Ok;
+}
+
+//////////////////////////////
+// KeyKeeper - CreateOutputs
+// The coins are processed in chunks: their key derivations are batched (hashed in lockstep, if accelerated), and the switch commitments are normalized at once.
+// Then the rangeproofs are calculated one by one.
+#ifdef BeamCrypto_ScarceStack
+#	define c_CreateOutputs_Batch 1
+#else // BeamCrypto_ScarceStack
+#	define c_CreateOutputs_Batch c_KeyKeeper_CreateOutputs_MaxCount // the whole request
+#endif // BeamCrypto_ScarceStack
+
+#ifdef BeamCrypto_Sha256Accel
+static_assert(c_CreateOutputs_Batch <= c_Sha256_BatchMax, "");
+#endif // BeamCrypto_Sha256Accel
+
+static const CustomGenerator* CreateOutputs_getAGen(KeyKeeper* p, AssetID aid, CustomGenerator* pGen, AssetID* pAidGen)
+{
+	const CustomGenerator* pRet = KeyKeeper_getAGen(p, aid);
+	if (pRet || !aid)
+		return pRet;
+
+	if (*pAidGen != aid)
+	{
+		CoinID_GenerateAGen(aid, pGen);
+		*pAidGen = aid;
+	}
+
+	return pGen;
+}
+
+// Same as CoinID_getSkCommChild() for each coin
+__stack_hungry__
+static void CreateOutputs_getSkComm(KeyKeeper* p, const CoinID* pCid, secp256k1_scalar* pSk, CompactPoint* pComm, unsigned int n)
+{
+	assert(n <= c_CreateOutputs_Batch);
+
+#ifdef BeamCrypto_Sha256Accel
+	{
+		Kdf pKdfC[c_CreateOutputs_Batch];
+		const Kdf* ppKdfC[c_CreateOutputs_Batch];
+		const CoinID* ppCid[c_CreateOutputs_Batch];
+		uint32_t pSubkey[c_CreateOutputs_Batch];
+		UintBig pHv[c_CreateOutputs_Batch];
+		UintBig* ppHv[c_CreateOutputs_Batch];
+		secp256k1_scalar* ppSk[c_CreateOutputs_Batch];
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			pSubkey[i] = CoinID_getSubkey(pCid + i);
+			ppKdfC[i] = pKdfC + i;
+			ppCid[i] = pCid + i;
+			ppHv[i] = pHv + i;
+			ppSk[i] = pSk + i;
+		}
+
+		KeyKeeper_getChildKdf_N(p, pSubkey, pKdfC, n);
+		CoinID_getHash_N(ppCid, ppHv, n);
+		Kdf_Derive_SKey_N(ppKdfC, (const UintBig* const*) ppHv, ppSk, n);
+
+		SECURE_ERASE_OBJ(pKdfC);
+	}
+#else // BeamCrypto_Sha256Accel
+	for (unsigned int i = 0; i < n; i++)
+		CoinID_getSkNonSwitchChild(KeyKeeper_getChildKdf(p, CoinID_getSubkey(pCid + i)), pCid + i, pSk + i);
+#endif // BeamCrypto_Sha256Accel
+
+	// the asset generators come from the KeyKeeper cache. Without it the last generated one is reused for the following coins of the same asset
+	CustomGenerator aGen;
+	AssetID aidGen = 0;
+
+#ifdef BeamCrypto_ExternalGej
+
+	Gej_Init(&aGen);
+
+	for (unsigned int i = 0; i < n; i++)
+		CoinID_getSkComm_FromNonSwitchK(pCid + i, pSk + i, pComm + i, CreateOutputs_getAGen(p, pCid[i].m_AssetID, &aGen, &aidGen));
+
+	Gej_Destroy(&aGen);
+
+#else // BeamCrypto_ExternalGej
+
+	gej_t pGej[c_CreateOutputs_Batch * 2];
+	secp256k1_fe pBuf[c_CreateOutputs_Batch * 2];
+	secp256k1_fe zDenom;
+
+	for (unsigned int i = 0; i < n; i++)
 	{
-		if (!pFlag[i])
-			continue;
-
-		Gej_Init(pGej + i);
-		MulPoint(pGej + i, Context_get()->m_pGenGJ + i, &sk);
-		nCount++;
+		CoinID_getCommRaw(pSk + i, pCid[i].m_Amount, CreateOutputs_getAGen(p, pCid[i].m_AssetID, &aGen, &aidGen), pGej + i * 2); // sk*G + amount*H(aid)
+		MulJ(pGej + i * 2 + 1, pSk + i); // sk*J
 	}
 
-	if (!nCount)
-		return c_KeyKeeper_Status_Unspecified;
+	Point_Gej_BatchRescale(pGej, n * 2, pBuf, &zDenom, 1);
 
-#ifndef BeamCrypto_ExternalGej
-	if (_countof(pGej) == nCount)
-		Point_Gej_2_Normalize(pGej);
-#endif // BeamCrypto_ExternalGej
+	for (unsigned int i = 0; i < n; i++)
+	{
+		secp256k1_scalar kDelta;
+		CoinID_getSkSwitchDelta(&kDelta, pGej + i * 2);
 
-	CompactPoint* pRes = &pOut->m_ptImageG;
+		secp256k1_scalar_add(pSk + i, pSk + i, &kDelta);
 
-	for (unsigned int i = 0; i < _countof(pGej); i++)
-	{
-		if (pFlag[i])
-		{
-#ifndef BeamCrypto_ExternalGej
-			if (_countof(pGej) == nCount)
-				Point_Compact_from_Ge(pRes + i, (secp256k1_ge*)(pGej + i));
-			else
-#endif // BeamCrypto_ExternalGej
-				Point_Compact_from_Gej(pRes + i, pGej + i);
+		gej_t gej;
+		MulG(&gej, &kDelta);
+		wrap_gej_add_ge_var(&gej, &gej, (secp256k1_ge*) (pGej + i * 2));
 
-			Gej_Destroy(pGej + i);
-		}
-		else
-			ZERO_OBJ(pRes[i]);
+		pGej[i] = gej; // the commitment. The pairs up to i are already consumed
+
+		SECURE_ERASE_OBJ(kDelta);
 	}
 
-	return c_KeyKeeper_Status_Ok;
+	Point_Gej_BatchRescale(pGej, n, pBuf, &zDenom, 1);
+
+	for (unsigned int i = 0; i < n; i++)
+		Point_Compact_from_Ge(pComm + i, (secp256k1_ge*) (pGej + i));
+
+#endif // BeamCrypto_ExternalGej
 }
 
-PROTO_METHOD(CreateOutput)
+PROTO_METHOD(CreateOutputs)
 {
 	PROTO_UNUSED_ARGS;
 
-	if (nIn)
-		return c_KeyKeeper_Status_ProtoError; // size mismatch
+	uint32_t nCount = pIn->m_Count;
 
-	RangeProof ctx;
-	N2H_CoinID(&ctx.m_Cid, &pIn->m_Cid);
-	ctx.m_pKdf = &p->m_MasterKey;
-	ctx.m_pT_In = pIn->m_pT;
-	ctx.m_pT_Out = pIn->m_pT; // use same buf (since we changed to in/out buf design). Copy res later
+	if ((nCount > c_KeyKeeper_CreateOutputs_MaxCount) || (nIn != sizeof(CreateOutputs_In) * nCount) || (nOut < sizeof(CreateOutputs_Out) * nCount))
+		return c_KeyKeeper_Status_ProtoError;
 
-	secp256k1_scalar sBuf;
-	ctx.m_pTauX = &sBuf;
+	// pIn/pOut may overlap. The results are smaller than the records, and written in order, each after its record is read
+	const CreateOutputs_In* pRec_unaligned = (const CreateOutputs_In*) (pIn + 1);
+	CreateOutputs_Out* pRes_unaligned = (CreateOutputs_Out*) (pOut + 1);
 
-	static_assert(sizeof(UintBig) == sizeof(secp256k1_scalar), "");
+	*pOutSize += sizeof(CreateOutputs_Out) * nCount;
 
-	if (memis0(pIn->m_pKExtra->m_pVal, sizeof(pIn->m_pKExtra)))
-		ctx.m_pKExtra = 0;
-	else
-		ctx.m_pKExtra = pIn->m_pKExtra;
+	while (nCount)
+	{
+		uint32_t nBatch = (nCount < c_CreateOutputs_Batch) ? nCount : c_CreateOutputs_Batch;
 
-	ctx.m_pAssetGen = IsUintBigZero(&pIn->m_ptAssetGen.m_X) ? 0 : &pIn->m_ptAssetGen;
+		CoinID pCid[c_CreateOutputs_Batch];
+		secp256k1_scalar pSk[c_CreateOutputs_Batch];
+		CompactPoint pComm[c_CreateOutputs_Batch];
 
-	if (!RangeProof_Calculate(&ctx))
-		return c_KeyKeeper_Status_Unspecified;
+		for (uint32_t i = 0; i < nBatch; i++)
+			N2H_CoinID(pCid + i, &pRec_unaligned[i].m_Cid);
 
-	// copy into out. Do it carefully, since in/out share the same mem
-	static_assert(sizeof(pOut->m_pT) == sizeof(pIn->m_pT), "");
-	memmove(pOut->m_pT, pIn->m_pT, sizeof(pOut->m_pT)); // MUST use memmove!
+		CreateOutputs_getSkComm(p, pCid, pSk, pComm, nBatch);
 
-	secp256k1_scalar_get_b32(pOut->m_TauX.m_pVal, &sBuf);
+		int ok = 1;
+		for (uint32_t i = 0; ok && (i < nBatch); i++, pRec_unaligned++, pRes_unaligned++)
+		{
+			UintBig pKExtra[2];
+			CompactPoint pT[2];
+			CompactPoint ptAssetGen;
+			memcpy(pKExtra, pRec_unaligned->m_pKExtra, sizeof(pKExtra));
+			memcpy(pT, pRec_unaligned->m_pT, sizeof(pT));
+			memcpy(&ptAssetGen, &pRec_unaligned->m_ptAssetGen, sizeof(ptAssetGen));
+
+			secp256k1_scalar tauX;
+
+			RangeProof ctx;
+			ctx.m_Cid = pCid[i];
+			ctx.m_pKdf = &p->m_MasterKey;
+			ctx.m_pKdfChild = 0;
+			ctx.m_pAGen = 0;
+			ctx.m_pAssetGen = IsUintBigZero(&ptAssetGen.m_X) ? 0 : &ptAssetGen;
+			ctx.m_pKExtra = memis0(pKExtra->m_pVal, sizeof(pKExtra)) ? 0 : pKExtra;
+			ctx.m_pT_In = pT;
+			ctx.m_pT_Out = pT;
+			ctx.m_pTauX = &tauX;
+
+			RangeProof_Worker wrk;
+			Gej_Init(wrk.m_pGej);
+			Gej_Init(wrk.m_pGej + 1);
+
+			wrk.m_sk = pSk[i];
+			wrk.m_Commitment = pComm[i];
+
+			ok = RangeProof_Calculate_Wrk(&ctx, &wrk);
+
+			Gej_Destroy(wrk.m_pGej + 1);
+			Gej_Destroy(wrk.m_pGej);
+
+			if (ok)
+			{
+				memcpy(pRes_unaligned->m_pT, pT, sizeof(pT));
+				secp256k1_scalar_get_b32(pRes_unaligned->m_TauX.m_pVal, &tauX);
+			}
+
+			SECURE_ERASE_OBJ(tauX);
+		}
+
+		SECURE_ERASE_OBJ(pSk);
+
+		if (!ok)
+			return c_KeyKeeper_Status_Unspecified;
+
+		nCount -= nBatch;
+	}
 
 	return c_KeyKeeper_Status_Ok;
 }
@@ -2645,6 +4314,64 @@ static int TxAggr_AddAmount(KeyKeeper* p, Amount newVal, AssetID aid, int isOut)
 __stack_hungry__
 static uint16_t TxAggr_AddCoins(KeyKeeper* p, CoinID* pCid_unaligned, uint32_t nCount, int isOut)
 {
+#ifdef BeamCrypto_Sha256Accel
+	// batches of coins, their key derivations are hashed in lockstep
+	CoinID pCid[c_Sha256_BatchMax];
+	const CoinID* ppCid[c_Sha256_BatchMax];
+	Kdf pKdfC[c_Sha256_BatchMax];
+	const Kdf* ppKdfC[c_Sha256_BatchMax];
+	uint32_t pSubkey[c_Sha256_BatchMax];
+	secp256k1_scalar pSk[c_Sha256_BatchMax];
+	secp256k1_scalar* ppSk[c_Sha256_BatchMax];
+
+	while (nCount)
+	{
+		uint32_t nBatch = (nCount < c_Sha256_BatchMax) ? nCount : c_Sha256_BatchMax;
+		uint16_t errCode = c_KeyKeeper_Status_Ok;
+
+		uint32_t nValid = 0;
+		for (; nValid < nBatch; nValid++)
+		{
+			N2H_CoinID(pCid + nValid, pCid_unaligned + nValid);
+
+			if (!TxAggr_AddAmount(p, pCid[nValid].m_Amount, pCid[nValid].m_AssetID, isOut))
+			{
+				errCode = MakeStatus(c_KeyKeeper_Status_Unspecified, 1);
+				break;
+			}
+
+			ppCid[nValid] = pCid + nValid;
+			ppKdfC[nValid] = pKdfC + nValid;
+			pSubkey[nValid] = CoinID_getSubkey(pCid + nValid);
+			ppSk[nValid] = pSk + nValid;
+		}
+
+		// the coins before the failed one are accounted, as in the sequential processing
+		KeyKeeper_getChildKdf_N(p, pSubkey, pKdfC, nValid);
+		CoinID_getSkNonSwitchChild_N(ppKdfC, ppCid, ppSk, nValid);
+		SECURE_ERASE_OBJ(pKdfC);
+
+		for (uint32_t i = 0; i < nValid; i++)
+		{
+			CoinID_getSkComm_FromNonSwitch(pCid + i, pSk + i, 0, KeyKeeper_getAGen(p, pCid[i].m_AssetID));
+
+			if (!isOut)
+				secp256k1_scalar_negate(pSk + i, pSk + i);
+
+			secp256k1_scalar_add(&p->u.m_TxBalance.m_sk, &p->u.m_TxBalance.m_sk, pSk + i);
+		}
+
+		SECURE_ERASE_OBJ(pSk);
+
+		if (c_KeyKeeper_Status_Ok != errCode)
+			return errCode;
+
+		pCid_unaligned += nBatch;
+		nCount -= nBatch;
+	}
+
+#else // BeamCrypto_Sha256Accel
+
 	for (uint32_t i = 0; i < nCount; i++)
 	{
 		CoinID cid;
@@ -2654,7 +4381,8 @@ static uint16_t TxAggr_AddCoins(KeyKeeper* p, CoinID* pCid_unaligned, uint32_t n
 			return MakeStatus(c_KeyKeeper_Status_Unspecified, 1);
 
 		secp256k1_scalar sk;
-		CoinID_getSkComm(&p->m_MasterKey, &cid, &sk, 0);
+		CoinID_getSkNonSwitchChild(KeyKeeper_getChildKdf(p, CoinID_getSubkey(&cid)), &cid, &sk);
+		CoinID_getSkComm_FromNonSwitch(&cid, &sk, 0, KeyKeeper_getAGen(p, cid.m_AssetID));
 
 		if (!isOut)
 			secp256k1_scalar_negate(&sk, &sk);
@@ -2663,6 +4391,8 @@ static uint16_t TxAggr_AddCoins(KeyKeeper* p, CoinID* pCid_unaligned, uint32_t n
 		SECURE_ERASE_OBJ(sk);
 	}
 
+#endif // BeamCrypto_Sha256Accel
+
 	return c_KeyKeeper_Status_Ok;
 }
 
@@ -2771,39 +4501,173 @@ static void TxAggr_ToOffset(const KeyKeeper* p, const secp256k1_scalar* pKrn, Tx
 	TxAggr_ToOffsetEx(p, pKrn, &pTx->m_TxSig.m_kOffset);
 }
 
-PROTO_METHOD(TxAddCoins)
+static void TxAggr_Begin(KeyKeeper* p, uint8_t bReset)
 {
-	PROTO_UNUSED_ARGS;
-
-	if ((pIn->m_Reset) || (c_KeyKeeper_State_TxBalance != p->m_State))
+	if (bReset || (c_KeyKeeper_State_TxBalance != p->m_State))
 	{
 		ZERO_OBJ(p->u);
 		p->m_State = c_KeyKeeper_State_TxBalance;
 	}
+}
+
+// Record sizes of ins, outs, shielded ins, in this order
+static const uint32_t g_pTxAggr_RecordSize[] = {
+	sizeof(CoinID),
+	sizeof(CoinID),
+	sizeof(ShieldedInput_Blob) + sizeof(ShieldedInput_Fmt)
+};
+
+// Folds the leading complete records within nSize bytes. pCount are the remaining counts, updated
+__stack_hungry__
+static uint16_t TxAggr_AddRecords(KeyKeeper* p, uint8_t* pRec_unaligned, uint32_t nSize, uint32_t* pCount, uint32_t* pConsumed)
+{
+	*pConsumed = 0;
+
+	for (uint32_t iKind = 0; iKind < _countof(g_pTxAggr_RecordSize); iKind++)
+	{
+		uint32_t n = nSize / g_pTxAggr_RecordSize[iKind];
+		if (n > pCount[iKind])
+			n = pCount[iKind];
+
+		if (n)
+		{
+			uint16_t errCode = (iKind < 2) ?
+				TxAggr_AddCoins(p, (CoinID*) pRec_unaligned, n, iKind) :
+				TxAggr_AddShieldedInputs(p, pRec_unaligned, n);
+
+			if (c_KeyKeeper_Status_Ok != errCode)
+				return errCode;
+
+			pCount[iKind] -= n;
+
+			n *= g_pTxAggr_RecordSize[iKind];
+			pRec_unaligned += n;
+			nSize -= n;
+			*pConsumed += n;
+		}
+
+		if (pCount[iKind])
+			break; // the next record is incomplete
+	}
+
+	return c_KeyKeeper_Status_Ok;
+}
 
-	uint32_t nSize =
-		(sizeof(CoinID) * pIn->m_Ins) +
-		(sizeof(CoinID) * pIn->m_Outs) +
-		((sizeof(ShieldedInput_Blob) + sizeof(ShieldedInput_Fmt)) * pIn->m_InsShielded);
+static uint16_t TxAggr_AddAll(KeyKeeper* p, uint8_t* pRec_unaligned, uint32_t nIn, uint32_t* pCount)
+{
+	uint64_t nSize = 0; // may overflow 32 bits with the Ex counts
+	for (uint32_t iKind = 0; iKind < _countof(g_pTxAggr_RecordSize); iKind++)
+		nSize += (uint64_t) g_pTxAggr_RecordSize[iKind] * pCount[iKind];
 
 	if (nIn != nSize)
 		return c_KeyKeeper_Status_ProtoError;
 
-	CoinID* pCid_unaligned = (CoinID*)(pIn + 1);
+	uint32_t nConsumed;
+	return TxAggr_AddRecords(p, pRec_unaligned, nIn, pCount, &nConsumed);
+}
 
-	uint16_t errCode = TxAggr_AddCoins(p, pCid_unaligned, pIn->m_Ins, 0);
-	if (c_KeyKeeper_Status_Ok != errCode)
-		return errCode;
+PROTO_METHOD(TxAddCoins)
+{
+	PROTO_UNUSED_ARGS;
+
+	TxAggr_Begin(p, pIn->m_Reset);
+
+	uint32_t pCount[] = { pIn->m_Ins, pIn->m_Outs, pIn->m_InsShielded };
+	return TxAggr_AddAll(p, (uint8_t*) (pIn + 1), nIn, pCount);
+}
+
+PROTO_METHOD(TxAddCoinsEx)
+{
+	PROTO_UNUSED_ARGS;
+
+	TxAggr_Begin(p, pIn->m_Reset);
 
-	pCid_unaligned += pIn->m_Ins;
+	uint32_t pCount[3];
+	N2H_uint(pCount[0], pIn->m_Ins, 32);
+	N2H_uint(pCount[1], pIn->m_Outs, 32);
+	N2H_uint(pCount[2], pIn->m_InsShielded, 32);
 
-	errCode = TxAggr_AddCoins(p, pCid_unaligned, pIn->m_Outs, 1);
+	return TxAggr_AddAll(p, (uint8_t*) (pIn + 1), nIn, pCount);
+}
+
+int KeyKeeper_IsStreamed(const uint8_t* pIn, uint32_t nIn)
+{
+	// the header must be complete
+	return
+		((nIn >= sizeof(OpIn_TxAddCoins)) && (c_Proto_Code_TxAddCoins == *pIn)) ||
+		((nIn >= sizeof(OpIn_TxAddCoinsEx)) && (c_Proto_Code_TxAddCoinsEx == *pIn));
+}
+
+void KeyKeeper_AbortPart(KeyKeeper* p, const uint8_t* pIn, uint32_t nIn)
+{
+	if (KeyKeeper_IsStreamed(pIn, nIn) && (c_KeyKeeper_State_TxBalance == p->m_State))
+	{
+		SECURE_ERASE_OBJ(p->u.m_TxBalance);
+		p->m_State = 0;
+	}
+}
+
+__stack_hungry__
+uint16_t KeyKeeper_InvokePart(KeyKeeper* p, uint8_t* pIn, uint32_t* pnIn)
+{
+	uint32_t nIn = *pnIn;
+	uint32_t nHdr;
+	uint32_t pCount[3];
+
+	if (!KeyKeeper_IsStreamed(pIn, nIn))
+		return c_KeyKeeper_Status_Ok; // not streamed, or the header is incomplete
+
+	if (c_Proto_Code_TxAddCoins == *pIn)
+	{
+		OpIn_TxAddCoins* pOp = (OpIn_TxAddCoins*) pIn;
+		nHdr = sizeof(*pOp);
+
+		TxAggr_Begin(p, pOp->m_Reset);
+		pOp->m_Reset = 0; // applied
+
+		pCount[0] = pOp->m_Ins;
+		pCount[1] = pOp->m_Outs;
+		pCount[2] = pOp->m_InsShielded;
+	}
+	else
+	{
+		OpIn_TxAddCoinsEx* pOp = (OpIn_TxAddCoinsEx*) pIn;
+		nHdr = sizeof(*pOp);
+
+		TxAggr_Begin(p, pOp->m_Reset);
+		pOp->m_Reset = 0;
+
+		N2H_uint(pCount[0], pOp->m_Ins, 32);
+		N2H_uint(pCount[1], pOp->m_Outs, 32);
+		N2H_uint(pCount[2], pOp->m_InsShielded, 32);
+	}
+
+	uint32_t nConsumed;
+	uint16_t errCode = TxAggr_AddRecords(p, pIn + nHdr, nIn - nHdr, pCount, &nConsumed);
 	if (c_KeyKeeper_Status_Ok != errCode)
 		return errCode;
 
-	pCid_unaligned += pIn->m_Outs;
+	// what remains
+	if (c_Proto_Code_TxAddCoins == *pIn)
+	{
+		OpIn_TxAddCoins* pOp = (OpIn_TxAddCoins*) pIn;
+		pOp->m_Ins = (uint8_t) pCount[0];
+		pOp->m_Outs = (uint8_t) pCount[1];
+		pOp->m_InsShielded = (uint8_t) pCount[2];
+	}
+	else
+	{
+		OpIn_TxAddCoinsEx* pOp = (OpIn_TxAddCoinsEx*) pIn;
+		H2N_uint(pOp->m_Ins, pCount[0], 32);
+		H2N_uint(pOp->m_Outs, pCount[1], 32);
+		H2N_uint(pOp->m_InsShielded, pCount[2], 32);
+	}
+
+	nIn -= nConsumed;
+	memmove(pIn + nHdr, pIn + nHdr + nConsumed, nIn - nHdr);
+	*pnIn = nIn;
 
-	return TxAggr_AddShieldedInputs(p, (uint8_t*) pCid_unaligned, pIn->m_InsShielded);
+	return c_KeyKeeper_Status_Ok;
 }
 
 //////////////////////////////
@@ -2900,9 +4764,9 @@ PROTO_METHOD(TxSplit)
 	secp256k1_sha256_finalize(&sha, hv.m_pVal);
 
 	// derive keys
-	static const char szSalt[] = "hw-wlt-split";
+	static const HMacSalt salt = HMacSalt_hw_wlt_split;
 	NonceGenerator ng;
-	NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), &hv);
+	NonceGenerator_Init(&ng, &salt, &hv);
 
 	KernelKeys keys;
 	NonceGenerator_NextScalar(&ng, &keys.m_kKrn);
@@ -3015,9 +4879,9 @@ PROTO_METHOD(TxReceive)
 	secp256k1_sha256_finalize(&sha, hv.m_pVal);
 
 	// derive keys
-	static const char szSalt[] = "hw-wlt-rcv";
+	static const HMacSalt salt = HMacSalt_hw_wlt_rcv;
 	NonceGenerator ng;
-	NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), &hv);
+	NonceGenerator_Init(&ng, &salt, &hv);
 
 	KernelKeys keys;
 	NonceGenerator_NextScalar(&ng, &keys.m_kKrn);
@@ -3205,9 +5069,9 @@ static void TxSend_DeriveKeys(KeyKeeper* p, const OpIn_TxSend2* pIn, TxSendConte
 	secp256k1_sha256_write_UintBig(&sha, &pCtx->m_hvToken);
 	secp256k1_sha256_finalize(&sha, pCtx->m_hvToken.m_pVal);
 
-	static const char szSalt[] = "hw-wlt-snd";
+	static const HMacSalt salt = HMacSalt_hw_wlt_snd;
 	NonceGenerator ng;
-	NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), &pCtx->m_hvToken);
+	NonceGenerator_Init(&ng, &salt, &pCtx->m_hvToken);
 	NonceGenerator_NextScalar(&ng, &pCtx->m_Keys.m_kKrn);
 	SECURE_ERASE_OBJ(ng);
 
@@ -3322,13 +5186,6 @@ static void ShieldedHashTxt(secp256k1_sha256_t* pSha)
 	HASH_WRITE_STR(*pSha, "Output.Shielded.");
 }
 
-typedef struct
-{
-	Kdf m_Gen;
-	Kdf m_Ser;
-
-} ShieldedViewer;
-
 #ifdef BeamCrypto_ScarceStack
 #	define c_MultiMac_nBits_Offline 2
 #else
@@ -3384,7 +5241,7 @@ void ShieldedVoucherContext_FromViewer(ShieldedVoucherContext* pCtx, const Shiel
 }
 
 __stack_hungry__
-static void ShieldedViewerInit(ShieldedViewer* pRes, uint32_t iViewer, const KeyKeeper* p)
+void ShieldedViewerInit(ShieldedViewer* pRes, uint32_t iViewer, const KeyKeeper* p)
 {
 	// Shielded viewer
 	UintBig hv;
@@ -3416,6 +5273,46 @@ static void ShieldedViewerInit(ShieldedViewer* pRes, uint32_t iViewer, const Key
 	wrap_scalar_mul(&pRes->m_Ser.m_kCoFactor, &pRes->m_Ser.m_kCoFactor, &sk);
 }
 
+#if c_KeyKeeper_nViewer
+static KeyKeeper_Viewer* KeyKeeper_getViewer(KeyKeeper* p, uint32_t iViewer)
+{
+	// LRU, same as the child Kdf cache. The returned entry is valid until the next cache access
+	KeyKeeper_Viewer* pVictim = p->m_pViewer;
+
+	for (uint32_t i = 0; i < c_KeyKeeper_nViewer; i++)
+	{
+		KeyKeeper_Viewer* pE = p->m_pViewer + i;
+		if (pE->m_Stamp && (pE->m_iViewer == iViewer))
+		{
+			pE->m_Stamp = ++p->m_CacheStamp;
+			return pE;
+		}
+
+		if (pE->m_Stamp < pVictim->m_Stamp)
+			pVictim = pE;
+	}
+
+	ShieldedViewerInit(&pVictim->m_Viewer, iViewer, p); // overwrites the evicted one
+	pVictim->m_iViewer = iViewer;
+	pVictim->m_AddrValid = 0;
+	pVictim->m_Stamp = ++p->m_CacheStamp;
+
+	return pVictim;
+}
+#endif // c_KeyKeeper_nViewer
+
+static const ShieldedViewer* ShieldedViewer_Get(KeyKeeper* p, uint32_t iViewer, ShieldedViewer* pBuf)
+{
+	// either cached, or derived into pBuf
+#if c_KeyKeeper_nViewer
+	UNUSED(pBuf);
+	return &KeyKeeper_getViewer(p, iViewer)->m_Viewer;
+#else // c_KeyKeeper_nViewer
+	ShieldedViewerInit(pBuf, iViewer, p);
+	return pBuf;
+#endif // c_KeyKeeper_nViewer
+}
+
 static void MulGJ(gej_t* pGej, const secp256k1_scalar* pK)
 {
 #ifdef BeamCrypto_ExternalGej
@@ -3430,14 +5327,7 @@ static void MulGJ(gej_t* pGej, const secp256k1_scalar* pK)
 	Gej_Destroy(&gej);
 
 #else // BeamCrypto_ExternalGej
-	MultiMac_Context ctx;
-	ctx.m_pRes = pGej;
-	ctx.m_Fast.m_Count = 0;
-	ctx.m_Secure.m_Count = 2;
-	ctx.m_Secure.m_pGen = Context_get()->m_pGenGJ;
-	ctx.m_Secure.m_pK = pK;
-
-	MultiMac_Calculate(&ctx);
+	MultiMac_Comb_Calculate(pGej, Context_get()->m_pCombGJ, pK, 2);
 #endif // BeamCrypto_ExternalGej
 }
 
@@ -3656,10 +5546,9 @@ PROTO_METHOD(CreateShieldedVouchers)
 		return MakeStatus(c_KeyKeeper_Status_ProtoError, 2);
 
 	ShieldedViewer viewer;
-	ShieldedViewerInit(&viewer, 0, p);
 
 	ShieldedVoucherContext vCtx;
-	ShieldedVoucherContext_FromViewer(&vCtx, &viewer);
+	ShieldedVoucherContext_FromViewer(&vCtx, ShieldedViewer_Get(p, 0, &viewer));
 
 	// key to sign the voucher(s)
 	UintBig hv, hvNonce;
@@ -3695,22 +5584,20 @@ PROTO_METHOD(CreateShieldedVouchers)
 
 //////////////////////////////
 // KeyKeeper - SignOfflineAddr
-void OfflineAddr_Init(OfflineAddr* pRes, const KeyKeeper* p, uint32_t iAddr)
+__stack_hungry__
+void OfflineAddr_FromViewer(OfflineAddr* pRes, const ShieldedViewer* pViewer)
 {
-	ShieldedViewer viewer;
-	ShieldedViewerInit(&viewer, iAddr, p);
-
-	pRes->m_Gen_Secret = viewer.m_Gen.m_Secret;
-	pRes->m_Ser_Secret = viewer.m_Ser.m_Secret;
+	pRes->m_Gen_Secret = pViewer->m_Gen.m_Secret;
+	pRes->m_Ser_Secret = pViewer->m_Ser.m_Secret;
 
 	gej_t pGej[3];
 	Gej_Init(pGej);
 	Gej_Init(pGej + 1);
 	Gej_Init(pGej + 2);
 
-	MulG(pGej, &viewer.m_Gen.m_kCoFactor);
-	MulJ(pGej + 1, &viewer.m_Gen.m_kCoFactor);
-	MulG(pGej + 2, &viewer.m_Ser.m_kCoFactor);
+	MulG(pGej, &pViewer->m_Gen.m_kCoFactor);
+	MulJ(pGej + 1, &pViewer->m_Gen.m_kCoFactor);
+	MulG(pGej + 2, &pViewer->m_Ser.m_kCoFactor);
 
 #ifdef BeamCrypto_ExternalGej
 	Point_Compact_from_Gej(&pRes->m_Gen_PkG, pGej);
@@ -3731,6 +5618,25 @@ void OfflineAddr_Init(OfflineAddr* pRes, const KeyKeeper* p, uint32_t iAddr)
 	Gej_Destroy(pGej);
 }
 
+void OfflineAddr_Init(OfflineAddr* pRes, KeyKeeper* p, uint32_t iAddr)
+{
+#if c_KeyKeeper_nViewer
+	KeyKeeper_Viewer* pE = KeyKeeper_getViewer(p, iAddr);
+	if (!pE->m_AddrValid)
+	{
+		OfflineAddr_FromViewer(&pE->m_Addr, &pE->m_Viewer);
+		pE->m_AddrValid = 1;
+	}
+
+	*pRes = pE->m_Addr;
+#else // c_KeyKeeper_nViewer
+	ShieldedViewer viewer;
+	ShieldedViewerInit(&viewer, iAddr, p);
+	OfflineAddr_FromViewer(pRes, &viewer);
+	SECURE_ERASE_OBJ(viewer);
+#endif // c_KeyKeeper_nViewer
+}
+
 __stack_hungry__
 void OfflineAddr_getHash(UintBig* pRes, const OfflineAddr* pAddr)
 {
@@ -3760,9 +5666,6 @@ PROTO_METHOD(SignOfflineAddr)
 	secp256k1_scalar sk;
 	DeriveAddress(p, addrID, &sk, &hv);
 
-	ShieldedViewer viewer;
-	ShieldedViewerInit(&viewer, 0, p);
-
 	OfflineAddr addr;
 	OfflineAddr_Init(&addr, p, 0);
 
@@ -3827,36 +5730,41 @@ PROTO_METHOD(CreateShieldedInput_1)
 		return MakeStatus(c_KeyKeeper_Status_Unspecified, 21);
 
 	ShieldedViewer viewer;
-	ShieldedViewerInit(&viewer, fmt.m_nViewerIdx, p);
 
 	ShieldedVoucherContext vCtx;
-	ShieldedVoucherContext_FromViewer(&vCtx, &viewer);
+	ShieldedVoucherContext_FromViewer(&vCtx, ShieldedViewer_Get(p, fmt.m_nViewerIdx, &viewer));
 
 	ShieldedGetSpendKey(&vCtx, &p->u.m_Ins.m_skSpend, pIn->m_InpBlob.m_IsCreatedByViewer, &hv, &p->u.m_Ins.m_skSpend);
 
-	// output commitment
-	CustomGenerator aGen;
+	gej_t pGej[2]; // output commitment, spend pk. Exposed together
+	Gej_Init(pGej);
+	Gej_Init(pGej + 1);
+
+	{
+		CustomGenerator aGen;
 #ifdef BeamCrypto_ExternalGej
-	Gej_Init(&aGen);
+		Gej_Init(&aGen);
 #endif // BeamCrypto_ExternalGej
 
-	if (fmt.m_AssetID)
-		CoinID_GenerateAGen(fmt.m_AssetID, &aGen);
-
-	gej_t gej;
-	Gej_Init(&gej);
+		const CustomGenerator* pAGen = KeyKeeper_getAGen(p, fmt.m_AssetID);
+		if (fmt.m_AssetID && !pAGen)
+		{
+			CoinID_GenerateAGen(fmt.m_AssetID, &aGen);
+			pAGen = &aGen;
+		}
 
-	CoinID_getCommRaw(&p->u.m_Ins.m_skOutp, fmt.m_Amount, fmt.m_AssetID ? &aGen : 0, &gej);
-	secp256k1_sha256_write_Gej(&pOracle->m_sha, &gej);
+		CoinID_getCommRaw(&p->u.m_Ins.m_skOutp, fmt.m_Amount, pAGen, pGej);
 
 #ifdef BeamCrypto_ExternalGej
-	Gej_Destroy(&aGen);
+		Gej_Destroy(&aGen);
 #endif // BeamCrypto_ExternalGej
+	}
 
-	// Spend pk
-	MulG(&gej, &p->u.m_Ins.m_skSpend);
-	secp256k1_sha256_write_Gej(&pOracle->m_sha, &gej);
-	Gej_Destroy(&gej);
+	MulG(pGej + 1, &p->u.m_Ins.m_skSpend);
+
+	Oracle_ExposeGej_N(pOracle, pGej, _countof(pGej));
+	Gej_Destroy(pGej + 1);
+	Gej_Destroy(pGej);
 
 	// finalyze
 	p->u.m_Ins.m_Sigma_M = sip.m_Sigma_M;
@@ -3888,10 +5796,10 @@ PROTO_METHOD(CreateShieldedInput_2)
 	{
 		// derive nonce. Sensitive commitments (corresponding to secret keys) were already exposed
 		NonceGenerator ng;
-		static const char szSalt[] = "beam.lelantus.1";
+		static const HMacSalt salt = HMacSalt_beam_lelantus_1;
 
 		secp256k1_hmac_sha256_t hmac;
-		NonceGenerator_InitBegin(&ng, &hmac, szSalt, sizeof(szSalt));
+		NonceGenerator_InitBegin(&ng, &hmac, &salt);
 
 		secp256k1_hmac_sha256_write_UintBig(&hmac, &hvSigGen);
 		secp256k1_hmac_sha256_write_CompactPoint(&hmac, &pIn->m_NoncePub);
@@ -3997,19 +5905,19 @@ PROTO_METHOD(CreateShieldedInput_4)
 	{
 		// hash all the visible to-date params
 		union {
-			secp256k1_sha256_t sha;
+			Oracle o2;
 			NonceGenerator ng;
 		} u;
 
-		u.sha = pOracle->m_sha; // copy
-		secp256k1_sha256_write_CompactPoint(&u.sha, pG_Last);
+		Oracle_Fork(pOracle, &u.o2);
+		secp256k1_sha256_write_CompactPoint(&u.o2.m_sha, pG_Last);
 
 		UintBig hv;
-		secp256k1_sha256_finalize(&u.sha, hv.m_pVal);
+		secp256k1_sha256_finalize(&u.o2.m_sha, hv.m_pVal);
 
 		// derive nonce. Sensitive commitments (corresponding to secret keys) were already exposed
-		static const char szSalt[] = "beam.lelantus.2";
-		NonceGenerator_Init(&u.ng, szSalt, sizeof(szSalt), &hv);
+		static const HMacSalt salt = HMacSalt_beam_lelantus_2;
+		NonceGenerator_Init(&u.ng, &salt, &hv);
 
 		NonceGenerator_NextScalar(&u.ng, &k);
 
@@ -4115,6 +6023,107 @@ PROTO_METHOD(AuxRead)
 	return c_KeyKeeper_Status_Ok;
 }
 
+//////////////////////////////
+// KeyKeeper - BatchInvoke
+// The sub-requests are executed in order, until the first failure (its response is the last one). Nested batches are not allowed.
+// The responses that don't fit the remaining out buffer fail with the usual size error, and the batch stops there
+PROTO_METHOD(BatchInvoke)
+{
+	PROTO_UNUSED_ARGS;
+
+	uint8_t nCount = pIn->m_Count;
+	const uint8_t* pSrc = (const uint8_t*) (pIn + 1);
+	uint8_t* pDst = (uint8_t*) (pOut + 1);
+
+	// validate the envelope before anything is executed
+	const uint8_t* pPos = pSrc;
+	uint32_t nRemaining = nIn;
+
+	for (uint32_t i = 0; i < nCount; i++)
+	{
+		uint16_t nSub;
+		if (nRemaining < sizeof(nSub))
+			return c_KeyKeeper_Status_ProtoError;
+
+		memcpy_unaligned(&nSub, pPos, sizeof(nSub)); // the sub-requests are packed, may be at an odd offset
+		N2H_uint_inplace(nSub, 16);
+		nRemaining -= sizeof(nSub);
+
+		if (nRemaining < nSub)
+			return c_KeyKeeper_Status_ProtoError;
+
+		pPos += sizeof(nSub) + nSub;
+		nRemaining -= nSub;
+	}
+
+	if (nRemaining)
+		return c_KeyKeeper_Status_ProtoError;
+
+	// pIn and pOut may overlap (the APDU buffer), then the responses would overwrite the pending sub-requests.
+	// Move those to the end of the out buffer, the responses must fit before them.
+	uint32_t nReserved = 0;
+	if ((pSrc < pDst + nOut) && (pDst < pSrc + nIn))
+	{
+		if (nIn > nOut)
+			return c_KeyKeeper_Status_ProtoError;
+
+		nReserved = nIn;
+
+		uint8_t* pMoved = pDst + nOut - nIn;
+		memmove(pMoved, pSrc, nIn);
+		pSrc = pMoved;
+	}
+
+	uint8_t nDone = 0;
+	while (nDone < nCount)
+	{
+		uint16_t nSub;
+		memcpy_unaligned(&nSub, pSrc, sizeof(nSub));
+		N2H_uint_inplace(nSub, 16);
+		pSrc += sizeof(nSub);
+
+		uint32_t nSubOut = nOut - nReserved;
+		if (nSubOut < sizeof(uint16_t) * 2)
+			break; // no room even for the error, leave it for the next batch
+		nSubOut -= sizeof(uint16_t);
+
+		uint8_t* pSubOut = pDst + sizeof(uint16_t);
+
+		uint16_t errCode = (nSub && (c_Proto_Code_BatchInvoke == *pSrc)) ?
+			MakeStatus(c_KeyKeeper_Status_ProtoError, 0xfc) :
+			KeyKeeper_Invoke(p, pSrc, nSub, pSubOut, &nSubOut);
+
+		if (c_KeyKeeper_Status_Ok == errCode)
+			pSubOut[0] = c_KeyKeeper_Status_Ok;
+		else
+		{
+			pSubOut[0] = (uint8_t) errCode;
+			pSubOut[1] = (uint8_t) (errCode >> 8);
+			nSubOut = sizeof(errCode);
+		}
+
+		uint16_t nSubOut_n;
+		H2N_uint(nSubOut_n, (uint16_t) nSubOut, 16);
+		memcpy_unaligned(pDst, &nSubOut_n, sizeof(nSubOut_n));
+		nSubOut += sizeof(uint16_t);
+
+		pDst += nSubOut;
+		nOut -= nSubOut;
+		*pOutSize += nSubOut;
+
+		pSrc += nSub;
+		if (nReserved)
+			nReserved -= sizeof(nSub) + nSub;
+		nDone++;
+
+		if (c_KeyKeeper_Status_Ok != errCode)
+			break;
+	}
+
+	pOut->m_Count = nDone;
+	return c_KeyKeeper_Status_Ok;
+}
+
 //////////////////////////////
 // KeyKeeper - SendShieldedTx
 static uint8_t Msg2Scalar(secp256k1_scalar* p, const UintBig* pMsg)
@@ -4286,29 +6295,31 @@ void TxSendShielded_PrepareRangeProofRecover(TxSendShieldedContext* pCtx, TxSend
 	} u;
 
 	{
-		static const char szSalt[] = "kG-O";
-		NonceGenerator_Init(&u.ng, szSalt, sizeof(szSalt), &pCtx->m_pSh->u.m_Voucher.m_SharedSecret);
+		static const HMacSalt salt = HMacSalt_kG_O;
+		NonceGenerator_Init(&u.ng, &salt, &pCtx->m_pSh->u.m_Voucher.m_SharedSecret);
 		NonceGenerator_NextScalar(&u.ng, &pCtx->m_skKrn);
 	}
 
 	pRp->m_FlagsPacked = Msg2Scalar(&u.skExtra, &pCtx->m_pIn->m_User.m_Sender);
 	secp256k1_scalar_add(&pCtx->m_skKrn, &pCtx->m_skKrn, &u.skExtra); // output blinding factor
 
-	CustomGenerator* pAGen = pCtx->m_Txs.m_Aid ? &pRp->u.m_AGen : 0;
-	if (pAGen)
+	const CustomGenerator* pAGen = KeyKeeper_getAGen(pCtx->m_p, pCtx->m_Txs.m_Aid);
+	CustomGenerator* pAGenBuf = (pCtx->m_Txs.m_Aid && !pAGen) ? &pRp->u.m_AGen : 0;
+	if (pAGenBuf)
 	{
 #ifdef BeamCrypto_ExternalGej
-		Gej_Init(pAGen);
+		Gej_Init(pAGenBuf);
 #endif // BeamCrypto_ExternalGej
-		CoinID_GenerateAGen(pCtx->m_Txs.m_Aid, pAGen); // assume that's not the peak stack consumer
+		CoinID_GenerateAGen(pCtx->m_Txs.m_Aid, pAGenBuf); // assume that's not the peak stack consumer
+		pAGen = pAGenBuf;
 	}
 
 	Gej_Init(&u.gej);
 	CoinID_getCommRaw(&pCtx->m_skKrn, pCtx->m_Txs.m_NetAmount, pAGen, &u.gej); // output commitment
 
 #ifdef BeamCrypto_ExternalGej
-	if (pAGen)
-		Gej_Destroy(pAGen);
+	if (pAGenBuf)
+		Gej_Destroy(pAGenBuf);
 #endif // BeamCrypto_ExternalGej
 
 	// We have the commitment, and params that are supposed to be packed in the rangeproof.
@@ -4328,7 +6339,7 @@ void TxSendShielded_PrepareRangeProofRecover(TxSendShieldedContext* pCtx, TxSend
 	Gej_Destroy(&u.gej);
 
 	{
-		u.o2 = oracle;
+		Oracle_Fork(&oracle, &u.o2);
 		HASH_WRITE_STR(u.o2.m_sha, "bp-s");
 		secp256k1_sha256_write_UintBig(&u.o2.m_sha, &pCtx->m_pSh->u.m_Voucher.m_SharedSecret);
 		secp256k1_sha256_finalize(&u.o2.m_sha, pRp->u.m_RCtx.m_Seed.m_pVal); // rangeproof seed. For both gen and blinding factor
@@ -4380,9 +6391,9 @@ uint16_t TxSendShielded_VerifyParams3(TxSendShieldedContext* pCtx, TxSendShielde
 
 	if (pCtx->m_Txs.m_Aid || pCtx->m_pIn->m_HideAssetAlways)
 	{
-		static const char szSalt[] = "skG-O";
+		static const HMacSalt salt = HMacSalt_skG_O;
 		NonceGenerator ng; // not really secret
-		NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), &pCtx->m_pSh->u.m_Voucher.m_SharedSecret);
+		NonceGenerator_Init(&ng, &salt, &pCtx->m_pSh->u.m_Voucher.m_SharedSecret);
 		NonceGenerator_NextScalar(&ng, pRp->u.m_RCtx.m_pExtra);
 
 		secp256k1_scalar_set_u64(pRp->u.m_RCtx.m_pExtra + 1, pCtx->m_Txs.m_NetAmount);
@@ -4438,9 +6449,9 @@ uint16_t TxSendShielded_FinalyzeTx(TxSendShieldedContext* pCtx, int bSplit)
 
 	// derive keys
 	KernelKeys keys;
-	static const char szSalt[] = "hw-wlt-snd-sh";
+	static const HMacSalt salt = HMacSalt_hw_wlt_snd_sh;
 	NonceGenerator ng;
-	NonceGenerator_Init(&ng, szSalt, sizeof(szSalt), &hvOuter);
+	NonceGenerator_Init(&ng, &salt, &hvOuter);
 	NonceGenerator_NextScalar(&ng, &keys.m_kKrn);
 	NonceGenerator_NextScalar(&ng, &keys.m_kNonce);
 	SECURE_ERASE_OBJ(ng);
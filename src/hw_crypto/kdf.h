@@ -28,3 +28,12 @@ void Kdf_Derive_SKey(const Kdf*, const UintBig* pHv, secp256k1_scalar* pK);
 void Kdf_getChild(Kdf*, uint32_t iChild, const Kdf* pParent);
 
 void CoinID_getSkComm(const Kdf*, const CoinID*, secp256k1_scalar*, CompactPoint*);
+void CoinID_getSkCommChild(const Kdf* pKdfC, const CoinID*, secp256k1_scalar*, CompactPoint*); // with the already derived child Kdf of the coin subkey
+
+#ifdef BeamCrypto_Sha256Accel
+// Batched variants, the same results as the single ones. The hashing of the independent derivations is done in lockstep (multi-buffer), up to c_Sha256_Lanes at once
+void KdfRaw_Derive_PKey_N(const UintBig* const* ppSecret, const UintBig* const* ppHv, secp256k1_scalar* const* ppK, unsigned int n);
+void Kdf_Init_N(Kdf* const* ppKdf, const UintBig* const* ppSeed, unsigned int n);
+void Kdf_getChild_N(Kdf* const* ppKdf, const uint32_t* pChild, const Kdf* pParent, unsigned int n);
+void CoinID_getSkChild_N(const Kdf* const* ppKdfC, const CoinID* const* ppCid, secp256k1_scalar* const* ppK, unsigned int n);
+#endif // BeamCrypto_Sha256Accel
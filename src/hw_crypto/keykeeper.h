@@ -17,6 +17,7 @@
 #include "coinid.h"
 #include "sign.h"
 #include "oracle.h"
+#include "multimac.h"
 
 
 typedef struct
@@ -73,8 +74,46 @@ typedef struct
 	// alignment should be ok
 } ShieldedInput_Fmt;
 
+typedef struct
+{
+	CoinID m_Cid;
+	UintBig m_pKExtra[2];
+	CompactPoint m_pT[2];
+	CompactPoint m_ptAssetGen; // the blinded generator of the coin asset, zero if no asset
+
+} CreateOutputs_In;
+
+typedef struct
+{
+	CompactPoint m_pT[2];
+	UintBig m_TauX;
+
+} CreateOutputs_Out;
+
+typedef struct
+{
+	UintBig m_hvSrc;
+	uint32_t m_iChild;
+	uint8_t m_bG;
+	uint8_t m_bJ;
+
+} GetImages_In;
+
+typedef struct
+{
+	CompactPoint m_ptImageG;
+	CompactPoint m_ptImageJ;
+
+} GetImages_Out;
+
 #pragma pack (pop)
 
+// The response must fit a single APDU (260 bytes, less the status word), it's not chained.
+// This caps the bulk requests, their larger counts are rejected (c_KeyKeeper_Status_ProtoError)
+#define c_KeyKeeper_ResponseMax 258
+#define c_KeyKeeper_CreateOutputs_MaxCount ((c_KeyKeeper_ResponseMax - 1) / sizeof(CreateOutputs_Out)) // 2, after the status byte
+#define c_KeyKeeper_GetImages_MaxCount ((c_KeyKeeper_ResponseMax - 1) / sizeof(GetImages_Out)) // 3
+
 typedef struct
 {
 	TxKernelUser m_Krn;
@@ -191,10 +230,107 @@ typedef union
 	ShieldedOutParams m_Sh;
 } KeyKeeper_AuxBuf;
 
+// The caches below are in the KeyKeeper, which is static (g_KeyKeeper), not on the stack. Their sizes are the same on 32-bit targets.
+// Default budget (all of them) is ~2K RAM: child Kdfs 0.3K, viewer 0.3K, KdfPubs 0.3K, asset generators 1.1K.
+// The Nano S (BeamCrypto_ScarceStack) only has the single child Kdf.
+
+// Cached child Kdfs (by the subkey index), so that the repeated subkeys are derived once
+#ifndef c_KeyKeeper_nChildKdf
+#	ifdef BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nChildKdf 1
+#	else // BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nChildKdf 4
+#	endif // BeamCrypto_ScarceStack
+#endif // c_KeyKeeper_nChildKdf
+
+typedef struct
+{
+	Kdf m_Kdf;
+	uint32_t m_iChild;
+	uint32_t m_Stamp; // last use, 0 if empty
+
+} KeyKeeper_ChildKdf;
+
+typedef struct
+{
+	Kdf m_Gen;
+	Kdf m_Ser;
+
+} ShieldedViewer;
+
+// Cached shielded viewers (by the viewer index), each ~0.3K RAM. A wallet normally uses a single one. Not on the Nano S
+#ifndef c_KeyKeeper_nViewer
+#	ifdef BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nViewer 0
+#	else // BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nViewer 1
+#	endif // BeamCrypto_ScarceStack
+#endif // c_KeyKeeper_nViewer
+
+typedef struct
+{
+	ShieldedViewer m_Viewer;
+	OfflineAddr m_Addr; // derived from the viewer on demand
+	uint32_t m_iViewer;
+	uint32_t m_Stamp; // last use, 0 if empty
+	uint8_t m_AddrValid;
+
+} KeyKeeper_Viewer;
+
+// Memoized KdfPubs: the owner one and the recently requested children, each ~0.1K RAM. Not on the Nano S
+#ifndef c_KeyKeeper_nPKdf
+#	ifdef BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nPKdf 0
+#	else // BeamCrypto_ScarceStack
+#		define c_KeyKeeper_nPKdf 2
+#	endif // BeamCrypto_ScarceStack
+#endif // c_KeyKeeper_nPKdf
+
+typedef struct
+{
+	KdfPub m_Pub;
+	uint32_t m_iChild;
+	uint32_t m_Stamp; // last use, 0 if empty
+
+} KeyKeeper_ChildPKdf;
+
+// Cached asset generators (CoinID_GenerateAGen, by the AssetID), each ~0.5K RAM. A transaction has at most 1 asset besides beam, 2 leave room for the next one.
+// Not on the Nano S, nor with BeamCrypto_ExternalGej (a single point there)
+#ifndef c_KeyKeeper_nAGen
+#	if defined(BeamCrypto_ScarceStack) || defined(BeamCrypto_ExternalGej)
+#		define c_KeyKeeper_nAGen 0
+#	else
+#		define c_KeyKeeper_nAGen 2
+#	endif
+#endif // c_KeyKeeper_nAGen
+
+typedef struct
+{
+	CustomGenerator m_Gen;
+	AssetID m_Aid;
+	uint32_t m_Stamp; // last use, 0 if empty
+
+} KeyKeeper_AGen;
+
 typedef struct
 {
 	Kdf m_MasterKey;
 
+	// must be zeroed together with the master key change
+	KeyKeeper_ChildKdf m_pChildKdf[c_KeyKeeper_nChildKdf];
+#if c_KeyKeeper_nViewer
+	KeyKeeper_Viewer m_pViewer[c_KeyKeeper_nViewer];
+#endif // c_KeyKeeper_nViewer
+#if c_KeyKeeper_nPKdf
+	KdfPub m_MasterPub; // valid if m_MasterPubValid
+	KeyKeeper_ChildPKdf m_pChildPKdf[c_KeyKeeper_nPKdf];
+	uint8_t m_MasterPubValid;
+#endif // c_KeyKeeper_nPKdf
+#if c_KeyKeeper_nAGen
+	KeyKeeper_AGen m_pAGen[c_KeyKeeper_nAGen];
+#endif // c_KeyKeeper_nAGen
+	uint32_t m_CacheStamp;
+
 	// context information
 	uint8_t m_State;
 
@@ -229,7 +365,18 @@ typedef struct
 #define c_KeyKeeper_State_CreateShielded_1 11
 #define c_KeyKeeper_State_CreateShielded_2 12
 
-void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if pChild is NULL then the master kdfpub (owner key) is returned
+void KeyKeeper_GetPKdf(KeyKeeper*, KdfPub*, const uint32_t* pChild); // if pChild is NULL then the master kdfpub (owner key) is returned
+
+#if c_KeyKeeper_nPKdf
+void KeyKeeper_InitMasterPub(KeyKeeper*); // computes the owner kdfpub in advance, to be called after the master key is set
+#endif // c_KeyKeeper_nPKdf
+
+void OfflineAddr_Init(OfflineAddr*, KeyKeeper*, uint32_t iAddr); // the offline address of the shielded viewer iAddr, cached with it
+
+// The derivations behind the caches, not cached
+void Kdf2Pub(const Kdf*, KdfPub*);
+void ShieldedViewerInit(ShieldedViewer*, uint32_t iViewer, const KeyKeeper*);
+void OfflineAddr_FromViewer(OfflineAddr*, const ShieldedViewer*);
 
 
 //////////////////
@@ -263,6 +410,13 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 	macro(CompactPoint, pT[2]) \
 	macro(UintBig, TauX) \
 
+#define BeamCrypto_ProtoRequest_CreateOutputs(macro) \
+	macro(uint8_t, Count) \
+	/* followed by Count CreateOutputs_In, up to c_KeyKeeper_CreateOutputs_MaxCount */
+
+#define BeamCrypto_ProtoResponse_CreateOutputs(macro) \
+	/* followed by Count CreateOutputs_Out */
+
 #define BeamCrypto_ProtoRequest_TxAddCoins(macro) \
 	macro(uint8_t, Reset) \
 	macro(uint8_t, Ins) \
@@ -273,6 +427,15 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 
 #define BeamCrypto_ProtoResponse_TxAddCoins(macro)
 
+#define BeamCrypto_ProtoRequest_TxAddCoinsEx(macro) \
+	macro(uint8_t, Reset) \
+	macro(uint32_t, Ins) \
+	macro(uint32_t, Outs) \
+	macro(uint32_t, InsShielded) \
+	/* followed by in/outs, same as TxAddCoins without the count limits */
+
+#define BeamCrypto_ProtoResponse_TxAddCoinsEx(macro)
+
 #define BeamCrypto_ProtoRequest_GetImage(macro) \
 	macro(UintBig, hvSrc) \
 	macro(uint32_t, iChild) \
@@ -283,6 +446,13 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 	macro(CompactPoint, ptImageG) \
 	macro(CompactPoint, ptImageJ) \
 
+#define BeamCrypto_ProtoRequest_GetImages(macro) \
+	macro(uint8_t, Count) \
+	/* followed by Count GetImages_In, up to c_KeyKeeper_GetImages_MaxCount */
+
+#define BeamCrypto_ProtoResponse_GetImages(macro) \
+	/* followed by Count GetImages_Out */
+
 #define BeamCrypto_ProtoRequest_DisplayEndpoint(macro) \
 	macro(AddrID, AddrID) \
 
@@ -379,6 +549,14 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 #define BeamCrypto_ProtoResponse_AuxRead(macro) \
 	/* followed by blob */
 
+#define BeamCrypto_ProtoRequest_BatchInvoke(macro) \
+	macro(uint8_t, Count) \
+	/* followed by Count sub-requests, each prefixed by its uint16_t size */
+
+#define BeamCrypto_ProtoResponse_BatchInvoke(macro) \
+	macro(uint8_t, Count) \
+	/* followed by Count responses, each prefixed by its uint16_t size. Those are status-prefixed, the status is 2 bytes on error */
+
 #define BeamCrypto_ProtoRequest_TxSendShielded(macro) \
 	macro(TxCommonIn, Tx) \
 	macro(TxMutualIn, Mut) \
@@ -396,8 +574,12 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 	macro(0x03, GetPKdf) \
 	macro(0x04, GetImage) \
 	macro(0x05, DisplayEndpoint) \
+	macro(0x06, BatchInvoke) \
+	macro(0x07, GetImages) \
 	macro(0x10, CreateOutput) \
+	macro(0x11, CreateOutputs) \
 	macro(0x18, TxAddCoins) \
+	macro(0x19, TxAddCoinsEx) \
 	macro(0x1a, CreateShieldedInput_1) \
 	macro(0x1b, CreateShieldedInput_2) \
 	macro(0x1c, CreateShieldedInput_3) \
@@ -417,6 +599,16 @@ void KeyKeeper_GetPKdf(const KeyKeeper*, KdfPub*, const uint32_t* pChild); // if
 //
 uint16_t KeyKeeper_Invoke(KeyKeeper*, const uint8_t* pIn, uint32_t nIn, uint8_t* pOut, uint32_t* pOutSize);
 
+// The leading part of the request that is still arriving. The streamed methods (TxAddCoins, TxAddCoinsEx) fold their complete records immediately,
+// and the request is updated in-place to what remains (the header with the remaining counts, followed by the incomplete tail), to be continued with more data.
+// The others need the whole request, they're left as-is.
+// The request is completed (with all the remaining data) by KeyKeeper_Invoke
+uint16_t KeyKeeper_InvokePart(KeyKeeper*, uint8_t* pIn, uint32_t* pnIn);
+int KeyKeeper_IsStreamed(const uint8_t* pIn, uint32_t nIn); // nonzero if the leading part of the request is of a streamed method, with the complete header
+
+// The streamed request won't be completed (its chain is dropped). The tx balance it was folded into is discarded, the tx must be started anew
+void KeyKeeper_AbortPart(KeyKeeper*, const uint8_t* pIn, uint32_t nIn);
+
 //////////////////////////
 // External functions, implemented by the platform-specific code
 void SecureEraseMem(void*, uint32_t);
@@ -15,14 +15,22 @@
 #pragma once
 #include "ecc_decl.h"
 
-#ifdef BeamCrypto_ScarceStack
-#	define c_MultiMac_nBits_Rangeproof 3
-#else // BeamCrypto_ScarceStack
-#	define c_MultiMac_nBits_Rangeproof 4
-#endif // BeamCrypto_ScarceStack
-
-#define c_MultiMac_nBits_H 4
-#define c_MultiMac_nBits_Secure 4
+// The window widths of the Context tables can be overridden, g_ContextBuf must then be regenerated (beamhw_gencontext)
+#ifndef c_MultiMac_nBits_Rangeproof
+#	ifdef BeamCrypto_ScarceStack
+#		define c_MultiMac_nBits_Rangeproof 3
+#	else // BeamCrypto_ScarceStack
+#		define c_MultiMac_nBits_Rangeproof 4
+#	endif // BeamCrypto_ScarceStack
+#endif // c_MultiMac_nBits_Rangeproof
+
+#ifndef c_MultiMac_nBits_H
+#	define c_MultiMac_nBits_H 4
+#endif // c_MultiMac_nBits_H
+
+#ifndef c_MultiMac_nBits_Secure
+#	define c_MultiMac_nBits_Secure 4
+#endif // c_MultiMac_nBits_Secure
 #define c_MultiMac_Secure_nCount (1 << c_MultiMac_nBits_Secure)
 
 #ifdef BeamCrypto_ScarceStack
@@ -33,14 +41,51 @@
 
 #define c_MultiMac_OddCount(numBits) (1 << ((numBits) - 1))
 
+#if defined(BeamCrypto_FastVerify) && !defined(BeamCrypto_ExternalGej)
+// Odd multiples of G for the variable-time signature verification, the largest window the wNAF cursor can encode
+#	define c_MultiMac_nBits_Verify 6
+#endif // BeamCrypto_FastVerify
+
+#ifdef BeamCrypto_LargeTables
+// Large 'fast' batches are calculated by the bucket (Pippenger) method, using only the 1st element of each generator table.
+// Below this count wNAF over the precomputed odd multiples needs less additions.
+// Host only: the device never has such batches, and the buckets take ~16K of stack.
+#	ifndef c_MultiMac_Buckets_MinCount
+#		define c_MultiMac_Buckets_MinCount 768
+#	endif // c_MultiMac_Buckets_MinCount
+#	define c_MultiMac_Buckets_nBitsMax 8
+#endif // BeamCrypto_LargeTables
+
+#ifndef BeamCrypto_ScarceStack
+// Up to this count the 'fast' scalars are split by the GLV endomorphism (k = k1 + k2*lambda, ~128 bits each), if there are no 'secure' ones.
+// This halves the doubling chain.
+#	ifndef c_MultiMac_Glv_MaxCount
+#		define c_MultiMac_Glv_MaxCount 2
+#	endif // c_MultiMac_Glv_MaxCount
+#endif // BeamCrypto_ScarceStack
+
 
 typedef struct {
 	secp256k1_ge_storage m_pPt[c_MultiMac_Secure_nCount + 1]; // the last is the compensation term
 } MultiMac_Secure;
 
+// Prepared custom generator (such as of an asset) for the 'fast' multiplication
+#ifdef BeamCrypto_ExternalGej
+typedef gej_t CustomGenerator;
+#else // BeamCrypto_ExternalGej
+typedef struct
+{
+	secp256k1_ge_storage m_pPt[c_MultiMac_OddCount(c_MultiMac_nBits_Custom)]; // odd powers
+	secp256k1_fe m_zDenom;
+} CustomGenerator;
+#endif // BeamCrypto_ExternalGej
+
 typedef struct {
 	uint8_t m_iBit;
 	uint8_t m_iElement;
+#ifndef BeamCrypto_ScarceStack
+	uint16_t m_iNext; // next cursor scheduled at the same bit
+#endif // BeamCrypto_ScarceStack
 } MultiMac_WNaf;
 
 typedef struct
@@ -66,12 +111,56 @@ typedef struct
 
 	} m_Secure;
 
+#ifdef c_MultiMac_Glv_MaxCount
+	struct
+	{
+		// internal, set by MultiMac_Calculate
+		unsigned int m_nHalf; // 'fast' elements from this index on are the lambda-halves
+		unsigned int m_NegMsk; // 'fast' elements with the negated scalar
+
+	} m_Glv;
+#endif // c_MultiMac_Glv_MaxCount
+
 } MultiMac_Context;
 
 void MultiMac_Calculate(MultiMac_Context*);
 
 #define c_MultiMac_Fast_nGenerators (sizeof(uint64_t) * 8 * 2)
 
+// Constant-time comb (Lim-Lee) for the fixed G and J. Each block covers nTeeth bits spaced by nSpacing,
+// i.e. nBlocks * nSpacing table additions and (nSpacing - 1) doublings per multiplication.
+// Can be overridden (both), g_ContextBuf must then be regenerated (beamhw_gencontext --comb <teeth> <spacing>)
+#ifndef c_MultiMac_Comb_nTeeth
+#	ifdef BeamCrypto_LargeTables
+#		define c_MultiMac_Comb_nTeeth 5
+#		define c_MultiMac_Comb_nSpacing 4
+#	else // BeamCrypto_LargeTables
+#		define c_MultiMac_Comb_nTeeth 4
+#		define c_MultiMac_Comb_nSpacing 16
+#	endif // BeamCrypto_LargeTables
+#endif // c_MultiMac_Comb_nTeeth
+
+#ifndef c_MultiMac_Comb_nSpacing
+#	error c_MultiMac_Comb_nTeeth and c_MultiMac_Comb_nSpacing must be overridden together
+#endif // c_MultiMac_Comb_nSpacing
+
+#define c_MultiMac_Comb_nBlocks ((c_ECC_nBits + c_MultiMac_Comb_nTeeth * c_MultiMac_Comb_nSpacing - 1) / (c_MultiMac_Comb_nTeeth * c_MultiMac_Comb_nSpacing))
+#define c_MultiMac_Comb_nEntries (1 << c_MultiMac_Comb_nTeeth)
+
+typedef struct {
+	// m_pPt[iBlock][i] = Sum(bit(i, iTooth) * 2^((iBlock * nTeeth + iTooth) * nSpacing)) * P + Nums, i.e. the same offset as in MultiMac_Secure
+	secp256k1_ge_storage m_pPt[c_MultiMac_Comb_nBlocks][c_MultiMac_Comb_nEntries];
+	secp256k1_ge_storage m_Compensation; // -(nBlocks * (2^nSpacing - 1)) * Nums
+} MultiMac_Comb;
+
+void MultiMac_Comb_Calculate(secp256k1_gej*, const MultiMac_Comb*, const secp256k1_scalar* pK, unsigned int nCount); // constant-time, nCount consecutive tables
+
+#if defined(BeamCrypto_LargeTables) && !defined(BeamCrypto_ExternalGej)
+// Per-byte sums of the rangeproof generators for the amount bits, Sum(bit ? G_i : -H_i).
+// The amount part of the rangeproof A is then nBytes table additions instead of nBits.
+#	define c_MultiMac_Rangeproof_nBytes sizeof(uint64_t)
+#endif // BeamCrypto_LargeTables
+
 typedef struct
 {
 #ifdef BeamCrypto_ExternalGej
@@ -82,6 +171,13 @@ typedef struct
 	secp256k1_ge_storage m_pGenRangeproof[c_MultiMac_Fast_nGenerators][c_MultiMac_OddCount(c_MultiMac_nBits_Rangeproof)];
 	secp256k1_ge_storage m_pGenH[c_MultiMac_OddCount(c_MultiMac_nBits_H)];
 	MultiMac_Secure m_pGenGJ[2];
+	MultiMac_Comb m_pCombGJ[2];
+#ifdef c_MultiMac_Rangeproof_nBytes
+	secp256k1_ge_storage m_pGenRangeproofBytes[c_MultiMac_Rangeproof_nBytes][0x100];
+#endif // c_MultiMac_Rangeproof_nBytes
+#ifdef c_MultiMac_nBits_Verify
+	secp256k1_ge_storage m_pGenVerifyG[c_MultiMac_OddCount(c_MultiMac_nBits_Verify)];
+#endif // c_MultiMac_nBits_Verify
 #endif // BeamCrypto_ExternalGej
 
 } Context;
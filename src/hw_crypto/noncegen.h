@@ -14,6 +14,16 @@
 
 #pragma once
 #include "ecc_decl.h"
+#include "hmac_salts.h"
+
+typedef struct
+{
+	// HMAC-SHA256 midstates: the states after the ipad and opad blocks.
+	// For the constant salts the values are precomputed in hmac_salts.h
+	uint32_t m_pInner[8];
+	uint32_t m_pOuter[8];
+
+} HMacSalt;
 
 typedef struct
 {
@@ -29,6 +39,11 @@ typedef struct
 
 } NonceGenerator;
 
-void NonceGenerator_Init(NonceGenerator*, const char* szSalt, size_t nSalt, const UintBig* pSeed);
+void NonceGenerator_Init(NonceGenerator*, const HMacSalt*, const UintBig* pSeed);
 void NonceGenerator_NextOkm(NonceGenerator*);
 void NonceGenerator_NextScalar(NonceGenerator*, secp256k1_scalar*);
+void NonceGenerator_NextScalars(NonceGenerator*, secp256k1_scalar*, uint32_t nCount);
+
+// For long scalar streams: the HMAC keyed by m_Prk is prepared once, each scalar then costs 2 compressions less. Same output sequence.
+void NonceGenerator_PrepareHMac(const NonceGenerator*, HMacSalt* pPrk);
+void NonceGenerator_NextScalarEx(NonceGenerator*, const HMacSalt* pPrk, secp256k1_scalar*);
@@ -24,3 +24,8 @@ void Oracle_Expose(Oracle*, const uint8_t*, size_t);
 void Oracle_NextHash(Oracle*, UintBig*);
 void Oracle_NextScalar(Oracle*, secp256k1_scalar*);
 void Oracle_NextPoint(Oracle*, CompactPoint*, secp256k1_ge*);
+void Oracle_Fork(const Oracle*, Oracle*); // snapshot of the transcript, to continue independently
+
+// Normalizes the points in-place with a single inversion (instead of one per point), then exposes them in order
+#define c_Oracle_GejBatchMax 4
+void Oracle_ExposeGej_N(Oracle*, gej_t*, uint32_t n);
@@ -14,11 +14,14 @@
 
 #pragma once
 #include "kdf.h"
+#include "multimac.h"
 
 typedef struct
 {
 	CoinID m_Cid;
 	const Kdf* m_pKdf; // master kdf
+	const Kdf* m_pKdfChild; // optional, the already derived child Kdf of the coin subkey
+	const CustomGenerator* m_pAGen; // optional, the already prepared generator of the coin asset (used with m_pKdfChild)
 	const CompactPoint* m_pAssetGen; // optional if no asset.
 
 	const UintBig* m_pKExtra; // optionally embed 2 scalars that can be recognized (in addition to CoinID)
@@ -1101,6 +1101,7 @@ SECP256K1_INLINE static void secp256k1_fe_sqr_inner(uint32_t *r, const uint32_t
 #endif
 
 static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp256k1_fe * SECP256K1_RESTRICT b) {
+    SECP256K1_OPCOUNT(FeMul);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     VERIFY_CHECK(b->magnitude <= 8);
@@ -1118,6 +1119,7 @@ static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp2
 }
 
 static void secp256k1_fe_sqr(secp256k1_fe *r, const secp256k1_fe *a) {
+    SECP256K1_OPCOUNT(FeSqr);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     secp256k1_fe_verify(a);
@@ -1339,6 +1341,7 @@ static const secp256k1_modinv32_modinfo secp256k1_const_modinfo_fe = {
 };
 
 static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *x) {
+    SECP256K1_OPCOUNT(FeInv);
     secp256k1_fe tmp;
     secp256k1_modinv32_signed30 s;
 
@@ -1352,6 +1355,7 @@ static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *x) {
 }
 
 static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *x) {
+    SECP256K1_OPCOUNT(FeInv);
     secp256k1_fe tmp;
     secp256k1_modinv32_signed30 s;
 
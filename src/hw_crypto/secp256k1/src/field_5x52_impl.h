@@ -445,6 +445,7 @@ SECP256K1_INLINE static void secp256k1_fe_add(secp256k1_fe *r, const secp256k1_f
 }
 
 static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp256k1_fe * SECP256K1_RESTRICT b) {
+    SECP256K1_OPCOUNT(FeMul);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     VERIFY_CHECK(b->magnitude <= 8);
@@ -462,6 +463,7 @@ static void secp256k1_fe_mul(secp256k1_fe *r, const secp256k1_fe *a, const secp2
 }
 
 static void secp256k1_fe_sqr(secp256k1_fe *r, const secp256k1_fe *a) {
+    SECP256K1_OPCOUNT(FeSqr);
 #ifdef VERIFY
     VERIFY_CHECK(a->magnitude <= 8);
     secp256k1_fe_verify(a);
@@ -638,6 +640,7 @@ static const secp256k1_modinv64_modinfo secp256k1_const_modinfo_fe = {
 };
 
 static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *x) {
+    SECP256K1_OPCOUNT(FeInv);
     secp256k1_fe tmp;
     secp256k1_modinv64_signed62 s;
 
@@ -653,6 +656,7 @@ static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *x) {
 }
 
 static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *x) {
+    SECP256K1_OPCOUNT(FeInv);
     secp256k1_fe tmp;
     secp256k1_modinv64_signed62 s;
 
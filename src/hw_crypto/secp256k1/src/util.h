@@ -21,6 +21,11 @@
 #define DEBUG_CONFIG_MSG(x) "DEBUG_CONFIG: " x
 #define DEBUG_CONFIG_DEF(x) DEBUG_CONFIG_MSG(#x "=" STR(x))
 
+/* Optional operation counting hook, may be defined by the includer */
+#ifndef SECP256K1_OPCOUNT
+#define SECP256K1_OPCOUNT(op) ((void) 0)
+#endif
+
 typedef struct {
     void (*fn)(const char *text, void* data);
     const void* data;
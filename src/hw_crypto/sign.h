@@ -25,3 +25,7 @@ typedef struct
 void Signature_Sign(Signature*, const UintBig* pMsg, const secp256k1_scalar* pSk);
 void Signature_SignPartial(Signature*, const UintBig* pMsg, const secp256k1_scalar* pSk, const secp256k1_scalar* pNonce);
 int Signature_IsValid(const Signature*, const UintBig* pMsg, const CompactPoint* pPk);
+
+#ifdef BeamCrypto_FastVerify
+int Signature_IsValid_Secure(const Signature*, const UintBig* pMsg, const CompactPoint* pPk); // the constant-time one, as on the device
+#endif // BeamCrypto_FastVerify
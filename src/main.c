@@ -15,7 +15,9 @@
 #include "BeamApp.h"
 #include "os_io_seproxyhal.h"
 #include "sw.h"
+#include "Apdu.h"
 #include "hw_crypto/byteorder.h"
+#include "hw_crypto/keykeeper.h"
 
 uint8_t G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 ux_state_t G_ux;
@@ -26,6 +28,8 @@ bolos_ux_params_t G_ux_params;
 #   error inconsistent target defs
 #endif
 
+_Static_assert(sizeof(G_io_apdu_buffer) - sizeof(uint16_t) >= c_KeyKeeper_ResponseMax, "the response doesn't fit the APDU");
+
 void WaitDisplayed()
 {
     UX_WAKE_UP()
@@ -66,67 +70,6 @@ void EndModal(uint8_t res)
     g_Modal = res;
 }
 
-uint16_t OnApduRcv(int* pLen)
-{
-    uint32_t lenInp = *pLen;
-    *pLen = 0;
-
-     // Structure with fields of APDU command.
-#pragma pack (push, 1)
-    typedef struct {
-        uint8_t cla;    // Instruction class
-        uint8_t ins;    // Instruction code
-        uint8_t p1;     // Instruction parameter 1
-        uint8_t p2;     // Instruction parameter 2
-        uint8_t lc;     // Length of command data
-        uint8_t data[0];  // Command data, variable length
-    } command_t;
-#pragma pack (pop)
-
-    if (lenInp < sizeof(command_t))
-    {
-        PRINTF("=> /!\\ too short\n");
-        return SW_WRONG_DATA_LENGTH;
-    }
-
-    command_t* const pCmd = (command_t*) G_io_apdu_buffer;
-    lenInp -= sizeof(command_t);
-
-    if (lenInp != pCmd->lc)
-    {
-        PRINTF("=> /!\\ Incorrect apdu LC: %.*H\n", lenInp, G_io_apdu_buffer);
-        return SW_WRONG_DATA_LENGTH;
-    }
-
-    PRINTF("=> CLA=%02X | INS=%02X | P1=%02X | P2=%02X | Lc=%02X | CData=%.*H\n",
-        pCmd->cla,
-        pCmd->ins,
-        pCmd->p1,
-        pCmd->p2,
-        pCmd->lc,
-        pCmd->lc,
-        pCmd->data);
-
-    if (pCmd->cla != 0xE0) // CLA
-        return SW_CLA_NOT_SUPPORTED;
-
-    if ('B' != pCmd->ins)
-        return SW_INS_NOT_SUPPORTED;
-
-    if (pCmd->p1 || pCmd->p2)
-        return SW_WRONG_P1P2;
-
-    uint32_t* pSizeOut = (uint32_t *) pLen;
-    _Static_assert(sizeof(*pLen) == sizeof(*pSizeOut), "");
-
-    *pSizeOut = sizeof(G_io_apdu_buffer) - sizeof(uint16_t);
-
-    OnBeamHostRequest(G_io_apdu_buffer + sizeof(*pCmd), lenInp, G_io_apdu_buffer, pSizeOut);
-
-    return SW_OK;
-}
-
-
 /**
  * Handle APDU command received and send back APDU response using handlers.
  */
@@ -196,7 +139,7 @@ void app_main()
                 PRINTF("=> Incoming command: %.*H\n", ioLen, G_io_apdu_buffer);
 
                 // Dispatch structured APDU command to handler
-                uint16_t sw = OnApduRcv(&ioLen);
+                uint16_t sw = Apdu_OnRcv(G_io_apdu_buffer, sizeof(G_io_apdu_buffer), &ioLen);
                 sw = bswap16_be(sw);
 
                 memcpy(G_io_apdu_buffer + ioLen, &sw, sizeof(sw));